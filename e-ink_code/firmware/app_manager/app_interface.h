@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "wake_scheduler.h"
 
 // Forward declarations
 class WiFiManager;
@@ -10,32 +11,87 @@ class DisplayManager;
 class PowerManager;
 class OTAManager;
 
+/**
+ * State of one refresh cycle, filled in by AppManager as the phases run and
+ * passed to every phase so apps don't re-read the battery or WiFi status.
+ */
+struct AppCycle {
+    int batteryPercent = -1;
+    bool wifiConnected = false;   // valid from fetch() on
+};
+
 class AppInterface {
 public:
     virtual ~AppInterface() {}
     
     // App lifecycle
     virtual bool begin() = 0;
-    virtual void loop() = 0;
     virtual void end() = 0;
+
+    // One refresh, split into phases that AppManager schedules (see app_manager.h):
+    //   acquire()  local inputs (sensors, rotation state); runs while WiFi associates
+    //   fetch()    network reads; only called when cycle.wifiConnected
+    //   render()   draw the panel; runs concurrently with publish()
+    //   publish()  network writes (uploads); must not touch the display, and
+    //              only uses RTC slots registered in an earlier phase
+    //   finish()   advance state and say when to run again; AppManager's
+    //              WakeScheduler merges that with pending radio tasks and sleeps
+    // wantsNetwork() is asked before acquire(): false keeps WiFi off this cycle.
+    virtual bool wantsNetwork() { return false; }
+    virtual void acquire(AppCycle& cycle) {}
+    virtual void fetch(AppCycle& cycle) {}
+    virtual void render(AppCycle& cycle) = 0;
+    virtual void publish(AppCycle& cycle) {}
+    virtual WakeRequest finish(AppCycle& cycle) = 0;
     
     // App identification
     virtual const char* getName() = 0;
     
     // Configuration (optional - apps can override if they need config)
     virtual bool configure(const JsonObject& config) { return true; }
+    // Back to defaults; AppManager calls it before configure() applies a new config,
+    // since configure() only sets the keys present
+    virtual void resetConfig() {}
+
+    // Compiled config (optional, see config_blob.h). saveSettings() packs the
+    // configured state into buf and returns its size (0 = not supported / does
+    // not fit); loadSettings() restores it without JSON and returns false on a
+    // version or size mismatch so the caller falls back to configure().
+    virtual size_t saveSettings(uint8_t* buf, size_t cap) { return 0; }
+    virtual bool loadSettings(const uint8_t* buf, size_t len) { return false; }
     
     // Dependencies injection (set by AppManager)
     void setWiFiManager(WiFiManager* wifi) { _wifi = wifi; }
     void setDisplayManager(DisplayManager* display) { _display = display; }
     void setPowerManager(PowerManager* power) { _power = power; }
     void setOTAManager(OTAManager* ota) { _ota = ota; }
+    void setWakeScheduler(WakeScheduler* scheduler) { _scheduler = scheduler; }
 
 protected:
+    // resetConfig() for apps whose defaults are their constructor's: assigns a fresh
+    // App over the app, keeping the injected managers
+    template <typename App>
+    static void assignDefaults(App& app) {
+        AppInterface& base = app;
+        WiFiManager* wifi = base._wifi;
+        DisplayManager* display = base._display;
+        PowerManager* power = base._power;
+        OTAManager* ota = base._ota;
+        WakeScheduler* scheduler = base._scheduler;
+        app = App();
+        base._wifi = wifi;
+        base._display = display;
+        base._power = power;
+        base._ota = ota;
+        base._scheduler = scheduler;
+    }
+
     WiFiManager* _wifi = nullptr;
     DisplayManager* _display = nullptr;
     PowerManager* _power = nullptr;
     OTAManager* _ota = nullptr;
+    // AppManager services radio tasks and sleeps; apps may query it (e.g. clockValid())
+    WakeScheduler* _scheduler = nullptr;
 };
 
 #endif // APP_INTERFACE_H
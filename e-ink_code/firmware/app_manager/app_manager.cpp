@@ -1,13 +1,29 @@
 #include "app_manager.h"
+#include "config_blob.h"
+#include "config_transform.h"
 #include "../core/wifi/wifi_manager.h"
 #include "../core/display/display_manager.h"
 #include "../core/power/power_manager.h"
 #include "../core/ota/ota_manager.h"
+#include "../core/config/config_store.h"
 #include <ArduinoJson.h>
+#include <freertos/task.h>
 
-AppManager::AppManager() : _appCount(0), _activeAppIndex(-1), 
+// Compiled config blob kept across deep sleep; s_rtcConfigCheck ties length + contents
+// together so a half-written or stale snapshot is never applied.
+RTC_DATA_ATTR static uint8_t s_rtcConfigBlob[CONFIG_RTC_SNAPSHOT_MAX];
+RTC_DATA_ATTR static uint16_t s_rtcConfigLength = 0;
+RTC_DATA_ATTR static uint32_t s_rtcConfigCheck = 0;
+
+static uint32_t rtcSnapshotCheck(uint16_t length) {
+    return configBlobCrc(s_rtcConfigBlob, length) ^ CONFIG_BLOB_MAGIC ^ length;
+}
+
+AppManager::AppManager() : _publishApp(nullptr), _publishCycle(nullptr), _publishDone(nullptr),
+                           _appCount(0), _activeAppIndex(-1), _begunAppIndex(-1),
                            _wifi(nullptr), _display(nullptr), 
-                           _power(nullptr), _ota(nullptr) {
+                           _power(nullptr), _ota(nullptr),
+                           _playlistIndex(-1) {
     for (int i = 0; i < MAX_APPS; i++) {
         _apps[i] = nullptr;
         _appNames[i] = nullptr;
@@ -24,10 +40,12 @@ void AppManager::setDisplayManager(DisplayManager* display) {
 
 void AppManager::setPowerManager(PowerManager* power) {
     _power = power;
+    _scheduler.setPowerManager(power);
 }
 
 void AppManager::setOTAManager(OTAManager* ota) {
     _ota = ota;
+    _scheduler.setOTAManager(ota);
 }
 
 void AppManager::registerApp(AppInterface* app, const char* name) {
@@ -46,6 +64,7 @@ void AppManager::registerApp(AppInterface* app, const char* name) {
     app->setDisplayManager(_display);
     app->setPowerManager(_power);
     app->setOTAManager(_ota);
+    app->setWakeScheduler(&_scheduler);
     
     _apps[_appCount] = app;
     _appNames[_appCount] = name;
@@ -60,14 +79,20 @@ void AppManager::registerApp(AppInterface* app, const char* name) {
     }
 }
 
+void AppManager::endBegunApp() {
+    if (_begunAppIndex >= 0 && _begunAppIndex < _appCount) {
+        _apps[_begunAppIndex]->end();
+    }
+    _begunAppIndex = -1;
+}
+
 void AppManager::setActiveApp(const char* name) {
     for (int i = 0; i < _appCount; i++) {
         if (strcmp(_appNames[i], name) == 0) {
-            if (_activeAppIndex >= 0 && _activeAppIndex < _appCount) {
-                _apps[_activeAppIndex]->end();
-            }
+            endBegunApp();
             _activeAppIndex = i;
             _apps[_activeAppIndex]->begin();
+            _begunAppIndex = _activeAppIndex;
             Serial.print("[AppManager] Switched to app: ");
             Serial.println(name);
             return;
@@ -84,12 +109,10 @@ void AppManager::setActiveApp(int index) {
         return;
     }
     
-    if (_activeAppIndex >= 0 && _activeAppIndex < _appCount) {
-        _apps[_activeAppIndex]->end();
-    }
-    
+    endBegunApp();
     _activeAppIndex = index;
     _apps[_activeAppIndex]->begin();
+    _begunAppIndex = _activeAppIndex;
     
     Serial.print("[AppManager] Switched to app index: ");
     Serial.print(index);
@@ -104,7 +127,7 @@ bool AppManager::configureFromJson(const char* jsonString) {
         return false;
     }
     
-    DynamicJsonDocument doc(2048);
+    DynamicJsonDocument doc(configJsonCapacity(strlen(jsonString)));
     DeserializationError error = deserializeJson(doc, jsonString);
     
     if (error) {
@@ -113,6 +136,11 @@ bool AppManager::configureFromJson(const char* jsonString) {
         return false;
     }
     
+    if (doc["playlist"].is<JsonArray>()) {
+        return configurePlaylist(doc.as<JsonObject>());
+    }
+    _playlist.clear();
+
     // Get app name
     if (!doc.containsKey("app")) {
         Serial.println("[AppManager] JSON missing 'app' field");
@@ -129,9 +157,9 @@ bool AppManager::configureFromJson(const char* jsonString) {
     bool appFound = false;
     for (int i = 0; i < _appCount; i++) {
         if (strcmp(_appNames[i], appName) == 0) {
-            // End current app if switching
-            if (_activeAppIndex >= 0 && _activeAppIndex < _appCount && _activeAppIndex != i) {
-                _apps[_activeAppIndex]->end();
+            // End the running app if switching (begin() restarts a reconfigured one)
+            if (_begunAppIndex != i) {
+                endBegunApp();
             }
             
             _activeAppIndex = i;
@@ -148,6 +176,9 @@ bool AppManager::configureFromJson(const char* jsonString) {
         return false;
     }
     
+    // A new config replaces the old one: keys it leaves out go back to their defaults
+    _apps[_activeAppIndex]->resetConfig();
+
     // Configure the app if config is provided
     if (doc.containsKey("config") && doc["config"].is<JsonObject>()) {
         JsonObject config = doc["config"].as<JsonObject>();
@@ -162,16 +193,365 @@ bool AppManager::configureFromJson(const char* jsonString) {
     return true;
 }
 
+int AppManager::findApp(const char* name) const {
+    for (int i = 0; i < _appCount; i++) {
+        if (name != nullptr && strcmp(_appNames[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool AppManager::configurePlaylist(JsonObject root) {
+    _playlist.clear();
+    _playlist.setTzRule(root["tzRule"] | "");
+
+    for (JsonObject item : root["playlist"].as<JsonArray>()) {
+        const char* appName = item["app"] | "";
+        int index = findApp(appName);
+        if (index < 0) {
+            Serial.print("[AppManager] Playlist app not in firmware, skipping: ");
+            Serial.println(appName);
+            continue;
+        }
+        // Check before configure(): a skipped duplicate must not overwrite the first entry's settings
+        if (!_playlist.canAdd((uint8_t)index)) {
+            Serial.print("[AppManager] Playlist full or app listed twice, skipping: ");
+            Serial.println(appName);
+            continue;
+        }
+        _apps[index]->resetConfig();
+        if (item["config"].is<JsonObject>() && !_apps[index]->configure(item["config"].as<JsonObject>())) {
+            Serial.print("[AppManager] Playlist app configuration failed: ");
+            Serial.println(appName);
+            continue;
+        }
+        PlaylistEntry entry;
+        entry.app = (uint8_t)index;
+        entry.intervalMinutes = item["interval"] | 60;
+        entry.fromHour = item["fromHour"] | PLAYLIST_ALL_DAY;
+        entry.toHour = item["toHour"] | PLAYLIST_ALL_DAY;
+        _playlist.add(entry);
+        Serial.printf("[AppManager] Playlist: %s every %u min", appName, entry.intervalMinutes);
+        if (entry.fromHour != PLAYLIST_ALL_DAY) {
+            Serial.printf(" (%02d:00-%02d:00)", entry.fromHour, entry.toHour);
+        }
+        Serial.println();
+    }
+
+    if (!_playlist.active()) {
+        Serial.println("[AppManager] Playlist has no usable entries");
+        return false;
+    }
+    _playlist.commit();
+    // begin() picks the entry for this wake; until then the first entry is active
+    endBegunApp();
+    _activeAppIndex = _playlist.entry(0).app;
+    return true;
+}
+
+size_t AppManager::compilePlaylist(uint8_t* out, size_t cap) {
+    size_t used = sizeof(PlaylistBlobHeader) + _playlist.count() * sizeof(PlaylistBlobEntry);
+    if (cap < used) {
+        return 0;
+    }
+    PlaylistBlobHeader header;
+    memset(&header, 0, sizeof(header));
+    header.version = PLAYLIST_BLOB_VERSION;
+    header.count = (uint8_t)_playlist.count();
+    strncpy(header.tzRule, _playlist.tzRule(), sizeof(header.tzRule) - 1);
+    memcpy(out, &header, sizeof(header));
+
+    for (int i = 0; i < _playlist.count(); i++) {
+        const PlaylistEntry& entry = _playlist.entry(i);
+        size_t length = _apps[entry.app]->saveSettings(out + used, cap - used);
+        if (length == 0 || length > 0xFFFF || strlen(_appNames[entry.app]) >= sizeof(PlaylistBlobEntry::app)) {
+            Serial.print("[AppManager] Playlist app has no compiled config: ");
+            Serial.println(_appNames[entry.app]);
+            return 0;
+        }
+        PlaylistBlobEntry record;
+        memset(&record, 0, sizeof(record));
+        strncpy(record.app, _appNames[entry.app], sizeof(record.app) - 1);
+        record.intervalMinutes = entry.intervalMinutes;
+        record.fromHour = entry.fromHour;
+        record.toHour = entry.toHour;
+        record.length = (uint16_t)length;
+        memcpy(out + sizeof(header) + i * sizeof(record), &record, sizeof(record));
+        used += length;
+    }
+    return used;
+}
+
+bool AppManager::applyPlaylistBlob(const uint8_t* payload, size_t len) {
+    PlaylistBlobHeader header;
+    if (len < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, payload, sizeof(header));
+    header.tzRule[sizeof(header.tzRule) - 1] = '\0';
+    size_t offset = sizeof(header) + header.count * sizeof(PlaylistBlobEntry);
+    if (header.version != PLAYLIST_BLOB_VERSION || header.count == 0 || offset > len) {
+        return false;
+    }
+
+    _playlist.clear();
+    _playlist.setTzRule(header.tzRule);
+    for (int i = 0; i < header.count; i++) {
+        PlaylistBlobEntry record;
+        memcpy(&record, payload + sizeof(header) + i * sizeof(record), sizeof(record));
+        record.app[sizeof(record.app) - 1] = '\0';
+        int index = findApp(record.app);
+        if (index < 0 || offset + record.length > len ||
+            !_apps[index]->loadSettings(payload + offset, record.length)) {
+            Serial.print("[AppManager] Compiled playlist entry rejected: ");
+            Serial.println(record.app);
+            _playlist.clear();
+            return false;
+        }
+        offset += record.length;
+        PlaylistEntry entry;
+        entry.app = (uint8_t)index;
+        entry.intervalMinutes = record.intervalMinutes;
+        entry.fromHour = record.fromHour;
+        entry.toHour = record.toHour;
+        _playlist.add(entry);
+    }
+    _playlist.commit();
+    endBegunApp();
+    _activeAppIndex = _playlist.entry(0).app;
+    Serial.printf("[AppManager] Playlist from compiled config: %d entries\n", _playlist.count());
+    return true;
+}
+
+size_t AppManager::compileConfigBlob(uint8_t* out, size_t cap) {
+    if (_activeAppIndex < 0 || _activeAppIndex >= _appCount || out == nullptr ||
+        cap <= sizeof(ConfigBlobHeader)) {
+        return 0;
+    }
+
+    ConfigBlobHeader header;
+    memset(&header, 0, sizeof(header));
+    const char* name = _playlist.active() ? CONFIG_BLOB_PLAYLIST_APP : _appNames[_activeAppIndex];
+    if (strlen(name) >= sizeof(header.app)) {
+        return 0;
+    }
+    uint8_t* payload = out + sizeof(ConfigBlobHeader);
+    size_t payloadCap = cap - sizeof(ConfigBlobHeader);
+    if (payloadCap > 0xFFFF) payloadCap = 0xFFFF;
+    size_t length = _playlist.active() ? compilePlaylist(payload, payloadCap)
+                                       : _apps[_activeAppIndex]->saveSettings(payload, payloadCap);
+    if (length == 0) {
+        Serial.println("[AppManager] Active app has no compiled config; JSON will be used");
+        return 0;
+    }
+
+    header.magic = CONFIG_BLOB_MAGIC;
+    header.formatVersion = CONFIG_BLOB_FORMAT_VERSION;
+    header.length = (uint16_t)length;
+    header.crc32 = configBlobCrc(payload, length);
+    strncpy(header.app, name, sizeof(header.app) - 1);
+    memcpy(out, &header, sizeof(header));
+
+    Serial.printf("[AppManager] Compiled config for %s: %u bytes\n",
+                  header.app, (unsigned)(sizeof(header) + length));
+    return sizeof(header) + length;
+}
+
+bool AppManager::applyConfigBlob(const uint8_t* blob, size_t len) {
+    if (blob == nullptr || len < sizeof(ConfigBlobHeader)) {
+        return false;
+    }
+    ConfigBlobHeader header;
+    memcpy(&header, blob, sizeof(header));
+    header.app[sizeof(header.app) - 1] = '\0';
+    const uint8_t* payload = blob + sizeof(ConfigBlobHeader);
+
+    if (header.magic != CONFIG_BLOB_MAGIC || header.formatVersion != CONFIG_BLOB_FORMAT_VERSION ||
+        sizeof(header) + header.length != len || configBlobCrc(payload, header.length) != header.crc32) {
+        Serial.println("[AppManager] Compiled config invalid or from another format, ignoring");
+        return false;
+    }
+
+    if (strcmp(header.app, CONFIG_BLOB_PLAYLIST_APP) == 0) {
+        return applyPlaylistBlob(payload, header.length);
+    }
+    _playlist.clear();
+
+    for (int i = 0; i < _appCount; i++) {
+        if (strcmp(_appNames[i], header.app) != 0) {
+            continue;
+        }
+        if (!_apps[i]->loadSettings(payload, header.length)) {
+            Serial.print("[AppManager] Compiled config rejected by app: ");
+            Serial.println(header.app);
+            return false;
+        }
+        if (_begunAppIndex != i) {
+            endBegunApp();
+        }
+        _activeAppIndex = i;
+        Serial.print("[AppManager] Active app from compiled config: ");
+        Serial.println(header.app);
+        return true;
+    }
+
+    Serial.print("[AppManager] Compiled config app not in firmware: ");
+    Serial.println(header.app);
+    return false;
+}
+
+bool AppManager::restoreRtcSnapshot() {
+    if (s_rtcConfigLength == 0 || s_rtcConfigLength > sizeof(s_rtcConfigBlob) ||
+        s_rtcConfigCheck != rtcSnapshotCheck(s_rtcConfigLength)) {
+        Serial.println("[AppManager] No valid RTC config snapshot");
+        return false;
+    }
+    return applyConfigBlob(s_rtcConfigBlob, s_rtcConfigLength);
+}
+
+void AppManager::saveRtcSnapshot() {
+    // Invalidate first so a failed compile leaves no snapshot behind
+    s_rtcConfigLength = 0;
+    s_rtcConfigCheck = 0;
+    size_t length = compileConfigBlob(s_rtcConfigBlob, sizeof(s_rtcConfigBlob));
+    if (length == 0) {
+        return;
+    }
+    s_rtcConfigLength = (uint16_t)length;
+    s_rtcConfigCheck = rtcSnapshotCheck(s_rtcConfigLength);
+}
+
 void AppManager::begin() {
+    // Called again after a hot-applied config: end the running app before starting over
+    endBegunApp();
+    if (_playlist.active()) {
+        _playlistIndex = _playlist.pickCurrent();
+        if (_playlistIndex < 0) {
+            Serial.println("[AppManager] Playlist: no entry inside its hours on this wake");
+            return;
+        }
+        _activeAppIndex = _playlist.entry(_playlistIndex).app;
+        Serial.print("[AppManager] Playlist entry for this wake: ");
+        Serial.println(_appNames[_activeAppIndex]);
+    }
     if (_activeAppIndex >= 0 && _activeAppIndex < _appCount) {
         _apps[_activeAppIndex]->begin();
+        _begunAppIndex = _activeAppIndex;
     }
 }
 
-void AppManager::loop() {
-    if (_activeAppIndex >= 0 && _activeAppIndex < _appCount) {
-        _apps[_activeAppIndex]->loop();
+WakeRequest AppManager::nextPlaylistWake() {
+    int next = -1;
+    uint32_t seconds = _playlist.secondsUntilNext(&next);
+    if (seconds < 60) seconds = 60;
+    if (next < 0) {
+        return WakeRequest::refresh(seconds, false);
+    }
+    AppInterface* app = _apps[_playlist.entry(next).app];
+    bool radio = app->wantsNetwork() && ConfigStore::instance().wifiSSID().length() > 0;
+    Serial.printf("[AppManager] Playlist: next is %s in %lus\n", _appNames[_playlist.entry(next).app],
+                  (unsigned long)seconds);
+    return WakeRequest::refresh(seconds, radio);
+}
+
+void AppManager::loop(int batteryPercent) {
+    if (_playlist.active() && _playlistIndex < 0) {
+        // Every window is closed: nothing to show, sleep until one opens
+        _scheduler.sleep(nextPlaylistWake());
+        return;
     }
+    if (_activeAppIndex < 0 || _activeAppIndex >= _appCount) {
+        return;
+    }
+    AppInterface* app = _apps[_activeAppIndex];
+    AppCycle cycle;
+    uint32_t startMs = millis();
+
+    // Start associating first; everything local runs while the radio joins
+    bool radio = false;
+    if (_wifi && app->wantsNetwork()) {
+        ConfigStore& store = ConfigStore::instance();
+        radio = _wifi->beginAsync(store.wifiSSID().c_str(), store.wifiPassword().c_str());
+        if (!radio) {
+            Serial.println("[AppManager] No WiFi credentials stored; running offline");
+        }
+    }
+
+    cycle.batteryPercent = batteryPercent;
+    if (cycle.batteryPercent < 0 && _power) {
+        cycle.batteryPercent = _power->getBatteryPercentage();
+    }
+    app->acquire(cycle);
+    uint32_t acquiredMs = millis();
+
+    if (radio) {
+        cycle.wifiConnected = _wifi->waitForConnection();
+        if (cycle.wifiConnected) {
+            _scheduler.syncTimeIfDue();
+            app->fetch(cycle);
+        }
+    }
+    uint32_t fetchedMs = millis();
+
+    // Uploads go out while the panel refreshes
+    bool publishing = cycle.wifiConnected && startPublish(app, cycle);
+    app->render(cycle);
+    uint32_t renderedMs = millis();
+    if (publishing) {
+        joinPublish();
+    } else if (cycle.wifiConnected) {
+        app->publish(cycle);
+    }
+
+    if (cycle.wifiConnected) {
+        _scheduler.serviceRadioTasks();
+    }
+    if (radio) {
+        _wifi->disconnect();
+    }
+
+    Serial.printf("[AppManager] Cycle %lu ms: acquire %lu, connect+fetch %lu, render %lu, publish wait %lu\n",
+                  (unsigned long)(millis() - startMs), (unsigned long)(acquiredMs - startMs),
+                  (unsigned long)(fetchedMs - acquiredMs), (unsigned long)(renderedMs - fetchedMs),
+                  (unsigned long)(millis() - renderedMs));
+
+    WakeRequest request = app->finish(cycle);
+    if (_playlist.active()) {
+        // The entry's interval replaces the app's own refresh interval
+        _playlist.markRun(_playlistIndex);
+        request = nextPlaylistWake();
+    }
+    _scheduler.sleep(request);
+}
+
+bool AppManager::startPublish(AppInterface* app, AppCycle& cycle) {
+    if (_publishDone == nullptr) {
+        _publishDone = xSemaphoreCreateBinary();
+        if (_publishDone == nullptr) {
+            return false;
+        }
+    }
+    _publishApp = app;
+    _publishCycle = &cycle;
+    // Same priority as the Arduino loop task: the two alternate whenever one blocks
+    // (display BUSY polling, socket waits)
+    if (xTaskCreate(publishTask, "app_publish", APP_PUBLISH_TASK_STACK, this, 1, nullptr) != pdPASS) {
+        Serial.println("[AppManager] Publish task failed to start; publishing after render");
+        return false;
+    }
+    return true;
+}
+
+void AppManager::joinPublish() {
+    xSemaphoreTake(_publishDone, portMAX_DELAY);
+}
+
+void AppManager::publishTask(void* param) {
+    AppManager* self = static_cast<AppManager*>(param);
+    self->_publishApp->publish(*self->_publishCycle);
+    xSemaphoreGive(self->_publishDone);
+    vTaskDelete(nullptr);
 }
 
 int AppManager::getAppCount() {
@@ -3,6 +3,15 @@
 
 #include <Arduino.h>
 #include "app_interface.h"
+#include "wake_scheduler.h"
+#include "playlist.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Stack for the publish phase task; it runs HTTPS uploads (mbedTLS handshake)
+#ifndef APP_PUBLISH_TASK_STACK
+#define APP_PUBLISH_TASK_STACK 12288
+#endif
 
 // Forward declarations
 class WiFiManager;
@@ -27,11 +36,42 @@ public:
     
     // Configuration from JSON string
     // Expected format: {"app": "fun", "config": {...}}
+    // or a playlist:   {"tzRule": "...", "playlist": [{"app": "sensor", "interval": 10,
+    //                   "fromHour": 7, "toHour": 22, "config": {...}}, ...]}
     bool configureFromJson(const char* jsonString);
+
+    // Compiled config blob (ConfigBlobHeader + the active app's packed settings).
+    // compileConfigBlob() returns the blob size, or 0 if the app has no packed form.
+    // applyConfigBlob() selects and restores the app; false means use the JSON path.
+    size_t compileConfigBlob(uint8_t* out, size_t cap);
+    bool applyConfigBlob(const uint8_t* blob, size_t len);
+
+    // RTC snapshot of the compiled config. The config only changes through BLE
+    // provisioning, which refreshes the snapshot when it applies the new config,
+    // so timer wakes can restore the active app without NVS reads or configure().
+    bool restoreRtcSnapshot();
+    void saveRtcSnapshot();
     
-    // App management
+    // Playlist mode (see playlist.h): begin() picks the entry due on this wake and
+    // makes its app active; loop() sleeps until the next entry instead of the app's interval.
+    bool playlistActive() const { return _playlist.active(); }
+
+    // App management. loop() runs one cycle of the active app and then sleeps via
+    // the scheduler; batteryPercent is the caller's reading (-1 = read it here).
+    //
+    // One cycle, with a single WiFi session shared by every phase:
+    //   WiFi association starts  ┐
+    //   acquire()                ┘ overlap
+    //   wait for WiFi → NTP if due → fetch()
+    //   render()                 ┐ overlap (publish runs on its own task while
+    //   publish()                ┘ the panel refresh busy-waits)
+    //   radio tasks (OTA, NTP) → WiFi off → finish() → deep sleep
+    //
+    // begin() may run again after a new config was applied; the app begun before is
+    // ended first, as is a running app that configuring switches away from.
     void begin();
-    void loop();
+    void loop(int batteryPercent = -1);
+    WakeScheduler& scheduler() { return _scheduler; }
     
     // App query
     int getAppCount();
@@ -42,15 +82,35 @@ public:
 
 private:
     static const int MAX_APPS = 10;
+
+    int findApp(const char* name) const;
+    void endBegunApp();
+    bool configurePlaylist(JsonObject root);
+    size_t compilePlaylist(uint8_t* out, size_t cap);
+    bool applyPlaylistBlob(const uint8_t* payload, size_t len);
+    WakeRequest nextPlaylistWake();
+
+    bool startPublish(AppInterface* app, AppCycle& cycle);
+    void joinPublish();
+    static void publishTask(void* param);
+
+    // Publish job handed to publishTask (one per cycle)
+    AppInterface* _publishApp;
+    AppCycle* _publishCycle;
+    SemaphoreHandle_t _publishDone;
     AppInterface* _apps[MAX_APPS];
     const char* _appNames[MAX_APPS];
     int _appCount;
     int _activeAppIndex;
+    int _begunAppIndex;   // app whose begin() ran without a matching end() (-1 = none)
     
     WiFiManager* _wifi;
     DisplayManager* _display;
     PowerManager* _power;
     OTAManager* _ota;
+    WakeScheduler _scheduler;
+    Playlist _playlist;
+    int _playlistIndex;   // entry running on this wake (-1 = none / not in playlist mode)
 };
 
 #endif // APP_MANAGER_H
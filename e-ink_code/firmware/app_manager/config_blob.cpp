@@ -0,0 +1,6 @@
+#include "config_blob.h"
+#include <esp_rom_crc.h>
+
+uint32_t configBlobCrc(const uint8_t* data, size_t len) {
+    return esp_rom_crc32_le(0, data, len);
+}
@@ -0,0 +1,74 @@
+#ifndef CONFIG_BLOB_H
+#define CONFIG_BLOB_H
+
+#include <Arduino.h>
+
+/**
+ * Compiled app configuration.
+ *
+ * processPendingConfig() configures the app from JSON once, then asks it for a
+ * packed settings struct (AppInterface::saveSettings) and stores
+ * ConfigBlobHeader + payload in NVS ("configBlob"). Every later boot maps that
+ * struct back with loadSettings() and never touches ArduinoJson.
+ *
+ * Settings structs (in each app's config.h) are packed and start with a uint8_t
+ * version, the app's *_SETTINGS_VERSION. Bump it whenever the layout changes:
+ * loadSettings() rejects a stored blob with another version, and the boot falls
+ * back to the stored JSON. Strings go into fixed fields with packString(); a value
+ * that does not fit makes saveSettings() return 0, so that config stays on JSON.
+ */
+#define CONFIG_BLOB_MAGIC          0x31424345UL  // "ECB1"
+#define CONFIG_BLOB_FORMAT_VERSION 1
+#define CONFIG_BLOB_MAX            2048
+// RTC slow memory is small and shared; larger blobs are simply re-read from NVS each wake
+#define CONFIG_RTC_SNAPSHOT_MAX    1024
+
+struct __attribute__((packed)) ConfigBlobHeader {
+    uint32_t magic;
+    uint16_t formatVersion;
+    uint16_t length;   // payload bytes following the header
+    uint32_t crc32;    // over the payload
+    char app[16];      // registered app name, NUL-terminated
+};
+
+/**
+ * Playlist blob: ConfigBlobHeader.app is CONFIG_BLOB_PLAYLIST_APP and the payload
+ * is PlaylistBlobHeader, `count` PlaylistBlobEntry records, then each entry's
+ * saveSettings() bytes back to back (`length` each, in entry order).
+ */
+#define CONFIG_BLOB_PLAYLIST_APP   "playlist"
+#define PLAYLIST_BLOB_VERSION      1
+
+struct __attribute__((packed)) PlaylistBlobHeader {
+    uint8_t version;
+    uint8_t count;
+    char tzRule[48];
+};
+
+struct __attribute__((packed)) PlaylistBlobEntry {
+    char app[16];
+    uint16_t intervalMinutes;
+    int8_t fromHour;
+    int8_t toHour;
+    uint16_t length;
+};
+
+uint32_t configBlobCrc(const uint8_t* data, size_t len);
+
+/** Copy into a fixed field. Returns false (and truncates) when the value does not fit. */
+template <size_t N>
+bool packString(char (&dst)[N], const String& src) {
+    strncpy(dst, src.c_str(), N - 1);
+    dst[N - 1] = '\0';
+    return src.length() < N;
+}
+
+template <size_t N>
+String unpackString(const char (&src)[N]) {
+    char tmp[N + 1];
+    memcpy(tmp, src, N);
+    tmp[N] = '\0';
+    return String(tmp);
+}
+
+#endif // CONFIG_BLOB_H
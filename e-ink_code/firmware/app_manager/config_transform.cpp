@@ -0,0 +1,218 @@
+#include "config_transform.h"
+#include <ArduinoJson.h>
+
+// Copy one app's fields (refreshInterval, apis, sensor app fields, etc.) into its config object
+static void copyAppFields(JsonObjectConst stored, JsonObject config) {
+    if (stored.containsKey("refreshInterval")) {
+        config["refreshInterval"] = stored["refreshInterval"];
+    }
+    if (stored.containsKey("apis")) {
+        config["apis"] = stored["apis"];
+    }
+    // Sensor app: temperature units (C/F), nemo token/url/sensor ID, location
+    if (stored.containsKey("units")) {
+        config["units"] = stored["units"];
+    } else if (stored.containsKey("temperatureUnit")) {
+        config["units"] = stored["temperatureUnit"];
+    }
+    if (stored.containsKey("nemoToken")) {
+        config["nemoToken"] = stored["nemoToken"];
+    } else if (stored.containsKey("nemo_token")) {
+        config["nemoToken"] = stored["nemo_token"];
+    }
+    if (stored.containsKey("nemoUrl")) {
+        config["nemoUrl"] = stored["nemoUrl"];
+    } else if (stored.containsKey("nemo_url")) {
+        config["nemoUrl"] = stored["nemo_url"];
+    } else if (stored.containsKey("nemoApiEndpoint")) {
+        config["nemoUrl"] = stored["nemoApiEndpoint"];
+    }
+    // Handle temperature and humidity sensor IDs separately
+    if (stored.containsKey("temperatureSensorId")) {
+        config["temperatureSensorId"] = stored["temperatureSensorId"];
+    } else if (stored.containsKey("temperature_sensor_id")) {
+        config["temperatureSensorId"] = stored["temperature_sensor_id"];
+    }
+    if (stored.containsKey("humiditySensorId")) {
+        config["humiditySensorId"] = stored["humiditySensorId"];
+    } else if (stored.containsKey("humidity_sensor_id")) {
+        config["humiditySensorId"] = stored["humidity_sensor_id"];
+    }
+    if (stored.containsKey("batterySensorId")) {
+        config["batterySensorId"] = stored["batterySensorId"];
+    } else if (stored.containsKey("battery_sensor_id")) {
+        config["batterySensorId"] = stored["battery_sensor_id"];
+    }
+    // Legacy support for single sensorId (for backwards compatibility)
+    if (stored.containsKey("sensorId") && !config.containsKey("temperatureSensorId")) {
+        config["temperatureSensorId"] = stored["sensorId"];
+    } else if (stored.containsKey("sensor_id") && !config.containsKey("temperatureSensorId")) {
+        config["temperatureSensorId"] = stored["sensor_id"];
+    } else if (stored.containsKey("nemoSensorId") && !config.containsKey("temperatureSensorId")) {
+        config["temperatureSensorId"] = stored["nemoSensorId"];
+    }
+    if (stored.containsKey("sensorLocation")) {
+        config["sensorLocation"] = stored["sensorLocation"];
+    } else if (stored.containsKey("sensor_location")) {
+        config["sensorLocation"] = stored["sensor_location"];
+    }
+    if (stored.containsKey("timeServer")) {
+        config["timeServer"] = stored["timeServer"];
+    } else if (stored.containsKey("time_server")) {
+        config["timeServer"] = stored["time_server"];
+    }
+    // Timezone selection for DST-aware local time (preferred)
+    if (stored.containsKey("timeZone")) {
+        config["timeZone"] = stored["timeZone"];
+    } else if (stored.containsKey("timezone")) {
+        config["timeZone"] = stored["timezone"];
+    } else if (stored.containsKey("time_zone")) {
+        config["timeZone"] = stored["time_zone"];
+    }
+    // Sensor app repaint policy (deadbands, repaint interval bounds, "Updated:" line) and sparkline
+    static const char* const kRepaintKeys[][2] = {
+        {"tempDeadbandC", "temp_deadband_c"},
+        {"humidityDeadband", "humidity_deadband"},
+        {"minRepaintMinutes", "min_repaint_minutes"},
+        {"maxRepaintMinutes", "max_repaint_minutes"},
+        {"updatedTime", "updated_time"},
+        {"showHistory", "show_history"},
+    };
+    for (const auto& key : kRepaintKeys) {
+        if (stored.containsKey(key[0])) {
+            config[key[0]] = stored[key[0]];
+        } else if (stored.containsKey(key[1])) {
+            config[key[0]] = stored[key[1]];
+        }
+    }
+    if (stored.containsKey("gmtOffsetSec")) {
+        config["gmtOffsetSec"] = stored["gmtOffsetSec"];
+    }
+    if (stored.containsKey("daylightOffsetSec")) {
+        config["daylightOffsetSec"] = stored["daylightOffsetSec"];
+    }
+    // Shelf app: bin ID, server host, server port
+    if (stored.containsKey("binId")) {
+        config["binId"] = stored["binId"];
+    } else if (stored.containsKey("bin_id")) {
+        config["binId"] = stored["bin_id"];
+    }
+    if (stored.containsKey("serverHost")) {
+        config["serverHost"] = stored["serverHost"];
+    } else if (stored.containsKey("server_host")) {
+        config["serverHost"] = stored["server_host"];
+    }
+    if (stored.containsKey("serverPort")) {
+        config["serverPort"] = stored["serverPort"];
+    } else if (stored.containsKey("server_port")) {
+        config["serverPort"] = stored["server_port"];
+    }
+    // Device identity (friendly name + optional phone-mint UUID) for fun aggregator / messaging
+    if (stored.containsKey("displayName")) {
+        config["displayName"] = stored["displayName"];
+    } else if (stored.containsKey("deviceFriendlyName")) {
+        config["displayName"] = stored["deviceFriendlyName"];
+    } else if (stored.containsKey("friendly_name")) {
+        config["displayName"] = stored["friendly_name"];
+    }
+    if (stored.containsKey("deviceId")) {
+        config["deviceId"] = stored["deviceId"];
+    } else if (stored.containsKey("device_id")) {
+        config["deviceId"] = stored["device_id"];
+    }
+    // Messages app: array of up to 10 messages
+    if (stored.containsKey("messages") && stored["messages"].is<JsonArrayConst>()) {
+        config["messages"] = stored["messages"];
+    } else {
+        bool hasMessage = false;
+        JsonArray msgArr;
+        for (int i = 1; i <= 10; i++) {
+            String key = "message" + String(i);
+            if (stored.containsKey(key.c_str())) {
+                if (!hasMessage) {
+                    msgArr = config.createNestedArray("messages");
+                    hasMessage = true;
+                }
+                msgArr.add(stored[key.c_str()]);
+            }
+        }
+    }
+    // Legacy support: if serverUrl is provided, try to parse it
+    if (stored.containsKey("serverUrl") || stored.containsKey("server_url")) {
+        String serverUrl = stored.containsKey("serverUrl") 
+            ? stored["serverUrl"].as<const char*>()
+            : stored["server_url"].as<const char*>();
+        // Try to parse URL format: http://host:port or host:port
+        int protocolEnd = serverUrl.indexOf("://");
+        String hostPort = (protocolEnd >= 0) ? serverUrl.substring(protocolEnd + 3) : serverUrl;
+        int colonPos = hostPort.indexOf(':');
+        if (colonPos > 0) {
+            config["serverHost"] = hostPort.substring(0, colonPos);
+            config["serverPort"] = hostPort.substring(colonPos + 1).toInt();
+        } else {
+            config["serverHost"] = hostPort;
+        }
+    }
+}
+
+// Playlist entries are flat like a single-app config, plus "interval" (minutes) and an
+// optional local-hour window. Top-level fields are defaults every entry can override.
+static bool copyPlaylist(JsonObjectConst stored, JsonObject appDoc) {
+    JsonArrayConst entries = stored["playlist"].as<JsonArrayConst>();
+    if (entries.isNull() || entries.size() == 0) {
+        return false;
+    }
+    if (stored.containsKey("tzRule")) {
+        appDoc["tzRule"] = stored["tzRule"];
+    }
+    JsonArray playlist = appDoc.createNestedArray("playlist");
+    for (JsonObjectConst entry : entries) {
+        if (!entry.containsKey("mode")) {
+            continue;
+        }
+        JsonObject out = playlist.createNestedObject();
+        out["app"] = entry["mode"];
+        if (entry.containsKey("interval")) {
+            out["interval"] = entry["interval"];
+        } else if (entry.containsKey("refreshInterval")) {
+            out["interval"] = entry["refreshInterval"];
+        }
+        if (entry.containsKey("fromHour")) out["fromHour"] = entry["fromHour"];
+        if (entry.containsKey("toHour")) out["toHour"] = entry["toHour"];
+        JsonObject config = out.createNestedObject("config");
+        copyAppFields(stored, config);
+        copyAppFields(entry, config);
+    }
+    return playlist.size() > 0;
+}
+
+bool transformStoredConfig(const char* storedJson, String& appConfigJson) {
+    if (storedJson == nullptr) {
+        return false;
+    }
+
+    size_t capacity = configJsonCapacity(strlen(storedJson));
+    DynamicJsonDocument storedDoc(capacity);
+    DeserializationError error = deserializeJson(storedDoc, storedJson);
+    if (error || !storedDoc.containsKey("mode")) {
+        return false;
+    }
+
+    // Create app manager format
+    // Playlist entries each get their own copy of the top-level defaults
+    bool playlist = strcmp(storedDoc["mode"] | "", "playlist") == 0;
+    DynamicJsonDocument appDoc(playlist ? capacity * 2 : capacity);
+    JsonObjectConst stored = storedDoc.as<JsonObjectConst>();
+    if (playlist) {
+        if (!copyPlaylist(stored, appDoc.to<JsonObject>())) {
+            return false;
+        }
+    } else {
+        appDoc["app"] = storedDoc["mode"];
+        copyAppFields(stored, appDoc.createNestedObject("config"));
+    }
+
+    appConfigJson = "";
+    serializeJson(appDoc, appConfigJson);
+    return true;
+}
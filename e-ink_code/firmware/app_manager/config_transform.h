@@ -0,0 +1,31 @@
+#ifndef CONFIG_TRANSFORM_H
+#define CONFIG_TRANSFORM_H
+
+#include <Arduino.h>
+
+/**
+ * Convert the flat JSON stored by BLE provisioning
+ *   {"mode":"fun","refreshInterval":60,"apis":{...},"wifiSSID":"...", ...}
+ * into the AppManager format {"app":"fun","config":{...}}, resolving the
+ * camelCase / snake_case / legacy key aliases the config UIs have used.
+ *
+ * "mode":"playlist" carries a "playlist" array of such flat objects, each with
+ * its own "mode", "interval" (minutes) and optional "fromHour"/"toHour"; it
+ * becomes {"tzRule":"...","playlist":[{"app":"sensor","interval":10,
+ * "config":{...}}, ...]}. Top-level fields are defaults for every entry.
+ *
+ * Returns false when the JSON does not parse or has no "mode".
+ */
+bool transformStoredConfig(const char* storedJson, String& appConfigJson);
+
+/**
+ * DynamicJsonDocument capacity for a config of jsonLength bytes. Strings are
+ * copied into the document, so allow roughly twice the text; never less than
+ * the 2 KB every config used to get.
+ */
+inline size_t configJsonCapacity(size_t jsonLength) {
+    size_t capacity = jsonLength * 2 + 512;
+    return capacity < 2048 ? 2048 : capacity;
+}
+
+#endif // CONFIG_TRANSFORM_H
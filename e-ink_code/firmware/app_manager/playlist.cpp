@@ -0,0 +1,159 @@
+#include "playlist.h"
+#include "config_blob.h"
+#include "wake_scheduler.h"
+#include "../core/rtc/rtc_state_store.h"
+#include <time.h>
+
+#define PLAYLIST_RTC_STATE_VERSION 1
+
+// Survives deep sleep: when each entry last ran, and which playlist that history belongs to
+struct PlaylistRtcState {
+    uint32_t signature = 0;
+    time_t lastRun[PLAYLIST_MAX_ENTRIES] = {0};
+};
+
+static PlaylistRtcState& history() {
+    static PlaylistRtcState fallback;  // RTC arena full: history lasts one wake
+    PlaylistRtcState* state = rtcState().slot<PlaylistRtcState>(RTC_SLOT_PLAYLIST, PLAYLIST_RTC_STATE_VERSION);
+    return state != nullptr ? *state : fallback;
+}
+
+Playlist::Playlist() : _count(0) {
+    setTzRule(PLAYLIST_DEFAULT_TZ_RULE);
+}
+
+void Playlist::clear() {
+    _count = 0;
+    setTzRule(PLAYLIST_DEFAULT_TZ_RULE);
+}
+
+bool Playlist::canAdd(uint8_t app) const {
+    if (_count >= PLAYLIST_MAX_ENTRIES) {
+        return false;
+    }
+    for (int i = 0; i < _count; i++) {
+        if (_entries[i].app == app) {
+            return false;  // one entry per app: each app has a single instance and config
+        }
+    }
+    return true;
+}
+
+bool Playlist::add(const PlaylistEntry& entry) {
+    if (!canAdd(entry.app)) {
+        return false;
+    }
+    PlaylistEntry e = entry;
+    if (e.intervalMinutes < 1) e.intervalMinutes = 1;
+    if (e.fromHour < 0 || e.fromHour > 23 || e.toHour < 0 || e.toHour > 23 || e.fromHour == e.toHour) {
+        e.fromHour = PLAYLIST_ALL_DAY;
+        e.toHour = PLAYLIST_ALL_DAY;
+    }
+    _entries[_count++] = e;
+    return true;
+}
+
+void Playlist::setTzRule(const char* tzRule) {
+    if (tzRule == nullptr || *tzRule == '\0') {
+        tzRule = PLAYLIST_DEFAULT_TZ_RULE;
+    }
+    strncpy(_tzRule, tzRule, sizeof(_tzRule) - 1);
+    _tzRule[sizeof(_tzRule) - 1] = '\0';
+}
+
+uint32_t Playlist::signature() const {
+    uint32_t crc = configBlobCrc((const uint8_t*)_entries, sizeof(PlaylistEntry) * _count);
+    return crc ^ configBlobCrc((const uint8_t*)_tzRule, strlen(_tzRule)) ^ (uint32_t)_count;
+}
+
+void Playlist::commit() {
+    uint32_t sig = signature();
+    PlaylistRtcState& state = history();
+    if (sig != state.signature) {
+        Serial.println("[Playlist] New playlist, run history cleared");
+        memset(state.lastRun, 0, sizeof(state.lastRun));
+        state.signature = sig;
+    }
+}
+
+void Playlist::applyTz() const {
+    // Apps (sensor) may set their own TZ during a cycle; windows always use ours
+    setenv("TZ", _tzRule, 1);
+    tzset();
+}
+
+bool Playlist::inWindow(const PlaylistEntry& entry, time_t at) const {
+    if (entry.fromHour == PLAYLIST_ALL_DAY || !WakeScheduler::clockValid()) {
+        return true;
+    }
+    struct tm local;
+    localtime_r(&at, &local);
+    if (entry.fromHour < entry.toHour) {
+        return local.tm_hour >= entry.fromHour && local.tm_hour < entry.toHour;
+    }
+    return local.tm_hour >= entry.fromHour || local.tm_hour < entry.toHour;
+}
+
+uint32_t Playlist::secondsUntilOpen(const PlaylistEntry& entry, time_t at) const {
+    if (inWindow(entry, at)) {
+        return 0;
+    }
+    struct tm local;
+    localtime_r(&at, &local);
+    int hours = (entry.fromHour - local.tm_hour + 24) % 24;
+    int32_t seconds = hours * 3600 - local.tm_min * 60 - local.tm_sec;
+    return seconds > 0 ? (uint32_t)seconds : (uint32_t)(seconds + 24 * 3600);
+}
+
+time_t Playlist::dueAt(int index, time_t now) const {
+    time_t last = history().lastRun[index];
+    if (last == 0 || last > now) {
+        return 0;  // never ran (or the clock went backwards): due right away
+    }
+    return last + (time_t)_entries[index].intervalMinutes * 60;
+}
+
+int Playlist::pickCurrent() {
+    applyTz();
+    time_t now = time(nullptr);
+    int best = -1;
+    time_t bestDue = 0;
+    // Most overdue first (earliest due time); ties keep playlist order
+    for (int i = 0; i < _count; i++) {
+        if (!inWindow(_entries[i], now)) {
+            continue;
+        }
+        time_t due = dueAt(i, now);
+        if (best < 0 || due < bestDue) {
+            best = i;
+            bestDue = due;
+        }
+    }
+    return best;
+}
+
+void Playlist::markRun(int index) {
+    if (index >= 0 && index < _count) {
+        history().lastRun[index] = time(nullptr);
+    }
+}
+
+uint32_t Playlist::secondsUntilNext(int* next) {
+    applyTz();
+    time_t now = time(nullptr);
+    uint32_t best = UINT32_MAX;
+    int bestIndex = -1;
+    for (int i = 0; i < _count; i++) {
+        time_t due = dueAt(i, now);
+        uint32_t wait = due > now ? (uint32_t)(due - now) : 0;
+        wait += secondsUntilOpen(_entries[i], now + (time_t)wait);
+        if (wait < best) {
+            best = wait;
+            bestIndex = i;
+        }
+    }
+    if (next != nullptr) {
+        *next = bestIndex;
+    }
+    return best;
+}
@@ -0,0 +1,70 @@
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include <Arduino.h>
+#include "hardware_config.h"
+
+// One entry per registered app at most, so the app count bounds the playlist
+#ifndef PLAYLIST_MAX_ENTRIES
+#define PLAYLIST_MAX_ENTRIES 4
+#endif
+
+// Hour windows are evaluated in this POSIX TZ unless the playlist config sets "tzRule"
+#ifndef PLAYLIST_DEFAULT_TZ_RULE
+#define PLAYLIST_DEFAULT_TZ_RULE "UTC0"
+#endif
+
+#define PLAYLIST_ALL_DAY (-1)
+
+struct __attribute__((packed)) PlaylistEntry {
+    uint8_t app;               // AppManager index
+    uint16_t intervalMinutes;  // run again this long after the last run
+    int8_t fromHour;           // local hours [fromHour, toHour), may wrap midnight;
+    int8_t toHour;             // PLAYLIST_ALL_DAY = no window
+};
+
+/**
+ * Playlist mode: several apps in one firmware, each with its own cadence.
+ *
+ * Every wake runs exactly one entry, the most overdue one whose hour window is
+ * open, and the device then sleeps until the next entry comes due. Last-run
+ * times live in RTC memory and use time(), which keeps counting across deep
+ * sleep even before NTP has set the clock; hour windows are only enforced once
+ * the clock is valid. A changed playlist (entries or TZ) forgets the run history.
+ */
+class Playlist {
+public:
+    Playlist();
+
+    void clear();
+    /** False when the playlist is full or already has an entry for this app. */
+    bool canAdd(uint8_t app) const;
+    bool add(const PlaylistEntry& entry);
+    void setTzRule(const char* tzRule);
+    /** Call once the entries are final (after configure or a blob restore). */
+    void commit();
+
+    int count() const { return _count; }
+    bool active() const { return _count > 0; }
+    const PlaylistEntry& entry(int index) const { return _entries[index]; }
+    const char* tzRule() const { return _tzRule; }
+
+    /** Entry to run on this wake, or -1 when every window is closed. */
+    int pickCurrent();
+    void markRun(int index);
+    /** Seconds until the next entry is due and its window open; *next gets its index. */
+    uint32_t secondsUntilNext(int* next);
+
+private:
+    void applyTz() const;
+    bool inWindow(const PlaylistEntry& entry, time_t at) const;
+    uint32_t secondsUntilOpen(const PlaylistEntry& entry, time_t at) const;
+    time_t dueAt(int index, time_t now) const;
+    uint32_t signature() const;
+
+    PlaylistEntry _entries[PLAYLIST_MAX_ENTRIES];
+    int _count;
+    char _tzRule[48];
+};
+
+#endif // PLAYLIST_H
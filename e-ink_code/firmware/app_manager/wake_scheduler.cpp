@@ -0,0 +1,122 @@
+#include "wake_scheduler.h"
+#include "../core/ota/ota_manager.h"
+#include "../core/power/power_manager.h"
+#include <time.h>
+#include <esp_sntp.h>
+
+// Anything earlier than 2021-01-01 means the RTC clock was never set
+static const time_t kMinValidEpoch = 1609459200;
+
+// Survives deep sleep: when each task last succeeded
+RTC_DATA_ATTR static time_t s_lastRun[WAKE_REASON_COUNT] = {0};
+
+WakeScheduler::WakeScheduler() : _ota(nullptr), _power(nullptr) {
+    setTimeServer(TIME_SYNC_DEFAULT_SERVER);
+}
+
+void WakeScheduler::setTimeServer(const char* server) {
+    if (server == nullptr || *server == '\0') {
+        server = TIME_SYNC_DEFAULT_SERVER;
+    }
+    strncpy(_timeServer, server, sizeof(_timeServer) - 1);
+    _timeServer[sizeof(_timeServer) - 1] = '\0';
+}
+
+bool WakeScheduler::clockValid() {
+    return time(nullptr) >= kMinValidEpoch;
+}
+
+const char* WakeScheduler::reasonName(WakeReason reason) {
+    switch (reason) {
+        case WAKE_REFRESH:   return "refresh";
+        case WAKE_OTA_CHECK: return "ota check";
+        case WAKE_TIME_SYNC: return "time sync";
+        default:             return "?";
+    }
+}
+
+void WakeScheduler::markDone(WakeReason reason) {
+    if (reason < WAKE_REASON_COUNT && clockValid()) {
+        s_lastRun[reason] = time(nullptr);
+    }
+}
+
+uint32_t WakeScheduler::secondsUntilDue(WakeReason reason) const {
+    if (reason == WAKE_OTA_CHECK) {
+        return _ota ? _ota->secondsUntilCheck() : UINT32_MAX;
+    }
+    if (reason != WAKE_TIME_SYNC) {
+        return UINT32_MAX;
+    }
+
+    uint32_t interval = TIME_SYNC_INTERVAL_SECONDS;
+    time_t now = time(nullptr);
+    if (now < kMinValidEpoch || s_lastRun[reason] == 0 || now < s_lastRun[reason]) {
+        return 0;
+    }
+    uint32_t elapsed = (uint32_t)(now - s_lastRun[reason]);
+    return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+bool WakeScheduler::isDue(WakeReason reason) const {
+    return secondsUntilDue(reason) == 0;
+}
+
+bool WakeScheduler::syncTimeIfDue() {
+    if (!isDue(WAKE_TIME_SYNC)) {
+        return true;
+    }
+    runTask(WAKE_TIME_SYNC);
+    return clockValid();
+}
+
+bool WakeScheduler::runTask(WakeReason reason) {
+    bool ok = false;
+    uint32_t startMs = millis();
+
+    if (reason == WAKE_TIME_SYNC) {
+        // Always sync in UTC; apps apply their own TZ rule for display. After deep sleep
+        // the RTC clock is already valid, so wait for SNTP itself to report a sync.
+        sntp_set_sync_status(SNTP_SYNC_STATUS_RESET);
+        configTime(0, 0, _timeServer);
+        for (int i = 0; i < 50 && !ok; i++) {
+            ok = sntp_get_sync_status() == SNTP_SYNC_STATUS_COMPLETED;
+            if (!ok) delay(100);
+        }
+    } else if (reason == WAKE_OTA_CHECK) {
+        // OTAManager keeps its own last-check time; an update restarts the device here
+        ok = _ota != nullptr;
+        if (ok) _ota->checkOnSchedule();
+    }
+
+    Serial.printf("[Scheduler] %s %s in %lu ms\n", reasonName(reason), ok ? "done" : "failed",
+                  (unsigned long)(millis() - startMs));
+    if (ok && reason != WAKE_OTA_CHECK) {
+        markDone(reason);
+    }
+    return ok;
+}
+
+void WakeScheduler::serviceRadioTasks() {
+    syncTimeIfDue();
+
+    if (_ota != nullptr && isDue(WAKE_OTA_CHECK)) {
+        runTask(WAKE_OTA_CHECK);
+    }
+}
+
+void WakeScheduler::sleep(const WakeRequest& request) {
+    uint32_t seconds = request.delaySeconds;
+    Serial.printf("[Scheduler] Next wake in %lus for %s%s", (unsigned long)seconds, reasonName(request.reason),
+                  request.needsRadio ? " (WiFi)" : "");
+    if (_ota != nullptr) {
+        Serial.printf(", OTA due in %lus", (unsigned long)secondsUntilDue(WAKE_OTA_CHECK));
+    }
+    Serial.printf(", time sync due in %lus\n", (unsigned long)secondsUntilDue(WAKE_TIME_SYNC));
+
+    if (_power) {
+        _power->enterDeepSleep(seconds);
+    } else {
+        delay(seconds * 1000UL);
+    }
+}
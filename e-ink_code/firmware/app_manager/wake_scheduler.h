@@ -0,0 +1,86 @@
+#ifndef WAKE_SCHEDULER_H
+#define WAKE_SCHEDULER_H
+
+#include <Arduino.h>
+#include "hardware_config.h"
+
+// NTP resync interval. The RTC keeps time across deep sleep but drifts, so apps that
+// stamp data (sensor → Nemo) resync when this is due instead of on every wake.
+#ifndef TIME_SYNC_INTERVAL_SECONDS
+#define TIME_SYNC_INTERVAL_SECONDS (6UL * 60UL * 60UL)
+#endif
+
+#ifndef TIME_SYNC_DEFAULT_SERVER
+#define TIME_SYNC_DEFAULT_SERVER "pool.ntp.org"
+#endif
+
+class OTAManager;
+class PowerManager;
+
+enum WakeReason : uint8_t {
+    WAKE_REFRESH = 0,   // the app's own display refresh
+    WAKE_OTA_CHECK,
+    WAKE_TIME_SYNC,
+    WAKE_REASON_COUNT
+};
+
+/**
+ * What an app wants after one run: sleep for delaySeconds, then run again for
+ * `reason`. needsRadio tells the scheduler whether that next run brings WiFi up,
+ * i.e. whether pending radio tasks can ride along with it.
+ */
+struct WakeRequest {
+    uint32_t delaySeconds;
+    WakeReason reason;
+    bool needsRadio;
+
+    static WakeRequest refresh(uint32_t seconds, bool radio) {
+        WakeRequest r = {seconds, WAKE_REFRESH, radio};
+        return r;
+    }
+};
+
+/**
+ * Owns deep-sleep decisions and the periodic radio work that is not a refresh.
+ *
+ * Radio tasks never get a wake of their own: OTA checks and NTP resyncs are
+ * opportunistic, and serviceRadioTasks() runs the ones that are due while an app
+ * already has WiFi up.
+ *
+ * Last-run times live in RTC memory; due times are wall-clock (time()), which
+ * keeps running across deep sleep. Until the clock is set every task is due.
+ */
+class WakeScheduler {
+public:
+    WakeScheduler();
+
+    void setOTAManager(OTAManager* ota) { _ota = ota; }
+    void setPowerManager(PowerManager* power) { _power = power; }
+    void setTimeServer(const char* server);
+
+    /** Mark a task done without the scheduler running it. */
+    void markDone(WakeReason reason);
+    bool isDue(WakeReason reason) const;
+    uint32_t secondsUntilDue(WakeReason reason) const;
+
+    /** NTP resync if due (or the clock is unset). Call once WiFi is up. Returns clock validity. */
+    bool syncTimeIfDue();
+
+    /** Run every radio task that is due. WiFi must be up. */
+    void serviceRadioTasks();
+
+    /** Log what is pending and enter deep sleep for the app's request. */
+    void sleep(const WakeRequest& request);
+
+    static bool clockValid();
+    static const char* reasonName(WakeReason reason);
+
+private:
+    bool runTask(WakeReason reason);
+
+    OTAManager* _ota;
+    PowerManager* _power;
+    char _timeServer[64];
+};
+
+#endif // WAKE_SCHEDULER_H
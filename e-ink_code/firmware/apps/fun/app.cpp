@@ -1,21 +1,31 @@
 #include "app.h"
 #include "config.h"
+#include "fact_packs.h"
 #include "fetch.h"
 #include "fun_slide.h"
 #include "render.h"
-#include "../../core/wifi/wifi_manager.h"
+#include "slide_queue.h"
 #include "../../core/display/display_manager.h"
-#include "../../core/power/power_manager.h"
-#include "../../core/ota/ota_manager.h"
 #include "../../core/bluetooth/cold_start_ble.h"
+#include "../../core/rtc/rtc_state_store.h"
+#include "../../app_manager/config_blob.h"
 #include <ArduinoJson.h>
 #include <Wire.h>
 
-RTC_DATA_ATTR int FunApp::displayMode = 0;
-
 FunApp::FunApp() {
 }
 
+FunRtcState& FunApp::state() {
+    if (_state == nullptr) {
+        _state = rtcState().slot<FunRtcState>(RTC_SLOT_FUN_APP, FUN_RTC_STATE_VERSION);
+        if (_state == nullptr) {
+            Serial.println("[FunApp] RTC state unavailable; display mode restarts each wake");
+            _state = &_volatileState;
+        }
+    }
+    return *_state;
+}
+
 bool FunApp::begin() {
     Serial.println("[FunApp] Starting Fun App");
 
@@ -69,185 +79,217 @@ bool FunApp::configure(const JsonObject& config) {
     return true;
 }
 
-void FunApp::loop() {
-    int batteryPercent = -1;
-    if (_power) {
-        batteryPercent = _power->getBatteryPercentage();
+size_t FunApp::saveSettings(uint8_t* buf, size_t cap) {
+    if (cap < sizeof(FunAppSettings)) {
+        return 0;
     }
+    FunAppSettings settings;
+    settings.version = FUN_APP_SETTINGS_VERSION;
+    settings.refreshIntervalMinutes = _refreshIntervalMinutes;
+    settings.apiRoomData = _apiRoomData;
+    settings.apiCatFacts = _apiCatFacts;
+    settings.apiEarthquake = _apiEarthquake;
+    settings.apiISS = _apiISS;
+    settings.apiUselessFacts = _apiUselessFacts;
+    settings.apiAllNewFacts = _apiAllNewFacts;
+    settings.apiSpecialMessages = _apiSpecialMessages;
+    memcpy(buf, &settings, sizeof(settings));
+    return sizeof(settings);
+}
 
+bool FunApp::loadSettings(const uint8_t* buf, size_t len) {
+    FunAppSettings settings;
+    if (len != sizeof(settings)) {
+        return false;
+    }
+    memcpy(&settings, buf, sizeof(settings));
+    if (settings.version != FUN_APP_SETTINGS_VERSION) {
+        return false;
+    }
+    _refreshIntervalMinutes = settings.refreshIntervalMinutes;
+    _apiRoomData = settings.apiRoomData;
+    _apiCatFacts = settings.apiCatFacts;
+    _apiEarthquake = settings.apiEarthquake;
+    _apiISS = settings.apiISS;
+    _apiUselessFacts = settings.apiUselessFacts;
+    _apiAllNewFacts = settings.apiAllNewFacts;
+    _apiSpecialMessages = settings.apiSpecialMessages;
+    return true;
+}
+
+bool FunApp::wantsNetwork() {
+    // Room data needs only the SHT31 (WiFi strength is cached). Fact modes run from the
+    // offline packs, else from the prefetched queue; WiFi comes up again to refill the
+    // queue or for the daily pack check (special messages are polled on those wakes).
+    // Earthquake / ISS slides are live.
+    if (packSyncDue()) {
+        return true;
+    }
+    int mode = resolveDisplayMode();
+    if (mode == 0) {
+        return roomRssiStale();
+    }
+    if (isFactMode(mode) && specialHoldRefreshCyclesRemaining() == 0 &&
+        (hasPackForMode(mode) || funQueueHasFresh(mode))) {
+        return false;
+    }
+    return true;
+}
+
+int FunApp::resolveDisplayMode() {
+    int& displayMode = state().displayMode;
     for (int i = 0; i < 5 && !isModeEnabled(displayMode); i++) {
         displayMode = (displayMode + 1) % 5;
     }
-
     applySpecialHoldDisplayMode(displayMode);
+    return displayMode;
+}
+
+void FunApp::acquire(AppCycle& cycle) {
+    int displayMode = resolveDisplayMode();
 
     Serial.printf("[FunApp] displayMode=%d (0=room, 1=quake, 2=cat/mixed, 3=ISS, 4=useless)\n",
                   displayMode);
 
-    if (displayMode == 0) {
-        if (_wifi) {
-            String wifiSSID = ColdStartBle::getStoredWiFiSSID();
-            String wifiPassword = ColdStartBle::getStoredWiFiPassword();
-
-            if (wifiSSID.length() > 0) {
-                Serial.print("[FunApp] Connecting to WiFi for room data display: ");
-                Serial.println(wifiSSID);
-                _wifi->begin(wifiSSID.c_str(), wifiPassword.c_str());
-            } else {
-                Serial.println("[FunApp] No WiFi credentials stored. Room data will display without WiFi strength.");
-            }
-        }
+    // Room data is mode 0 and the fallback for every other mode; read it once, while
+    // WiFi associates (if it is coming up at all)
+    _room = readRoomData();
+    Wire.end();
+    Serial.println("I2C disabled after sensor read");
 
-        String roomData = getRoomData();
-        if (_display) {
-            renderDefault(_display, roomData, batteryPercent);
-        }
+    _gotSlide = false;
+    _showedSpecial = false;
+}
 
-        if (_wifi) {
-            _wifi->disconnect();
-        }
-    } else {
-        FunSlide slide;
-        bool gotSlide = false;
-        bool showedSpecial = false;
-
-        if (_wifi) {
-            String wifiSSID = ColdStartBle::getStoredWiFiSSID();
-            String wifiPassword = ColdStartBle::getStoredWiFiPassword();
-
-            if (wifiSSID.length() > 0) {
-                Serial.print("[FunApp] Connecting to WiFi: ");
-                Serial.println(wifiSSID);
-                _wifi->begin(wifiSSID.c_str(), wifiPassword.c_str());
-            } else {
-                Serial.println("[FunApp] WARNING: No WiFi credentials stored. WiFi features disabled.");
-            }
-        }
+bool FunApp::packSyncDue() {
+    if (!FUN_FACT_PACKS || !(isModeEnabled(2) || isModeEnabled(4))) {
+        return false;
+    }
+    const FunRtcState& st = state();
+    uint32_t now = static_cast<uint32_t>(time(nullptr));
+    if (now < st.packSyncTry || now < st.packSyncOk) {
+        return true;  // clock went back (power loss); check again
+    }
+    bool stale = st.packSyncOk == 0 || now - st.packSyncOk >= FUN_PACK_SYNC_INTERVAL_HOURS * 3600UL;
+    bool retryAllowed = st.packSyncTry == 0 || now - st.packSyncTry >= FUN_PACK_RETRY_MINUTES * 60UL;
+    return stale && retryAllowed;
+}
 
-        if (_wifi && _wifi->isConnected()) {
-            handleOTA();
-
-            if (_apiSpecialMessages && displayMode >= 1 && displayMode <= 4) {
-                syncFunClockForSpecialHold();
-                if (loadHeldSpecialSlide(slide)) {
-                    gotSlide = true;
-                    showedSpecial = true;
-                }
-            }
-
-            bool gotViaSpecial =
-                (!gotSlide && _apiSpecialMessages && displayMode >= 1 && displayMode <= 4 &&
-                 (fetchSpecialSlide(slide, displayMode)));  // skips normal fetch if server had a queued slide
-
-            if (gotViaSpecial) {
-                gotSlide = true;
-                showedSpecial = true;
-            } else if (!gotSlide && displayMode == 1) {
-                gotSlide = fetchFunScreenSlide(1, slide);
-            } else if (!gotSlide && displayMode == 2) {
-                if (_apiAllNewFacts) {
-                    gotSlide = fetchMixedFunSlide(slide);
-                } else {
-                    gotSlide = fetchFunScreenSlide(2, slide);
-                }
-            } else if (!gotSlide && displayMode == 3) {
-                gotSlide = fetchFunScreenSlide(3, slide);
-            } else if (!gotSlide && displayMode == 4) {
-                gotSlide = fetchFunScreenSlide(4, slide);
-            }
-        }
+const char* FunApp::packIdForMode(int mode) const {
+    if (mode == 2) {
+        return _apiAllNewFacts ? nullptr : "cat_facts";
+    }
+    return "useless_facts";
+}
 
-        if (gotSlide && _display) {
-            Serial.printf("[FunApp] Rendering fun slide (%u chars, layout=%s)\n",
-                          static_cast<unsigned>(slide.text.length()), slide.layout.c_str());
-            renderFunSlide(_display, slide, batteryPercent);
-        } else {
-            Serial.println(
-                "[FunApp] No slide from server (WiFi down, fetch failed, or mode 0); showing room data...");
-            String roomData = getRoomData();
-            if (_display) {
-                renderDefault(_display, roomData, batteryPercent);
-            }
-        }
+bool FunApp::hasPackForMode(int mode) const {
+    const char* id = packIdForMode(mode);
+    if (id != nullptr) {
+        return factPackVersion(id) != 0;
+    }
+    FactPackInfo packs[1];
+    return factPackList(packs, 1) > 0;
+}
 
-        if (_wifi) {
-            _wifi->disconnect();
+bool FunApp::roomRssiStale() {
+    const FunRtcState& st = state();
+    uint32_t now = static_cast<uint32_t>(time(nullptr));
+    return st.lastRssi == 0 || now < st.rssiAt ||
+           now - st.rssiAt > FUN_ROOM_RSSI_MAX_AGE_HOURS * 3600UL;
+}
+
+void FunApp::fetch(AppCycle& cycle) {
+    // Cached for the room screen, which otherwise runs without the radio
+    state().lastRssi = static_cast<int8_t>(WiFi.RSSI());
+    state().rssiAt = static_cast<uint32_t>(time(nullptr));
+
+    if (packSyncDue()) {
+        state().packSyncTry = static_cast<uint32_t>(time(nullptr));
+        if (syncFactPacks()) {
+            state().packSyncOk = state().packSyncTry;
         }
+    }
+
+    const int displayMode = state().displayMode;
+    if (displayMode == 0) {
+        return;
+    }
 
-        if (showedSpecial) {
-            consumeSpecialHoldCycle();
+    if (_apiSpecialMessages && displayMode >= 1 && displayMode <= 4) {
+        syncFunClockForSpecialHold();
+        if (loadHeldSpecialSlide(_slide)) {
+            _gotSlide = true;
+            _showedSpecial = true;
         }
     }
 
-    Wire.end();
-    Serial.println("I2C disabled after sensor read");
+    bool gotViaSpecial =
+        (!_gotSlide && _apiSpecialMessages && displayMode >= 1 && displayMode <= 4 &&
+         (fetchSpecialSlide(_slide, displayMode)));  // skips normal fetch if server had a queued slide
+
+    if (gotViaSpecial) {
+        _gotSlide = true;
+        _showedSpecial = true;
+    } else if (!_gotSlide && displayMode == 1) {
+        _gotSlide = fetchFunScreenSlide(1, _slide);
+    } else if (!_gotSlide && isFactMode(displayMode)) {
+        // Shown from a pack or the queue in render(); the queue is only topped up
+        // while there is no pack for this mode
+        if (!hasPackForMode(displayMode) && funQueueNeedsRefill(displayMode)) {
+            refillFunSlideQueue(_apiAllNewFacts, isModeEnabled(2), isModeEnabled(4));
+        }
+    } else if (!_gotSlide && displayMode == 3) {
+        _gotSlide = fetchFunScreenSlide(3, _slide);
+    }
+}
 
-    if (_display) {
-        _display->disableSPI();
+void FunApp::render(AppCycle& cycle) {
+    if (!_display) {
+        return;
     }
 
-    if (specialHoldRefreshCyclesRemaining() == 0) {
-        cycleDisplayMode();
+    if (!_gotSlide && isFactMode(state().displayMode)) {
+        _gotSlide = factPackPick(packIdForMode(state().displayMode), _slide) ||
+                    funQueuePop(state().displayMode, _slide);
     }
 
-    if (_wifi && _wifi->isConnected()) {
-        handleOTA();
-
-        if (_ota && _ota->isUpdating()) {
-            Serial.println("[OTA] Update in progress, staying awake...");
-            while (_ota->isUpdating()) {
-                _ota->handle();
-                delay(100);
-            }
-            Serial.println("[OTA] Update complete, restarting...");
-            delay(1000);
-            ESP.restart();
-            return;
+    if (_gotSlide) {
+        Serial.printf("[FunApp] Rendering fun slide (%u chars, layout=%s)\n",
+                      static_cast<unsigned>(_slide.text.length()), _slide.layout.c_str());
+        renderFunSlide(_display, _slide, cycle.batteryPercent);
+    } else {
+        if (state().displayMode != 0) {
+            Serial.println("[FunApp] No slide from server (WiFi down or fetch failed); showing room data...");
         }
+        renderDefault(_display, formatRoomData(_room, state().lastRssi), cycle.batteryPercent);
     }
 
-    uint32_t sleepSeconds = _refreshIntervalMinutes * 60UL;
-    if (_power) {
-        Serial.print("[FunApp] Entering deep sleep for ");
-        Serial.print(_refreshIntervalMinutes);
-        Serial.println(" min");
-        _power->enterDeepSleep(sleepSeconds);
-    } else {
-        delay(sleepSeconds * 1000UL);
+    _display->disableSPI();
+}
+
+WakeRequest FunApp::finish(AppCycle& cycle) {
+    if (_showedSpecial) {
+        consumeSpecialHoldCycle();
     }
+
+    if (specialHoldRefreshCyclesRemaining() == 0) {
+        cycleDisplayMode();
+    }
+
+    // Tells the scheduler whether the next wake brings WiFi up (for radio tasks)
+    bool radioNext = ColdStartBle::getStoredWiFiSSID().length() > 0 && wantsNetwork();
+    return WakeRequest::refresh(_refreshIntervalMinutes * 60UL, radioNext);
 }
 
 void FunApp::end() {
     Serial.println("[FunApp] Ending Fun App");
 
-    if (_wifi) {
-        _wifi->disconnect();
-    }
-
     if (_display) {
         _display->hibernate();
         _display->disableSPI();
     }
 }
 
-void FunApp::handleOTA() {
-    if (!_ota || !_wifi || !_wifi->isConnected()) {
-        return;
-    }
-
-    _ota->setVersionCheckUrl(OTA_VERSION_CHECK_URL);
-    _ota->setRootCA(ROOT_CA_CERT);
-    _ota->setPassword(OTA_PASSWORD);
-    _ota->setCurrentVersion(FIRMWARE_VERSION);
-    _ota->begin();
-
-    _ota->handle();
-    if (_ota->checkForUpdate()) {
-        Serial.println("[FunApp] Update available, performing update...");
-        _ota->performUpdate();
-    }
-}
-
 bool FunApp::isModeEnabled(int mode) const {
     switch (mode) {
         case 0: return _apiRoomData;
@@ -260,6 +302,7 @@ bool FunApp::isModeEnabled(int mode) const {
 }
 
 void FunApp::cycleDisplayMode() {
+    int& displayMode = state().displayMode;
     for (int i = 0; i < 5; i++) {
         displayMode = (displayMode + 1) % 5;
         if (isModeEnabled(displayMode)) return;
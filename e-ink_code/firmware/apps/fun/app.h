@@ -2,6 +2,8 @@
 #define FUN_APP_H
 
 #include "../../app_manager/app_interface.h"
+#include "config.h"
+#include "fetch.h"
 
 class FunApp : public AppInterface {
 public:
@@ -10,20 +12,30 @@ public:
     
     // App lifecycle
     bool begin() override;
-    void loop() override;
     void end() override;
+
+    // Cycle phases
+    bool wantsNetwork() override;
+    void acquire(AppCycle& cycle) override;
+    void fetch(AppCycle& cycle) override;
+    void render(AppCycle& cycle) override;
+    WakeRequest finish(AppCycle& cycle) override;
     
     // App identification
     const char* getName() override { return "fun"; }
     
     // Configuration
     bool configure(const JsonObject& config) override;
+    void resetConfig() override { assignDefaults(*this); }
+    size_t saveSettings(uint8_t* buf, size_t cap) override;
+    bool loadSettings(const uint8_t* buf, size_t len) override;
 
 private:
-    // Display mode tracking (persists across deep sleep)
-    // 0=room_data, 1=earthquake, 2=cat_facts, 3=iss, 4=useless_facts
-    static RTC_DATA_ATTR int displayMode;
-    
+    // Display mode and other wake-to-wake state (RTC state store, survives deep sleep)
+    FunRtcState* _state = nullptr;
+    FunRtcState _volatileState;  // used if the RTC arena is full
+    FunRtcState& state();
+
     // Refresh interval in minutes (default: 2 minutes)
     uint32_t _refreshIntervalMinutes = 2;
     
@@ -36,10 +48,25 @@ private:
     bool _apiAllNewFacts = false;
     bool _apiSpecialMessages = true;
     
+    // Current cycle: room reading (acquire) and the server slide (fetch)
+    RoomReading _room;
+    FunSlide _slide;
+    bool _gotSlide = false;
+    bool _showedSpecial = false;
+
     // Helper methods
-    void handleOTA();
     void cycleDisplayMode();
     bool isModeEnabled(int mode) const;
+    static bool isFactMode(int mode) { return mode == 2 || mode == 4; }
+    /** Current mode, skipping disabled modes and pinned by a special-slide hold. */
+    int resolveDisplayMode();
+    /** Room mode brings WiFi up only to refresh a missing or old RSSI. */
+    bool roomRssiStale();
+    /** Fact pack manifest check due (daily; hourly retry after a failure). */
+    bool packSyncDue();
+    /** Offline pack for this fact mode: mode 2 = cat_facts (any pack when mixed), 4 = useless_facts. */
+    const char* packIdForMode(int mode) const;
+    bool hasPackForMode(int mode) const;
 };
 
 #endif // FUN_APP_H
@@ -4,5 +4,89 @@
 // Fun app configuration
 // Network and OTA constants are now in firmware/core/hardware_config.h
 #include "../../core/hardware_config.h"
+#include <stdint.h>
+
+// Compiled settings: refresh interval and the `apis` flags (0/1)
+#define FUN_APP_SETTINGS_VERSION 1
+
+struct __attribute__((packed)) FunAppSettings {
+    uint8_t version;
+    uint32_t refreshIntervalMinutes;
+    uint8_t apiRoomData;
+    uint8_t apiCatFacts;
+    uint8_t apiEarthquake;
+    uint8_t apiISS;
+    uint8_t apiUselessFacts;
+    uint8_t apiAllNewFacts;
+    uint8_t apiSpecialMessages;
+};
+
+// Wake-to-wake state in the RTC state store (RTC_SLOT_FUN_APP); bump on layout change
+#define FUN_RTC_STATE_VERSION 3
+
+// Room mode (0) runs without WiFi and shows the RSSI cached on the last WiFi wake.
+// It brings WiFi up itself only when that value is missing or older than this.
+#ifndef FUN_ROOM_RSSI_MAX_AGE_HOURS
+#define FUN_ROOM_RSSI_MAX_AGE_HOURS 24
+#endif
+
+// Room reading: up to this many SHT31 single-shot samples (~18 ms each) within the
+// budget, outliers dropped before averaging
+#ifndef FUN_ROOM_MAX_SAMPLES
+#define FUN_ROOM_MAX_SAMPLES 3
+#endif
+#ifndef FUN_ROOM_BUDGET_MS
+#define FUN_ROOM_BUDGET_MS 60
+#endif
+
+struct FunRtcState {
+    // 0=room_data, 1=earthquake, 2=cat_facts, 3=iss, 4=useless_facts
+    int displayMode = 0;
+    int8_t lastRssi = 0;   // dBm on the last WiFi wake (0 = none yet)
+    uint32_t rssiAt = 0;   // time() of lastRssi
+    uint32_t packSyncOk = 0;   // time() of the last complete fact pack sync (fact_packs.h)
+    uint32_t packSyncTry = 0;  // time() of the last attempt
+};
+
+// Special-slide hold (RTC_SLOT_FUN_HOLD). NVS namespace "fun_sp" is only the power-loss copy.
+#define FUN_HOLD_RTC_STATE_VERSION 1
+#ifndef FUN_HOLD_TEXT_MAX
+#define FUN_HOLD_TEXT_MAX 256  // longer texts stay in NVS and are read from there when shown
+#endif
+
+struct FunHoldRtcState {
+    bool loaded = false;     // mirrors NVS (read once after power loss or a firmware change)
+    bool inNvs = false;      // NVS holds a hold that must be cleared when this one ends
+    bool textInNvs = false;  // text did not fit below
+    uint8_t cycles = 0;      // wakes left; 0 = no hold
+    uint8_t mode = 0;        // display mode the slide was fetched for
+    uint32_t until = 0;      // optional UTC expiry
+    char layout[16] = "";
+    char text[FUN_HOLD_TEXT_MAX] = "";
+};
+
+// Prefetched fact slides (RTC_SLOT_FUN_QUEUE): modes 2 and 4 show one per wake and bring
+// WiFi up only to refill. Entries are packed back to back in data[] (see slide_queue.cpp).
+#define FUN_QUEUE_RTC_STATE_VERSION 1
+#ifndef FUN_QUEUE_BYTES
+#define FUN_QUEUE_BYTES 1024
+#endif
+#ifndef FUN_QUEUE_BATCH
+#define FUN_QUEUE_BATCH 6            // slides requested per enabled fact mode
+#endif
+#ifndef FUN_QUEUE_REFILL_AT
+#define FUN_QUEUE_REFILL_AT 1        // refill on a WiFi wake once a mode has this many left
+#endif
+#ifndef FUN_QUEUE_MAX_AGE_HOURS
+#define FUN_QUEUE_MAX_AGE_HOURS 24   // older batches are dropped and fetched again
+#endif
+
+struct FunQueueRtcState {
+    uint32_t fetchedAt = 0;  // time() of the batch
+    uint16_t used = 0;       // bytes of data[] in use
+    uint8_t count = 0;
+    uint8_t reserved = 0;
+    uint8_t data[FUN_QUEUE_BYTES] = {0};
+};
 
 #endif // FUN_APP_CONFIG_H
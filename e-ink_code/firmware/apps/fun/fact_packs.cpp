@@ -0,0 +1,256 @@
+#include "fact_packs.h"
+#include "../../core/storage/flash_fs.h"
+#include <FS.h>
+#include <LittleFS.h>
+#include <esp_random.h>
+#include "sdkconfig.h"
+
+#if CONFIG_IDF_TARGET_ESP32C3
+#include "esp32c3/rom/miniz.h"
+#elif CONFIG_IDF_TARGET_ESP32S3
+#include "esp32s3/rom/miniz.h"
+#else
+#include "rom/miniz.h"
+#endif
+
+bool factPacksMount() {
+#if FUN_FACT_PACKS
+    return flashFsMount(FUN_PACK_DIR);
+#else
+    return false;
+#endif
+}
+
+bool factPackIdValid(const char* id) {
+    if (id == nullptr) {
+        return false;
+    }
+    size_t len = strlen(id);
+    if (len == 0 || len > FUN_PACK_ID_MAX) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        char c = id[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static String packPath(const char* id, const char* suffix = ".pk") {
+    return String(FUN_PACK_DIR) + "/" + id + suffix;
+}
+
+static bool readHeader(File& file, FactPackHeader& header) {
+    if (file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    size_t indexEnd = sizeof(header) + (size_t)header.blockCount * sizeof(FactPackIndexEntry);
+    return memcmp(header.magic, FUN_PACK_MAGIC, 4) == 0 && header.version != 0 && header.factCount > 0 &&
+           header.factsPerBlock > 0 &&
+           (uint32_t)header.blockCount * header.factsPerBlock >= header.factCount && indexEnd <= file.size();
+}
+
+int factPackList(FactPackInfo* out, int max) {
+    if (!factPacksMount()) {
+        return 0;
+    }
+    File dir = LittleFS.open(FUN_PACK_DIR);
+    if (!dir || !dir.isDirectory()) {
+        return 0;
+    }
+    int count = 0;
+    for (File file = dir.openNextFile(); file && count < max; file = dir.openNextFile()) {
+        String name = file.name();
+        int slash = name.lastIndexOf('/');
+        if (slash >= 0) {
+            name = name.substring(slash + 1);
+        }
+        if (!name.endsWith(".pk")) {
+            continue;
+        }
+        name = name.substring(0, name.length() - 3);
+        FactPackHeader header;
+        if (!factPackIdValid(name.c_str()) || !readHeader(file, header)) {
+            continue;
+        }
+        strncpy(out[count].id, name.c_str(), FUN_PACK_ID_MAX);
+        out[count].id[FUN_PACK_ID_MAX] = '\0';
+        out[count].version = header.version;
+        out[count].factCount = header.factCount;
+        count++;
+    }
+    return count;
+}
+
+uint32_t factPackVersion(const char* id) {
+    if (!factPackIdValid(id) || !factPacksMount()) {
+        return 0;
+    }
+    String path = packPath(id);
+    if (!LittleFS.exists(path)) {
+        return 0;
+    }
+    File file = LittleFS.open(path, "r");
+    FactPackHeader header;
+    return (file && readHeader(file, header)) ? header.version : 0;
+}
+
+/** Inflate one zlib block into a buffer of exactly rawLen bytes (+ NUL). */
+static bool inflateBlock(const uint8_t* in, size_t inLen, uint8_t* out, size_t rawLen) {
+    tinfl_decompressor* decomp = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+    if (decomp == nullptr) {
+        return false;
+    }
+    tinfl_init(decomp);
+    size_t inBytes = inLen;
+    size_t outBytes = rawLen;
+    tinfl_status status = tinfl_decompress(decomp, in, &inBytes, out, out, &outBytes,
+                                           TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+    free(decomp);
+    return status == TINFL_STATUS_DONE && outBytes == rawLen;
+}
+
+static bool readFact(const char* id, uint32_t index, FunSlide& out) {
+    File file = LittleFS.open(packPath(id), "r");
+    FactPackHeader header;
+    if (!file || !readHeader(file, header) || index >= header.factCount) {
+        return false;
+    }
+
+    // O(1): one index entry, one block
+    uint32_t block = index / header.factsPerBlock;
+    uint32_t within = index % header.factsPerBlock;
+    FactPackIndexEntry entry;
+    if (!file.seek(sizeof(header) + block * sizeof(entry)) ||
+        file.read(reinterpret_cast<uint8_t*>(&entry), sizeof(entry)) != sizeof(entry) ||
+        entry.compressedLen == 0 || (size_t)entry.offset + entry.compressedLen > file.size()) {
+        Serial.printf("[FactPacks] %s: bad index entry %lu\n", id, (unsigned long)block);
+        return false;
+    }
+
+    uint8_t* compressed = static_cast<uint8_t*>(malloc(entry.compressedLen));
+    uint8_t* raw = static_cast<uint8_t*>(malloc((size_t)entry.rawLen + 1));
+    bool ok = compressed != nullptr && raw != nullptr && file.seek(entry.offset) &&
+              file.read(compressed, entry.compressedLen) == entry.compressedLen &&
+              inflateBlock(compressed, entry.compressedLen, raw, entry.rawLen);
+    free(compressed);
+    if (!ok) {
+        free(raw);
+        Serial.printf("[FactPacks] %s: block %lu unreadable\n", id, (unsigned long)block);
+        return false;
+    }
+    raw[entry.rawLen] = '\0';
+
+    const char* fact = reinterpret_cast<const char*>(raw);
+    const char* end = fact + entry.rawLen;
+    for (uint32_t i = 0; i < within && fact < end; i++) {
+        fact += strlen(fact) + 1;
+    }
+    ok = fact < end && *fact != '\0';
+    if (ok) {
+        char title[sizeof(header.title) + 1];
+        memcpy(title, header.title, sizeof(header.title));
+        title[sizeof(header.title)] = '\0';
+        out.layout = "default";
+        out.text = String(title) + "\n" + fact;
+        out.displayHoldUntilEpoch = 0;
+    }
+    free(raw);
+    return ok;
+}
+
+bool factPackPick(const char* id, FunSlide& out) {
+    FactPackInfo packs[FUN_PACK_MAX];
+    int count = factPackList(packs, FUN_PACK_MAX);
+    uint32_t total = 0;
+    for (int i = 0; i < count; i++) {
+        if (id == nullptr || strcmp(packs[i].id, id) == 0) {
+            total += packs[i].factCount;
+        }
+    }
+    if (total == 0) {
+        return false;
+    }
+
+    uint32_t pick = esp_random() % total;
+    for (int i = 0; i < count; i++) {
+        if (id != nullptr && strcmp(packs[i].id, id) != 0) {
+            continue;
+        }
+        if (pick < packs[i].factCount) {
+            uint32_t startMs = millis();
+            bool ok = readFact(packs[i].id, pick, out);
+            if (ok) {
+                Serial.printf("[FactPacks] %s fact %lu/%u in %lu ms\n", packs[i].id, (unsigned long)pick,
+                              packs[i].factCount, (unsigned long)(millis() - startMs));
+            }
+            return ok;
+        }
+        pick -= packs[i].factCount;
+    }
+    return false;
+}
+
+bool factPackInstall(const char* id, Stream& body, size_t length) {
+    if (!factPackIdValid(id) || !factPacksMount() || length < sizeof(FactPackHeader)) {
+        return false;
+    }
+    size_t freeBytes = LittleFS.totalBytes() - LittleFS.usedBytes();
+    size_t oldBytes = 0;
+    if (LittleFS.exists(packPath(id))) {
+        File old = LittleFS.open(packPath(id), "r");
+        oldBytes = old ? old.size() : 0;
+    }
+    if (length > freeBytes + oldBytes) {
+        Serial.printf("[FactPacks] %s: %u bytes do not fit\n", id, (unsigned)length);
+        return false;
+    }
+
+    String tmpPath = packPath(id, ".tmp");
+    File tmp = LittleFS.open(tmpPath, "w");
+    if (!tmp) {
+        return false;
+    }
+    uint8_t buf[512];
+    size_t written = 0;
+    uint32_t lastDataMs = millis();
+    while (written < length && millis() - lastDataMs < 5000) {
+        size_t want = length - written < sizeof(buf) ? length - written : sizeof(buf);
+        size_t got = body.readBytes(buf, want);
+        if (got == 0) {
+            delay(5);
+            continue;
+        }
+        lastDataMs = millis();
+        if (tmp.write(buf, got) != got) {
+            break;
+        }
+        written += got;
+    }
+    tmp.close();
+
+    // Only a complete file with a sane header replaces the installed pack
+    bool ok = written == length;
+    if (ok) {
+        File check = LittleFS.open(tmpPath, "r");
+        FactPackHeader header;
+        ok = check && readHeader(check, header);
+    }
+    if (!ok) {
+        Serial.printf("[FactPacks] %s: download incomplete or invalid (%u/%u bytes)\n", id, (unsigned)written,
+                      (unsigned)length);
+        LittleFS.remove(tmpPath);
+        return false;
+    }
+    LittleFS.remove(packPath(id));
+    return LittleFS.rename(tmpPath, packPath(id));
+}
+
+bool factPackRemove(const char* id) {
+    if (!factPackIdValid(id) || !factPacksMount()) {
+        return false;
+    }
+    return LittleFS.remove(packPath(id));
+}
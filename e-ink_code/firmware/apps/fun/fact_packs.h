@@ -0,0 +1,83 @@
+#ifndef FUN_FACT_PACKS_H
+#define FUN_FACT_PACKS_H
+
+#include "fun_slide.h"
+#include <Arduino.h>
+
+/**
+ * Offline fact packs in the LittleFS partition ("spiffs" in partitions.csv).
+ *
+ * One file per server fact pool, /packs/<id>.pk, in the layout built by
+ * server/fun_aggregator/fact_packs.py: header, one index entry per block, then
+ * zlib blocks of up to factsPerBlock NUL-separated facts. Picking a fact reads
+ * the header, one index entry and one block, so the cost does not grow with
+ * the pack. Packs are replaced whole by syncFactPacks() (fetch.cpp) when the
+ * server's version differs.
+ *
+ * Devices updated over OTA from a build without the partition have no
+ * filesystem; everything here then reports "no packs" and the fun app uses its
+ * RTC slide queue instead.
+ */
+
+#ifndef FUN_FACT_PACKS
+#define FUN_FACT_PACKS 1
+#endif
+
+#ifndef FUN_PACK_SYNC_INTERVAL_HOURS
+#define FUN_PACK_SYNC_INTERVAL_HOURS 24   // manifest check at most this often
+#endif
+#ifndef FUN_PACK_RETRY_MINUTES
+#define FUN_PACK_RETRY_MINUTES 60         // after a failed check
+#endif
+
+#define FUN_PACK_DIR       "/packs"
+#define FUN_PACK_MAX       8
+#define FUN_PACK_ID_MAX    24
+#define FUN_PACK_MAGIC     "EFP1"
+
+struct __attribute__((packed)) FactPackHeader {
+    char magic[4];
+    uint32_t version;
+    uint16_t factCount;
+    uint16_t blockCount;
+    uint16_t factsPerBlock;
+    uint16_t reserved;
+    char title[24];   // slide heading, UTF-8, NUL padded
+};
+
+struct __attribute__((packed)) FactPackIndexEntry {
+    uint32_t offset;          // from the start of the file
+    uint16_t compressedLen;
+    uint16_t rawLen;
+};
+
+struct FactPackInfo {
+    char id[FUN_PACK_ID_MAX + 1];
+    uint32_t version;
+    uint16_t factCount;
+};
+
+/** Mount the shared filesystem (flash_fs.h) with the pack directory. False when there is none. */
+bool factPacksMount();
+
+/** Installed packs with a valid header. Returns how many were written to out. */
+int factPackList(FactPackInfo* out, int max);
+
+/** Installed version of a pack, 0 when missing. */
+uint32_t factPackVersion(const char* id);
+
+/**
+ * Random fact as a slide ("<title>\n<fact>"). id nullptr picks across every pack,
+ * weighted by fact count (the "all new facts" mix).
+ */
+bool factPackPick(const char* id, FunSlide& out);
+
+/** Stream a downloaded pack to disk; it replaces the old file only once it checks out. */
+bool factPackInstall(const char* id, Stream& body, size_t length);
+
+bool factPackRemove(const char* id);
+
+/** Pool ids are file names: [a-z0-9_], 1..FUN_PACK_ID_MAX characters. */
+bool factPackIdValid(const char* id);
+
+#endif  // FUN_FACT_PACKS_H
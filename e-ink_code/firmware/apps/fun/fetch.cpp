@@ -1,7 +1,11 @@
 #include "fetch.h"
 #include "config.h"
+#include "fact_packs.h"
+#include "slide_queue.h"
 #include "../../core/bluetooth/cold_start_ble.h"
-#include <Adafruit_SHT31.h>
+#include "../../core/rtc/rtc_state_store.h"
+#include "../../core/sensor/sht31_engine.h"
+#include "../../app_manager/config_blob.h"
 #include <ArduinoJson.h>
 #include <Preferences.h>
 #include <WiFiClientSecure.h>
@@ -9,8 +13,6 @@
 #include <time.h>
 #include <cstring>
 
-Adafruit_SHT31 sht31 = Adafruit_SHT31();
-
 static constexpr time_t kMinValidUtcEpoch = 1577836800;
 
 static constexpr const char* kSpecialHoldNs = "fun_sp";
@@ -26,6 +28,9 @@ static bool utcClockProbablyValid() {
     return time(nullptr) > kMinValidUtcEpoch;
 }
 
+static FunHoldRtcState* s_hold = nullptr;
+static FunHoldRtcState s_volatileHold;  // RTC arena full: hold lasts one wake
+
 static void clearSpecialHoldPrefs() {
     Preferences prefs;
     if (prefs.begin(kSpecialHoldNs, false)) {
@@ -34,46 +39,89 @@ static void clearSpecialHoldPrefs() {
     }
 }
 
+static void setHoldText(FunHoldRtcState& hold, const String& text, const String& layout) {
+    hold.textInNvs = !packString(hold.text, text);
+    if (hold.textInNvs) {
+        hold.text[0] = '\0';
+    }
+    packString(hold.layout, layout);
+}
+
+/**
+ * Hold state for this wake. Comes from RTC memory; NVS is opened only when the RTC
+ * copy was lost (power loss, firmware change) to recover a hold that was in progress.
+ */
+static FunHoldRtcState& specialHold() {
+    if (s_hold == nullptr) {
+        s_hold = rtcState().slot<FunHoldRtcState>(RTC_SLOT_FUN_HOLD, FUN_HOLD_RTC_STATE_VERSION);
+        if (s_hold == nullptr) {
+            s_hold = &s_volatileHold;
+        }
+    }
+    FunHoldRtcState& hold = *s_hold;
+    if (hold.loaded) {
+        return hold;
+    }
+    hold.loaded = true;
+    Preferences prefs;
+    if (!prefs.begin(kSpecialHoldNs, true)) {
+        return hold;
+    }
+    hold.cycles = prefs.getUChar(kHoldKeyCycles, 0);
+    if (hold.cycles > 0) {
+        hold.mode = prefs.getUChar(kHoldKeyMode, 0);
+        hold.until = prefs.getUInt(kHoldKeyUntil, 0);
+        setHoldText(hold, prefs.getString(kHoldKeyText, ""), prefs.getString(kHoldKeyLayout, "default"));
+        hold.inNvs = true;
+        Serial.printf("[FunFetch] Special hold restored from NVS (%u wake(s) left)\n", hold.cycles);
+    }
+    prefs.end();
+    return hold;
+}
+
+static void clearSpecialHold() {
+    FunHoldRtcState& hold = specialHold();
+    bool inNvs = hold.inNvs;
+    hold = FunHoldRtcState();
+    hold.loaded = true;
+    if (inNvs) {
+        clearSpecialHoldPrefs();
+    }
+}
+
 static void persistSpecialHold(const FunSlide& slide, int displayMode) {
     if (slide.text.length() == 0) {
         return;
     }
+    FunHoldRtcState& hold = specialHold();
+    hold.cycles = kSpecialHoldRefreshCycles;
+    hold.mode = (displayMode >= 1 && displayMode <= 4) ? static_cast<uint8_t>(displayMode) : 0;
+    hold.until = slide.displayHoldUntilEpoch;
+    setHoldText(hold, slide.text, slide.layout.length() > 0 ? slide.layout : String("default"));
+
+    // One write per new special slide, so a power loss mid-hold does not drop it.
+    // Per-wake cycle countdown stays in RTC.
     Preferences prefs;
     if (!prefs.begin(kSpecialHoldNs, false)) {
         return;
     }
     prefs.putUChar(kHoldKeyCycles, kSpecialHoldRefreshCycles);
-    if (displayMode >= 1 && displayMode <= 4) {
-        prefs.putUChar(kHoldKeyMode, static_cast<uint8_t>(displayMode));
-    }
+    prefs.putUChar(kHoldKeyMode, hold.mode);
     prefs.putUInt(kHoldKeyUntil, slide.displayHoldUntilEpoch);
     prefs.putString(kHoldKeyText, slide.text);
     prefs.putString(kHoldKeyLayout, slide.layout.length() > 0 ? slide.layout : String("default"));
     prefs.end();
+    hold.inNvs = true;
 }
 
 uint8_t specialHoldRefreshCyclesRemaining() {
-    Preferences prefs;
-    if (!prefs.begin(kSpecialHoldNs, true)) {
-        return 0;
-    }
-    uint8_t cycles = prefs.getUChar(kHoldKeyCycles, 0);
-    prefs.end();
-    return cycles;
+    return specialHold().cycles;
 }
 
 void applySpecialHoldDisplayMode(int& displayMode) {
-    if (specialHoldRefreshCyclesRemaining() == 0) {
-        return;
-    }
-    Preferences prefs;
-    if (!prefs.begin(kSpecialHoldNs, true)) {
-        return;
-    }
-    int pinned = static_cast<int>(prefs.getUChar(kHoldKeyMode, 0));
-    prefs.end();
-    if (pinned >= 1 && pinned <= 4) {
-        displayMode = pinned;
+    FunHoldRtcState& hold = specialHold();
+    if (hold.cycles > 0 && hold.mode >= 1 && hold.mode <= 4) {
+        displayMode = hold.mode;
     }
 }
 
@@ -236,63 +284,61 @@ void syncFunClockForSpecialHold() {
 }
 
 bool loadHeldSpecialSlide(FunSlide& out) {
-    Preferences prefs;
-    if (!prefs.begin(kSpecialHoldNs, true)) {
+    FunHoldRtcState& hold = specialHold();
+    if (hold.cycles == 0) {
         return false;
     }
-    uint8_t cycles = prefs.getUChar(kHoldKeyCycles, 0);
-    uint32_t until = prefs.getUInt(kHoldKeyUntil, 0);
-    String txt = prefs.getString(kHoldKeyText, "");
-    String lay = prefs.getString(kHoldKeyLayout, "default");
-    prefs.end();
 
-    if (cycles == 0 || txt.length() == 0) {
-        return false;
-    }
-
-    if (until != 0) {
+    if (hold.until != 0) {
         if (!utcClockProbablyValid()) {
             return false;
         }
         uint32_t nowU = static_cast<uint32_t>(time(nullptr));
-        if (nowU >= until) {
-            clearSpecialHoldPrefs();
+        if (nowU >= hold.until) {
+            clearSpecialHold();
             return false;
         }
     }
 
+    String txt = hold.text;
+    if (hold.textInNvs) {
+        Preferences prefs;
+        if (prefs.begin(kSpecialHoldNs, true)) {
+            txt = prefs.getString(kHoldKeyText, "");
+            prefs.end();
+        }
+    }
+    if (txt.length() == 0) {
+        return false;
+    }
+
     out.text = txt;
-    out.layout = lay;
+    out.layout = hold.layout;
     out.layout.trim();
     out.layout.toLowerCase();
-    out.displayHoldUntilEpoch = until;
+    out.displayHoldUntilEpoch = hold.until;
     return true;
 }
 
 void consumeSpecialHoldCycle() {
-    Preferences prefs;
-    if (!prefs.begin(kSpecialHoldNs, false)) {
-        return;
-    }
-    uint8_t cycles = prefs.getUChar(kHoldKeyCycles, 0);
-    if (cycles == 0) {
-        prefs.end();
+    FunHoldRtcState& hold = specialHold();
+    if (hold.cycles == 0) {
         return;
     }
-    cycles--;
-    if (cycles == 0) {
-        prefs.end();
-        clearSpecialHoldPrefs();
-        return;
+    hold.cycles--;
+    if (hold.cycles == 0) {
+        // NVS still has the full count; a power loss before this replays the slide at most
+        // kSpecialHoldRefreshCycles times, which is harmless
+        clearSpecialHold();
     }
-    prefs.putUChar(kHoldKeyCycles, cycles);
-    prefs.end();
 }
 
 void initI2C() {
     Wire.begin(I2C_SDA, I2C_SCL);
 
-    if (!sht31.begin(0x44)) {
+    // The bus is released after each read, but the sensor's soft reset only needs
+    // doing once per boot (sht31Device().begin() remembers it)
+    if (!sht31Device().begin()) {
         Serial.println("SHT31 sensor initialization failed!");
     }
 }
@@ -349,21 +395,41 @@ bool fetchFunScreenSlide(int mode, FunSlide& out) {
     return ok;
 }
 
-bool fetchMixedFunSlide(FunSlide& out) {
+static size_t pushSlides(JsonArrayConst slides, size_t index, int mode) {
+    if (index >= slides.size()) {
+        return 0;
+    }
+    FunSlide slide;
+    if (!funSlideFromJson(slides[index].as<JsonObjectConst>(), slide)) {
+        return 0;
+    }
+    return funQueuePush(mode, slide) ? 1 : 0;
+}
+
+bool refillFunSlideQueue(bool mixed, bool cat, bool useless) {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("WiFi not connected!");
         return false;
     }
+    if (!mixed && !cat && !useless) {
+        return false;
+    }
 
     if (!ensureRegisteredWithFunServer()) {
-        Serial.println("[FunFetch] mixed: device registration failed");
+        Serial.println("[FunFetch] batch: device registration failed");
         return false;
     }
 
     HTTPClient http;
     WiFiClientSecure tls;
-    String url = String(FUN_FACTS_BASE_URL) + "/v1/fun/facts/mixed?count=1";
-    Serial.printf("[FunFetch] mixed: GET %s\n", url.c_str());
+    String url = String(FUN_FACTS_BASE_URL);
+    if (mixed) {
+        url += "/v1/fun/facts/mixed?count=" + String(FUN_QUEUE_BATCH);
+    } else {
+        url += "/v1/fun/facts/batch?count_cat=" + String(cat ? FUN_QUEUE_BATCH : 0) +
+               "&count_useless=" + String(useless ? FUN_QUEUE_BATCH : 0);
+    }
+    Serial.printf("[FunFetch] batch: GET %s\n", url.c_str());
     if (!beginFunHttp(http, url, &tls)) {
         return false;
     }
@@ -373,28 +439,115 @@ bool fetchMixedFunSlide(FunSlide& out) {
     String payload = http.getString();
     http.end();
     payload.trim();
-    logFunHttpBody("mixed", httpCode, payload);
+    logFunHttpBody("batch", httpCode, payload);
+    if (httpCode != HTTP_CODE_OK) {
+        return false;
+    }
 
-    if (httpCode <= 0) {
+    DynamicJsonDocument doc(12288);
+    DeserializationError error = deserializeJson(doc, payload);
+    if (error) {
+        Serial.print("[FunFetch] batch JSON error: ");
+        Serial.println(error.c_str());
+        return false;
+    }
+
+    // Mixed slides are shown in mode 2. Cat and useless are interleaved so both modes
+    // keep a share of the queue when it fills up.
+    JsonArrayConst mode2 = mixed ? doc["facts"].as<JsonArrayConst>() : doc["cat"].as<JsonArrayConst>();
+    JsonArrayConst mode4 = mixed ? JsonArrayConst() : doc["useless"].as<JsonArrayConst>();
+    if (mode2.size() == 0 && mode4.size() == 0) {
+        Serial.println("[FunFetch] batch: no slides in response");
+        return false;
+    }
+    funQueueReset();
+    size_t queued = 0;
+    size_t rows = mode2.size() > mode4.size() ? mode2.size() : mode4.size();
+    for (size_t i = 0; i < rows; i++) {
+        queued += pushSlides(mode2, i, 2);
+        queued += pushSlides(mode4, i, 4);
+    }
+    Serial.printf("[FunFetch] batch: queued %u slide(s) (mode 2: %u, mode 4: %u)\n",
+                  static_cast<unsigned>(queued), funQueueCount(2), funQueueCount(4));
+    return queued > 0;
+}
+
+bool syncFactPacks() {
+    if (WiFi.status() != WL_CONNECTED || !factPacksMount()) {
         return false;
     }
+    if (!ensureRegisteredWithFunServer()) {
+        Serial.println("[FunFetch] packs: device registration failed");
+        return false;
+    }
+
+    HTTPClient http;
+    WiFiClientSecure tls;
+    String base = String(FUN_FACTS_BASE_URL) + "/v1/fun/packs";
+    if (!beginFunHttp(http, base, &tls)) {
+        return false;
+    }
+    addFunHeaders(http);
+    int httpCode = http.GET();
+    String payload = http.getString();
+    http.end();
     if (httpCode != HTTP_CODE_OK) {
+        logFunHttpBody("packs", httpCode, payload);
         return false;
     }
 
-    DynamicJsonDocument doc(4096);
+    DynamicJsonDocument doc(2048);
     DeserializationError error = deserializeJson(doc, payload);
     if (error) {
-        Serial.print("[FunFetch] mixed JSON error: ");
+        Serial.print("[FunFetch] packs JSON error: ");
         Serial.println(error.c_str());
         return false;
     }
-    if (!doc.containsKey("facts") || !doc["facts"].is<JsonArray>() || doc["facts"].as<JsonArrayConst>().size() == 0) {
-        Serial.println("[FunFetch] mixed: empty or missing facts array");
-        return false;
+    JsonArrayConst packs = doc["packs"].as<JsonArrayConst>();
+
+    // Drop packs the server no longer offers before downloading, to make room
+    FactPackInfo local[FUN_PACK_MAX];
+    int localCount = factPackList(local, FUN_PACK_MAX);
+    for (int i = 0; i < localCount; i++) {
+        bool listed = false;
+        for (JsonObjectConst pack : packs) {
+            listed = listed || strcmp(local[i].id, pack["id"] | "") == 0;
+        }
+        if (!listed) {
+            Serial.printf("[FunFetch] packs: removing %s\n", local[i].id);
+            factPackRemove(local[i].id);
+        }
     }
-    JsonObjectConst first = doc["facts"][0].as<JsonObjectConst>();
-    return funSlideFromJson(first, out);
+
+    // Delta: only packs whose version changed
+    bool allOk = true;
+    size_t downloaded = 0;
+    for (JsonObjectConst pack : packs) {
+        const char* id = pack["id"] | "";
+        uint32_t version = pack["version"] | 0U;
+        if (!factPackIdValid(id) || version == 0 || factPackVersion(id) == version) {
+            continue;
+        }
+        HTTPClient packHttp;
+        WiFiClientSecure packTls;
+        if (!beginFunHttp(packHttp, base + "/" + id, &packTls)) {
+            allOk = false;
+            continue;
+        }
+        addFunHeaders(packHttp);
+        int code = packHttp.GET();
+        int length = packHttp.getSize();
+        bool ok = code == HTTP_CODE_OK && length > 0 &&
+                  factPackInstall(id, *packHttp.getStreamPtr(), static_cast<size_t>(length));
+        packHttp.end();
+        Serial.printf("[FunFetch] packs: %s v%lu (%d bytes) %s\n", id, (unsigned long)version, length,
+                      ok ? "installed" : "failed");
+        allOk = allOk && ok;
+        downloaded += ok ? 1 : 0;
+    }
+    Serial.printf("[FunFetch] packs: %u offered, %u downloaded\n", static_cast<unsigned>(packs.size()),
+                  static_cast<unsigned>(downloaded));
+    return allOk;
 }
 
 bool fetchSpecialSlide(FunSlide& out, int displayMode) {
@@ -453,18 +606,33 @@ bool fetchSpecialSlide(FunSlide& out, int displayMode) {
     return true;
 }
 
-String getRoomData() {
+RoomReading readRoomData() {
     initI2C();
 
-    float temperature = sht31.readTemperature();
-    temperature = temperature * 9.0 / 5.0 + 32.0;
-    float humidity = sht31.readHumidity();
+    Sht31AcquireConfig config;
+    config.minSamples = 1;
+    config.maxSamples = FUN_ROOM_MAX_SAMPLES;
+    config.budgetMs = FUN_ROOM_BUDGET_MS;
+    Sht31Result result;
+    RoomReading reading;
+    if (!sht31Device().acquire(config, result)) {
+        Serial.println("SHT31 read failed");
+        reading.temperatureF = NAN;
+        reading.humidity = NAN;
+        return reading;
+    }
+    reading.temperatureF = result.tempC * 9.0f / 5.0f + 32.0f;
+    reading.humidity = result.humidity;
+    return reading;
+}
+
+String formatRoomData(const RoomReading& reading, int rssiDbm) {
     String result = String("Room Temp & Humidity\n");
-    result += String("Temp: ") + String(temperature, 1) + "°F\n";
-    result += String("Humidity: ") + String(humidity, 1) + "%";
+    result += String("Temp: ") + String(reading.temperatureF, 1) + "°F\n";
+    result += String("Humidity: ") + String(reading.humidity, 1) + "%";
 
-    if (WiFi.status() == WL_CONNECTED) {
-        int rssi = WiFi.RSSI();
+    if (rssiDbm != 0) {
+        int rssi = rssiDbm;
         String strengthDesc;
         if (rssi > -50) {
             strengthDesc = "Excellent";
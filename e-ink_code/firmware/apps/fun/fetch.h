@@ -8,16 +8,33 @@
 #include <ArduinoJson.h>
 #include <time.h>
 
+struct RoomReading {
+    float temperatureF = 0.0f;
+    float humidity = 0.0f;
+};
+
 void initI2C();
-String getRoomData();
+/** Read the SHT31 (no radio needed; runs while WiFi associates). Initialises it once per boot. */
+RoomReading readRoomData();
+/** Room screen text; adds a WiFi strength line when rssiDbm is known (non-zero). */
+String formatRoomData(const RoomReading& reading, int rssiDbm);
 
 bool fetchFunScreenSlide(int mode, FunSlide& out);
-bool fetchMixedFunSlide(FunSlide& out);
+/**
+ * Refill the slide queue in one request: /v1/fun/facts/mixed when @p mixed, else
+ * /v1/fun/facts/batch for the enabled cat (mode 2) and useless (mode 4) slots.
+ */
+bool refillFunSlideQueue(bool mixed, bool cat, bool useless);
+/**
+ * Bring the offline fact packs in line with GET /v1/fun/packs: download packs whose
+ * version changed, delete ones no longer listed. False if anything failed (retry later).
+ */
+bool syncFactPacks();
 /** When the server has a queued slide for this device's X-Device-Id, fills ``out`` (dequeued). */
 bool fetchSpecialSlide(FunSlide& out, int displayMode);
 /** SNTP when clock looks unset; call before loadHeldSpecialSlide / populating hold deadline. */
 void syncFunClockForSpecialHold();
-/** Restore a queued special slide from NVS (refresh cycles remaining, optional expiry cap). */
+/** Restore a held special slide (RTC copy; NVS after power loss), honouring the optional expiry cap. */
 bool loadHeldSpecialSlide(FunSlide& out);
 /** Wakes left for the current special slide (0 if none). */
 uint8_t specialHoldRefreshCyclesRemaining();
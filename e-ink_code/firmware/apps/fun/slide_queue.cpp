@@ -0,0 +1,108 @@
+#include "slide_queue.h"
+#include "config.h"
+#include "../../core/rtc/rtc_state_store.h"
+#include <time.h>
+
+// Entry layout in FunQueueRtcState::data: mode, layout length, text length (LE16), layout, text
+static constexpr size_t kEntryHeader = 4;
+
+static FunQueueRtcState* s_queue = nullptr;
+static FunQueueRtcState s_volatileQueue;  // RTC arena full: queue lasts one wake
+
+static FunQueueRtcState& queue() {
+    if (s_queue == nullptr) {
+        s_queue = rtcState().slot<FunQueueRtcState>(RTC_SLOT_FUN_QUEUE, FUN_QUEUE_RTC_STATE_VERSION);
+        if (s_queue == nullptr) {
+            Serial.println("[FunQueue] RTC state unavailable; slides are not kept across wakes");
+            s_queue = &s_volatileQueue;
+        }
+    }
+    return *s_queue;
+}
+
+static size_t entrySize(const uint8_t* entry) {
+    return kEntryHeader + entry[1] + (entry[2] | (entry[3] << 8));
+}
+
+static bool isStale(const FunQueueRtcState& q) {
+    uint32_t now = static_cast<uint32_t>(time(nullptr));
+    // A clock set by NTP after the batch was fetched also counts as stale: refetch once
+    return q.count == 0 || now < q.fetchedAt || now - q.fetchedAt > FUN_QUEUE_MAX_AGE_HOURS * 3600UL;
+}
+
+uint8_t funQueueCount(int mode) {
+    FunQueueRtcState& q = queue();
+    uint8_t n = 0;
+    for (size_t offset = 0; offset < q.used; offset += entrySize(q.data + offset)) {
+        if (q.data[offset] == mode) {
+            n++;
+        }
+    }
+    return n;
+}
+
+bool funQueueHasFresh(int mode) {
+    return !isStale(queue()) && funQueueCount(mode) > 0;
+}
+
+bool funQueueNeedsRefill(int mode) {
+    return isStale(queue()) || funQueueCount(mode) <= FUN_QUEUE_REFILL_AT;
+}
+
+bool funQueuePop(int mode, FunSlide& out) {
+    FunQueueRtcState& q = queue();
+    if (isStale(q)) {
+        return false;
+    }
+    for (size_t offset = 0; offset < q.used;) {
+        uint8_t* entry = q.data + offset;
+        size_t size = entrySize(entry);
+        if (entry[0] != mode) {
+            offset += size;
+            continue;
+        }
+        uint8_t layoutLen = entry[1];
+        uint16_t textLen = entry[2] | (entry[3] << 8);
+        String layout, text;
+        layout.concat(reinterpret_cast<const char*>(entry + kEntryHeader), layoutLen);
+        text.concat(reinterpret_cast<const char*>(entry + kEntryHeader + layoutLen), textLen);
+
+        memmove(entry, entry + size, q.used - offset - size);
+        q.used -= size;
+        q.count--;
+
+        out.layout = layout.length() > 0 ? layout : String("default");
+        out.text = text;
+        out.displayHoldUntilEpoch = 0;
+        Serial.printf("[FunQueue] Mode %d slide from queue, %u left for this mode\n", mode,
+                      funQueueCount(mode));
+        return true;
+    }
+    return false;
+}
+
+void funQueueReset() {
+    FunQueueRtcState& q = queue();
+    q = FunQueueRtcState();
+    q.fetchedAt = static_cast<uint32_t>(time(nullptr));
+}
+
+bool funQueuePush(int mode, const FunSlide& slide) {
+    FunQueueRtcState& q = queue();
+    size_t layoutLen = slide.layout == "default" ? 0 : slide.layout.length();
+    size_t textLen = slide.text.length();
+    if (textLen == 0 || layoutLen > 255 || textLen > 0xFFFF || q.count == 255 ||
+        q.used + kEntryHeader + layoutLen + textLen > sizeof(q.data)) {
+        return false;
+    }
+    uint8_t* entry = q.data + q.used;
+    entry[0] = static_cast<uint8_t>(mode);
+    entry[1] = static_cast<uint8_t>(layoutLen);
+    entry[2] = static_cast<uint8_t>(textLen & 0xFF);
+    entry[3] = static_cast<uint8_t>(textLen >> 8);
+    memcpy(entry + kEntryHeader, slide.layout.c_str(), layoutLen);
+    memcpy(entry + kEntryHeader + layoutLen, slide.text.c_str(), textLen);
+    q.used += kEntryHeader + layoutLen + textLen;
+    q.count++;
+    return true;
+}
@@ -0,0 +1,25 @@
+#ifndef FUN_SLIDE_QUEUE_H
+#define FUN_SLIDE_QUEUE_H
+
+#include "fun_slide.h"
+
+/**
+ * Prefetched fact slides for modes 2 (cat / mixed) and 4 (useless), kept in RTC
+ * memory. One WiFi wake fetches a batch; later wakes pop one slide each without
+ * the radio until the mode runs low or the batch is FUN_QUEUE_MAX_AGE_HOURS old.
+ */
+
+/** A slide for this mode is queued and the batch is not stale. */
+bool funQueueHasFresh(int mode);
+/** Worth refilling on this (WiFi) wake: few slides left for the mode, or stale. */
+bool funQueueNeedsRefill(int mode);
+/** Take the oldest queued slide for the mode. */
+bool funQueuePop(int mode, FunSlide& out);
+uint8_t funQueueCount(int mode);
+
+/** Drop everything and start a new batch stamped with the current time. */
+void funQueueReset();
+/** Append to the current batch. Returns false when the slide does not fit. */
+bool funQueuePush(int mode, const FunSlide& slide);
+
+#endif  // FUN_SLIDE_QUEUE_H
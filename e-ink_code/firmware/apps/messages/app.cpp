@@ -1,8 +1,14 @@
 #include "app.h"
 #include "render.h"
 #include "config.h"
+#include "frames.h"
 #include "../../core/display/display_manager.h"
-#include "../../core/power/power_manager.h"
+#include "../../core/display/frame_canvas.h"
+#include "../../core/rtc/rtc_state_store.h"
+
+static MessagesRtcState* messagesRtcState() {
+    return rtcState().slot<MessagesRtcState>(RTC_SLOT_MESSAGES_APP, MESSAGES_RTC_STATE_VERSION);
+}
 
 MessagesApp::MessagesApp() {
     for (int i = 0; i < MESSAGES_APP_MAX_MESSAGES; i++) {
@@ -42,17 +48,90 @@ bool MessagesApp::configure(const JsonObject& config) {
     Serial.print("[MessagesApp] Refresh: ");
     Serial.print(_refreshIntervalMinutes);
     Serial.println(" min");
+
+    // Messages only change here, so lay them out now rather than on every wake
+    syncFrames();
+    return true;
+}
+
+size_t MessagesApp::saveSettings(uint8_t* buf, size_t cap) {
+    MessagesAppSettings settings;
+    settings.version = MESSAGES_APP_SETTINGS_VERSION;
+    settings.messageCount = (uint8_t)_messageCount;
+    settings.refreshIntervalMinutes = _refreshIntervalMinutes;
+    if (cap < sizeof(settings)) {
+        return 0;
+    }
+    memcpy(buf, &settings, sizeof(settings));
+    size_t pos = sizeof(settings);
+
+    for (int i = 0; i < _messageCount; i++) {
+        uint16_t len = (uint16_t)_messages[i].length();
+        if (pos + sizeof(len) + len > cap) {
+            Serial.println("[MessagesApp] Messages too long for compiled settings");
+            return 0;
+        }
+        memcpy(buf + pos, &len, sizeof(len));
+        pos += sizeof(len);
+        memcpy(buf + pos, _messages[i].c_str(), len);
+        pos += len;
+    }
+    return pos;
+}
+
+bool MessagesApp::loadSettings(const uint8_t* buf, size_t len) {
+    MessagesAppSettings settings;
+    if (len < sizeof(settings)) {
+        return false;
+    }
+    memcpy(&settings, buf, sizeof(settings));
+    if (settings.version != MESSAGES_APP_SETTINGS_VERSION ||
+        settings.messageCount > MESSAGES_APP_MAX_MESSAGES) {
+        return false;
+    }
+
+    String messages[MESSAGES_APP_MAX_MESSAGES];
+    size_t pos = sizeof(settings);
+    for (int i = 0; i < settings.messageCount; i++) {
+        uint16_t msgLen;
+        if (pos + sizeof(msgLen) > len) {
+            return false;
+        }
+        memcpy(&msgLen, buf + pos, sizeof(msgLen));
+        pos += sizeof(msgLen);
+        if (pos + msgLen > len) {
+            return false;
+        }
+        messages[i].reserve(msgLen);
+        for (uint16_t c = 0; c < msgLen; c++) {
+            messages[i] += (char)buf[pos + c];
+        }
+        pos += msgLen;
+    }
+
+    for (int i = 0; i < MESSAGES_APP_MAX_MESSAGES; i++) {
+        _messages[i] = messages[i];
+    }
+    _messageCount = settings.messageCount;
+    _refreshIntervalMinutes = settings.refreshIntervalMinutes;
     return true;
 }
 
 bool MessagesApp::begin() {
     Serial.println("[MessagesApp] Starting Messages App");
-    // Find the first non-empty message
-    _currentMessageIndex = 0;
-    for (int i = 0; i < _messageCount; i++) {
-        if (_messages[i].length() > 0) {
-            _currentMessageIndex = i;
-            break;
+    // Every wake is a fresh boot: resume the rotation where the last wake left it
+    MessagesRtcState* state = messagesRtcState();
+    if (state != nullptr && state->count == _messageCount && state->index < _messageCount &&
+        _messages[state->index].length() > 0) {
+        _currentMessageIndex = state->index;
+    } else {
+        // Find the first non-empty message
+        _currentMessageIndex = 0;
+        for (int i = 0; i < _messageCount; i++) {
+            if (_messages[i].length() > 0) {
+                _currentMessageIndex = i;
+                break;
+            }
         }
     }
 
@@ -64,7 +143,7 @@ bool MessagesApp::begin() {
 
 String MessagesApp::buildDisplayText() const {
     // Return the current message if it's not empty
-    if (_currentMessageIndex < _messageCount && _messages[_currentMessageIndex].length() > 0) {
+    if (hasCurrentMessage()) {
         return _messages[_currentMessageIndex];
     }
     
@@ -72,7 +151,50 @@ String MessagesApp::buildDisplayText() const {
     return "No messages configured.\nAdd messages via BLE config.";
 }
 
+bool MessagesApp::hasCurrentMessage() const {
+    return _currentMessageIndex < _messageCount && _messages[_currentMessageIndex].length() > 0;
+}
+
+void MessagesApp::syncFrames() {
+    FrameCanvas canvas;
+    if (!_display || !canvas.ok()) {
+        return;
+    }
+    for (int i = 0; i < _messageCount; i++) {
+        if (_messages[i].length() == 0) {
+            continue;
+        }
+        uint32_t signature = messageFrameSignature(_messages[i].c_str(), _messages[i].length());
+        if (!messageFrameHas(i, signature)) {
+            _display->renderTextOnlyFrame(canvas, _messages[i]);
+            messageFrameSave(i, signature, canvas);
+        }
+    }
+    messageFramesPrune(_messageCount);
+}
+
+bool MessagesApp::showFrame(const String& text, uint32_t signature, int batteryPercent) {
+    if (!hasCurrentMessage()) {
+        return false;
+    }
+    FrameCanvas canvas;
+    if (!canvas.ok()) {
+        return false;
+    }
+    if (!messageFrameLoad(_currentMessageIndex, signature, canvas)) {
+        // Missing or stale (e.g. settings from a compiled blob): render now, keep it for next time
+        Serial.println("[MessagesApp] No stored frame; rendering");
+        _display->renderTextOnlyFrame(canvas, text);
+        messageFrameSave(_currentMessageIndex, signature, canvas);
+    }
+    _display->displayFrame(canvas, batteryPercent);
+    return true;
+}
+
 void MessagesApp::advanceToNextMessage() {
+    if (_messageCount == 0) {
+        return;
+    }
     // Find the next non-empty message
     int startIndex = _currentMessageIndex;
     int attempts = 0;
@@ -90,35 +212,44 @@ void MessagesApp::advanceToNextMessage() {
     } while (_messages[_currentMessageIndex].length() == 0);
 }
 
-void MessagesApp::loop() {
-    int batteryPercent = -1;
-    if (_power) {
-        batteryPercent = _power->getBatteryPercentage();
-    }
-
+void MessagesApp::render(AppCycle& cycle) {
     // Display the current message
     String text = buildDisplayText();
+    uint32_t signature = messageFrameSignature(text.c_str(), text.length());
+    int battery = cycle.batteryPercent;
+
+    // Skip the panel refresh when it already shows this message and battery reading
+    if (_display &&
+        _display->shownPanel().unchanged(RTC_SLOT_MESSAGES_APP, signature, battery, MESSAGES_BATTERY_DEADBAND_PCT)) {
+        Serial.println("[MessagesApp] Message unchanged; panel kept");
+        _display->disableSPI();
+        return;
+    }
+
     if (_display) {
-        renderMessages(_display, text, batteryPercent);
+        // Stored frame first; direct layout when there is no message, memory or filesystem
+        if (!showFrame(text, signature, battery)) {
+            renderMessages(_display, text, battery);
+        }
+        _display->recordShownPanel(RTC_SLOT_MESSAGES_APP, signature, battery);
     }
 
     if (_display) {
         _display->disableSPI();
     }
+}
 
-    // Advance to the next message for next loop iteration
+WakeRequest MessagesApp::finish(AppCycle& cycle) {
+    // Advance to the next message for the next wake
     advanceToNextMessage();
-
-    // Sleep for the refresh interval before displaying next message
-    uint32_t sleepSeconds = _refreshIntervalMinutes * 60UL;
-    if (_power) {
-        Serial.print("[MessagesApp] Entering deep sleep for ");
-        Serial.print(_refreshIntervalMinutes);
-        Serial.println(" min");
-        _power->enterDeepSleep(sleepSeconds);
-    } else {
-        delay(sleepSeconds * 1000UL);
+    MessagesRtcState* state = messagesRtcState();
+    if (state != nullptr) {
+        state->index = static_cast<uint8_t>(_currentMessageIndex);
+        state->count = static_cast<uint8_t>(_messageCount);
     }
+
+    // Sleep for the refresh interval before displaying next message (never uses WiFi)
+    return WakeRequest::refresh(_refreshIntervalMinutes * 60UL, false);
 }
 
 void MessagesApp::end() {
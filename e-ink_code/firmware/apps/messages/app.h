@@ -10,12 +10,18 @@ public:
     virtual ~MessagesApp() {}
 
     bool begin() override;
-    void loop() override;
     void end() override;
 
+    // Cycle phases (never uses WiFi, so only render and finish)
+    void render(AppCycle& cycle) override;
+    WakeRequest finish(AppCycle& cycle) override;
+
     const char* getName() override { return "messages"; }
 
     bool configure(const JsonObject& config) override;
+    void resetConfig() override { assignDefaults(*this); }
+    size_t saveSettings(uint8_t* buf, size_t cap) override;
+    bool loadSettings(const uint8_t* buf, size_t len) override;
 
 private:
     String _messages[MESSAGES_APP_MAX_MESSAGES];
@@ -24,7 +30,12 @@ private:
     uint32_t _refreshIntervalMinutes = MESSAGES_APP_DEFAULT_REFRESH_MINUTES;
 
     String buildDisplayText() const;
+    bool hasCurrentMessage() const;
     void advanceToNextMessage();
+
+    // Pre-rendered frames (frames.h)
+    void syncFrames();
+    bool showFrame(const String& text, uint32_t signature, int batteryPercent);
 };
 
 #endif // MESSAGES_APP_H
@@ -6,4 +6,27 @@
 #define MESSAGES_APP_MAX_MESSAGES 10
 #define MESSAGES_APP_DEFAULT_REFRESH_MINUTES 5
 
+#include <stdint.h>
+
+// Compiled settings: this header, then `messageCount` entries of uint16 length + UTF-8 bytes
+#define MESSAGES_APP_SETTINGS_VERSION 1
+
+struct __attribute__((packed)) MessagesAppSettings {
+    uint8_t version;
+    uint8_t messageCount;
+    uint32_t refreshIntervalMinutes;
+};
+
+// Rotation position, kept across deep sleep in an RTC slot. What is on the panel is
+// DisplayManager's record (shown_panel.h), with messageFrameSignature() as the hash.
+#define MESSAGES_RTC_STATE_VERSION 3
+#ifndef MESSAGES_BATTERY_DEADBAND_PCT
+#define MESSAGES_BATTERY_DEADBAND_PCT 10  // battery change that redraws an unchanged message
+#endif
+
+struct MessagesRtcState {
+    uint8_t index = 0;              // message shown next
+    uint8_t count = 0;              // message count the index belongs to
+};
+
 #endif // MESSAGES_APP_CONFIG_H
@@ -0,0 +1,78 @@
+#include "frame_codec.h"
+#include "../../core/rtc/rtc_state_store.h"
+
+uint32_t messageFrameSignature(const char* text, size_t len) {
+    const uint8_t layout = MESSAGE_FRAME_LAYOUT;
+    uint32_t crc = RtcStateStore::crc32(0, &layout, 1);
+    crc = RtcStateStore::crc32(crc, reinterpret_cast<const uint8_t*>(text), len);
+    return crc != 0 ? crc : 1;  // 0 means "nothing shown"
+}
+
+// PackBits: control byte n = 0..127 copies n + 1 literal bytes; n = 129..255
+// repeats the next byte 257 - n times (2..128); 128 is a no-op. Runs of 3+ are
+// encoded as runs, so the output never exceeds messageFramePackBound().
+size_t messageFramePack(const uint8_t* in, size_t len, uint8_t* out, size_t cap) {
+    size_t o = 0;
+    size_t i = 0;
+    while (i < len) {
+        size_t run = 1;
+        while (i + run < len && run < 128 && in[i + run] == in[i]) {
+            run++;
+        }
+        if (run >= 3) {
+            if (o + 2 > cap) {
+                return 0;
+            }
+            out[o++] = static_cast<uint8_t>(257 - run);
+            out[o++] = in[i];
+            i += run;
+            continue;
+        }
+
+        // Literals up to the next run of 3+ (or 128 bytes); shorter runs cost less inline
+        size_t start = i;
+        size_t count = 0;
+        while (i < len && count < 128) {
+            if (count > 0 && i + 2 < len && in[i + 1] == in[i] && in[i + 2] == in[i]) {
+                break;
+            }
+            i++;
+            count++;
+        }
+        if (o + 1 + count > cap) {
+            return 0;
+        }
+        out[o++] = static_cast<uint8_t>(count - 1);
+        for (size_t k = 0; k < count; k++) {
+            out[o++] = in[start + k];
+        }
+    }
+    return o;
+}
+
+bool messageFrameUnpack(const uint8_t* in, size_t inLen, uint8_t* out, size_t outLen) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < inLen) {
+        uint8_t n = in[i++];
+        if (n < 128) {
+            size_t count = static_cast<size_t>(n) + 1;
+            if (i + count > inLen || o + count > outLen) {
+                return false;
+            }
+            for (size_t k = 0; k < count; k++) {
+                out[o++] = in[i++];
+            }
+        } else if (n > 128) {
+            size_t count = 257 - n;
+            if (i >= inLen || o + count > outLen) {
+                return false;
+            }
+            uint8_t value = in[i++];
+            for (size_t k = 0; k < count; k++) {
+                out[o++] = value;
+            }
+        }
+    }
+    return o == outLen;
+}
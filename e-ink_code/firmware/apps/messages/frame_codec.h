@@ -0,0 +1,47 @@
+#ifndef MESSAGES_FRAME_CODEC_H
+#define MESSAGES_FRAME_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * On-flash format of pre-rendered message frames.
+ *
+ * A frame is the panel's two native-orientation bitplanes (black and red, bit 0 =
+ * ink, as GxEPD2 writeImage() takes them), each PackBits-compressed, behind a small
+ * header. Text frames are mostly white, so a 2 x 4736-byte frame packs to a few
+ * hundred bytes.
+ *
+ * The signature ties a frame to the text it shows and to the layout it was drawn
+ * with (MESSAGE_FRAME_LAYOUT), so a reworded message or a layout change re-renders
+ * it, and the wake can compare it with what the panel already shows.
+ *
+ * Kept free of Arduino so it can be unit tested on the host (pio test -e native).
+ */
+
+#define MESSAGE_FRAME_MAGIC 0x31464D45u  // "EMF1"
+#define MESSAGE_FRAME_LAYOUT 1           // bump when the message layout changes
+
+struct __attribute__((packed)) MessageFrameHeader {
+    uint32_t magic;
+    uint32_t signature;   // messageFrameSignature() of the text drawn
+    uint16_t width;       // native panel size
+    uint16_t height;
+    uint16_t blackBytes;  // packed plane lengths; the payload is black then red
+    uint16_t redBytes;
+    uint32_t payloadCrc;  // CRC32 of the payload
+};
+
+/** Signature of a message: CRC32 over the layout version and the text. Never 0. */
+uint32_t messageFrameSignature(const char* text, size_t len);
+
+/** Worst-case packed size of len bytes. */
+inline size_t messageFramePackBound(size_t len) { return len + (len + 127) / 128; }
+
+/** PackBits-compress in into out. Returns the packed length, or 0 if cap is too small. */
+size_t messageFramePack(const uint8_t* in, size_t len, uint8_t* out, size_t cap);
+
+/** Unpack exactly outLen bytes from in (inLen bytes). False on malformed or short input. */
+bool messageFrameUnpack(const uint8_t* in, size_t inLen, uint8_t* out, size_t outLen);
+
+#endif // MESSAGES_FRAME_CODEC_H
@@ -0,0 +1,111 @@
+#include "frames.h"
+#include "config.h"
+#include "../../core/display/frame_canvas.h"
+#include "../../core/rtc/rtc_state_store.h"
+#include "../../core/storage/flash_fs.h"
+#include <FS.h>
+#include <LittleFS.h>
+
+static String framePath(int index, const char* suffix = ".frm") {
+    return String(MESSAGES_FRAME_DIR) + "/" + String(index) + suffix;
+}
+
+static bool readHeader(File& file, uint32_t signature, MessageFrameHeader& header) {
+    if (!file || file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    return header.magic == MESSAGE_FRAME_MAGIC && header.signature == signature &&
+           header.width == FrameCanvas::kWidth && header.height == FrameCanvas::kHeight &&
+           file.size() == sizeof(header) + header.blackBytes + header.redBytes;
+}
+
+bool messageFrameHas(int index, uint32_t signature) {
+    if (!flashFsMount(MESSAGES_FRAME_DIR) || !LittleFS.exists(framePath(index))) {
+        return false;
+    }
+    File file = LittleFS.open(framePath(index), "r");
+    MessageFrameHeader header;
+    return readHeader(file, signature, header);
+}
+
+bool messageFrameLoad(int index, uint32_t signature, FrameCanvas& canvas) {
+    if (!canvas.ok() || !flashFsMount(MESSAGES_FRAME_DIR) || !LittleFS.exists(framePath(index))) {
+        return false;
+    }
+    File file = LittleFS.open(framePath(index), "r");
+    MessageFrameHeader header;
+    if (!readHeader(file, signature, header)) {
+        return false;
+    }
+
+    size_t payloadBytes = header.blackBytes + header.redBytes;
+    uint8_t* payload = static_cast<uint8_t*>(malloc(payloadBytes));
+    if (payload == nullptr) {
+        return false;
+    }
+    bool ok = file.read(payload, payloadBytes) == payloadBytes &&
+              RtcStateStore::crc32(0, payload, payloadBytes) == header.payloadCrc &&
+              messageFrameUnpack(payload, header.blackBytes, canvas.black(), FrameCanvas::kPlaneBytes) &&
+              messageFrameUnpack(payload + header.blackBytes, header.redBytes, canvas.red(),
+                                 FrameCanvas::kPlaneBytes);
+    free(payload);
+    if (!ok) {
+        Serial.printf("[MessageFrames] Frame %d corrupt\n", index);
+    }
+    return ok;
+}
+
+bool messageFrameSave(int index, uint32_t signature, FrameCanvas& canvas) {
+    if (!canvas.ok() || !flashFsMount(MESSAGES_FRAME_DIR)) {
+        return false;
+    }
+    size_t bound = messageFramePackBound(FrameCanvas::kPlaneBytes);
+    uint8_t* payload = static_cast<uint8_t*>(malloc(2 * bound));
+    if (payload == nullptr) {
+        return false;
+    }
+
+    MessageFrameHeader header;
+    header.magic = MESSAGE_FRAME_MAGIC;
+    header.signature = signature;
+    header.width = FrameCanvas::kWidth;
+    header.height = FrameCanvas::kHeight;
+    size_t blackBytes = messageFramePack(canvas.black(), FrameCanvas::kPlaneBytes, payload, bound);
+    size_t redBytes = messageFramePack(canvas.red(), FrameCanvas::kPlaneBytes, payload + blackBytes, bound);
+    header.blackBytes = static_cast<uint16_t>(blackBytes);
+    header.redBytes = static_cast<uint16_t>(redBytes);
+    header.payloadCrc = RtcStateStore::crc32(0, payload, blackBytes + redBytes);
+
+    String tmpPath = framePath(index, ".tmp");
+    File tmp = LittleFS.open(tmpPath, "w");
+    bool ok = blackBytes > 0 && redBytes > 0 && tmp &&
+              tmp.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+              tmp.write(payload, blackBytes + redBytes) == blackBytes + redBytes;
+    if (tmp) {
+        tmp.close();
+    }
+    free(payload);
+    if (!ok) {
+        Serial.printf("[MessageFrames] Could not write frame %d\n", index);
+        LittleFS.remove(tmpPath);
+        return false;
+    }
+    LittleFS.remove(framePath(index));
+    if (!LittleFS.rename(tmpPath, framePath(index))) {
+        return false;
+    }
+    Serial.printf("[MessageFrames] Frame %d saved (%u bytes)\n", index,
+                  (unsigned)(sizeof(header) + blackBytes + redBytes));
+    return true;
+}
+
+void messageFramesPrune(int count) {
+    if (!flashFsMount(MESSAGES_FRAME_DIR)) {
+        return;
+    }
+    for (int i = count; i < MESSAGES_APP_MAX_MESSAGES; i++) {
+        if (LittleFS.exists(framePath(i))) {
+            LittleFS.remove(framePath(i));
+        }
+    }
+}
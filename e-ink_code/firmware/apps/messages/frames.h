@@ -0,0 +1,32 @@
+#ifndef MESSAGES_FRAMES_H
+#define MESSAGES_FRAMES_H
+
+#include <Arduino.h>
+#include "frame_codec.h"
+
+class FrameCanvas;
+
+/**
+ * Pre-rendered message frames in the LittleFS partition, one file per message
+ * slot: /msg/<index>.frm in the frame_codec.h format.
+ *
+ * Frames are written when the messages are configured (and re-written on a miss),
+ * so a wake only reads and unpacks ~1 KB instead of laying the text out again.
+ * Without a filesystem every call fails and the app renders directly.
+ */
+
+#define MESSAGES_FRAME_DIR "/msg"
+
+// True when slot index holds a valid header for this signature (payload not read)
+bool messageFrameHas(int index, uint32_t signature);
+
+// Unpack slot index into canvas. False if missing, stale or corrupt
+bool messageFrameLoad(int index, uint32_t signature, FrameCanvas& canvas);
+
+// Pack canvas into slot index (written to a temp file, then renamed into place)
+bool messageFrameSave(int index, uint32_t signature, FrameCanvas& canvas);
+
+// Remove frames for slots >= count
+void messageFramesPrune(int count);
+
+#endif // MESSAGES_FRAMES_H
@@ -2,12 +2,23 @@
 #include "fetch.h"
 #include "render.h"
 #include "../../core/display/display_manager.h"
-#include "../../core/power/power_manager.h"
 #include "../../core/bluetooth/cold_start_ble.h"
-#include "../../core/wifi/wifi_manager.h"
 #include "../../core/hardware_config.h"
+#include "../../core/rtc/rtc_state_store.h"
+#include "../../app_manager/config_blob.h"
 
 SensorApp::SensorApp() {
+    _repaint.tempDeadbandC = SENSOR_DEFAULT_TEMP_DEADBAND_C;
+    _repaint.humidityDeadband = SENSOR_DEFAULT_HUMIDITY_DEADBAND;
+    _repaint.batteryDeadband = SENSOR_BATTERY_DEADBAND_PCT;
+    _repaint.minIntervalSec = SENSOR_DEFAULT_MIN_REPAINT_MINUTES * 60UL;
+    _repaint.maxIntervalSec = SENSOR_DEFAULT_MAX_REPAINT_MINUTES * 60UL;
+}
+
+static char updatedTimeFromString(const String& value) {
+    if (value == "date") return SENSOR_UPDATED_DATE;
+    if (value == "off" || value == "none") return SENSOR_UPDATED_OFF;
+    return SENSOR_UPDATED_TIME;
 }
 
 static const char* tzRuleForSelection(const String& selection) {
@@ -111,6 +122,44 @@ bool SensorApp::configure(const JsonObject& config) {
     Serial.print("[SensorApp] Timezone selection: ");
     Serial.println(_timeZone.length() > 0 ? _timeZone : String(SENSOR_APP_DEFAULT_TIMEZONE));
 
+    // Repaint policy: the panel is only redrawn when a value visibly changes
+    if (config.containsKey("tempDeadbandC")) {
+        _repaint.tempDeadbandC = config["tempDeadbandC"].as<float>();
+    } else if (config.containsKey("temp_deadband_c")) {
+        _repaint.tempDeadbandC = config["temp_deadband_c"].as<float>();
+    }
+    if (config.containsKey("humidityDeadband")) {
+        _repaint.humidityDeadband = config["humidityDeadband"].as<float>();
+    } else if (config.containsKey("humidity_deadband")) {
+        _repaint.humidityDeadband = config["humidity_deadband"].as<float>();
+    }
+    if (config.containsKey("minRepaintMinutes")) {
+        _repaint.minIntervalSec = config["minRepaintMinutes"].as<uint32_t>() * 60UL;
+    } else if (config.containsKey("min_repaint_minutes")) {
+        _repaint.minIntervalSec = config["min_repaint_minutes"].as<uint32_t>() * 60UL;
+    }
+    if (config.containsKey("maxRepaintMinutes")) {
+        _repaint.maxIntervalSec = config["maxRepaintMinutes"].as<uint32_t>() * 60UL;
+    } else if (config.containsKey("max_repaint_minutes")) {
+        _repaint.maxIntervalSec = config["max_repaint_minutes"].as<uint32_t>() * 60UL;
+    }
+    if (_repaint.tempDeadbandC < 0.0f) _repaint.tempDeadbandC = 0.0f;
+    if (_repaint.humidityDeadband < 0.0f) _repaint.humidityDeadband = 0.0f;
+    if (config.containsKey("updatedTime")) {
+        _updatedTime = updatedTimeFromString(config["updatedTime"].as<String>());
+    } else if (config.containsKey("updated_time")) {
+        _updatedTime = updatedTimeFromString(config["updated_time"].as<String>());
+    }
+    if (config.containsKey("showHistory")) {
+        _showHistory = config["showHistory"].as<bool>();
+    } else if (config.containsKey("show_history")) {
+        _showHistory = config["show_history"].as<bool>();
+    }
+    Serial.printf("[SensorApp] Repaint: +/-%.2f C, +/-%.1f %%RH, every %lu-%lu min, updated=%c\n",
+                  _repaint.tempDeadbandC, _repaint.humidityDeadband,
+                  (unsigned long)(_repaint.minIntervalSec / 60), (unsigned long)(_repaint.maxIntervalSec / 60),
+                  _updatedTime);
+
     // Legacy config support (kept for backwards compatibility; no longer used for local time)
     if (config.containsKey("gmtOffsetSec")) _gmtOffsetSec = config["gmtOffsetSec"].as<long>();
     if (config.containsKey("daylightOffsetSec")) _daylightOffsetSec = config["daylightOffsetSec"].as<int>();
@@ -118,6 +167,72 @@ bool SensorApp::configure(const JsonObject& config) {
     return true;
 }
 
+size_t SensorApp::saveSettings(uint8_t* buf, size_t cap) {
+    if (cap < sizeof(SensorAppSettings)) {
+        return 0;
+    }
+    SensorAppSettings settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.version = SENSOR_APP_SETTINGS_VERSION;
+    settings.units = (_units == "C") ? 'C' : 'F';
+    settings.refreshIntervalMinutes = _refreshIntervalMinutes;
+    settings.gmtOffsetSec = _gmtOffsetSec;
+    settings.daylightOffsetSec = _daylightOffsetSec;
+    bool fits = packString(settings.nemoToken, _nemoToken) &&
+                packString(settings.nemoUrl, _nemoUrl) &&
+                packString(settings.temperatureSensorId, _temperatureSensorId) &&
+                packString(settings.humiditySensorId, _humiditySensorId) &&
+                packString(settings.batterySensorId, _batterySensorId) &&
+                packString(settings.timeServer, _timeServer) &&
+                packString(settings.timeZone, _timeZone) &&
+                packString(settings.sensorLocation, _sensorLocation) &&
+                _repaint.tempDeadbandC <= 655.0f && _repaint.humidityDeadband <= 655.0f &&
+                _repaint.minIntervalSec / 60 <= 0xFFFF && _repaint.maxIntervalSec / 60 <= 0xFFFF;
+    if (!fits) {
+        Serial.println("[SensorApp] Config value too long for compiled settings");
+        return 0;
+    }
+    settings.tempDeadbandCentiC = static_cast<uint16_t>(_repaint.tempDeadbandC * 100.0f + 0.5f);
+    settings.humidityDeadbandCenti = static_cast<uint16_t>(_repaint.humidityDeadband * 100.0f + 0.5f);
+    settings.minRepaintMinutes = static_cast<uint16_t>(_repaint.minIntervalSec / 60);
+    settings.maxRepaintMinutes = static_cast<uint16_t>(_repaint.maxIntervalSec / 60);
+    settings.updatedTime = _updatedTime;
+    settings.showHistory = _showHistory ? 1 : 0;
+    memcpy(buf, &settings, sizeof(settings));
+    return sizeof(settings);
+}
+
+bool SensorApp::loadSettings(const uint8_t* buf, size_t len) {
+    SensorAppSettings settings;
+    if (len != sizeof(settings)) {
+        return false;
+    }
+    memcpy(&settings, buf, sizeof(settings));
+    if (settings.version != SENSOR_APP_SETTINGS_VERSION) {
+        return false;
+    }
+    _units = (settings.units == 'C') ? "C" : "F";
+    _refreshIntervalMinutes = settings.refreshIntervalMinutes;
+    _gmtOffsetSec = settings.gmtOffsetSec;
+    _daylightOffsetSec = settings.daylightOffsetSec;
+    _nemoToken = unpackString(settings.nemoToken);
+    _nemoUrl = unpackString(settings.nemoUrl);
+    _temperatureSensorId = unpackString(settings.temperatureSensorId);
+    _humiditySensorId = unpackString(settings.humiditySensorId);
+    _batterySensorId = unpackString(settings.batterySensorId);
+    _timeServer = unpackString(settings.timeServer);
+    _timeZone = unpackString(settings.timeZone);
+    _tzRule = tzRuleForSelection(_timeZone);
+    _sensorLocation = unpackString(settings.sensorLocation);
+    _repaint.tempDeadbandC = settings.tempDeadbandCentiC / 100.0f;
+    _repaint.humidityDeadband = settings.humidityDeadbandCenti / 100.0f;
+    _repaint.minIntervalSec = settings.minRepaintMinutes * 60UL;
+    _repaint.maxIntervalSec = settings.maxRepaintMinutes * 60UL;
+    _updatedTime = settings.updatedTime;
+    _showHistory = settings.showHistory != 0;
+    return true;
+}
+
 bool SensorApp::begin() {
     Serial.println("[SensorApp] Starting Sensor App");
 
@@ -125,6 +240,11 @@ bool SensorApp::begin() {
         Serial.println("[SensorApp] SHT31 init failed; display will show error when fetching.");
     }
 
+    // AppManager resyncs the clock against this server when the scheduler says so
+    if (_scheduler) {
+        _scheduler->setTimeServer(_timeServer.c_str());
+    }
+
     if (_display) {
         _display->begin();
     }
@@ -132,61 +252,133 @@ bool SensorApp::begin() {
     return true;
 }
 
-void SensorApp::loop() {
+bool SensorApp::wantsNetwork() {
+    // WiFi shows signal strength and the time, and carries the Nemo upload
+    return true;
+}
+
+void SensorApp::acquire(AppCycle& cycle) {
+    // Register both RTC slots before publish() starts on its own task beside render():
+    // the store allocates without a lock, so only lookups may run concurrently
+    rtcState().slot<SensorRtcState>(RTC_SLOT_SENSOR_APP, SENSOR_RTC_STATE_VERSION);
+    rtcState().slot<SensorHistoryRtcState>(RTC_SLOT_SENSOR_HISTORY, SENSOR_HISTORY_RTC_STATE_VERSION);
+
     // Power on display and temperature sensor (MOSFET on pin 20; LOW = on)
     pinMode(POWER_DISPLAY_SENSOR_PIN, OUTPUT);
     digitalWrite(POWER_DISPLAY_SENSOR_PIN, LOW);
 
-    int batteryPercent = -1;
-    if (_power) {
-        batteryPercent = _power->getBatteryPercentage();
-    }
-
-    // Try to connect WiFi to show WiFi strength if available
-    // Also connect if we have Nemo config for posting data
-    bool wifiConnected = false;
-    bool timeSynced = false;
-    String lastUpdatedTime;
-    if (_wifi) {
-        String wifiSSID = ColdStartBle::getStoredWiFiSSID();
-        String wifiPassword = ColdStartBle::getStoredWiFiPassword();
-        if (wifiSSID.length() > 0) {
-            Serial.println("[SensorApp] WiFi connection requested");
-            wifiConnected = _wifi->begin(wifiSSID.c_str(), wifiPassword.c_str());
-            if (wifiConnected) {
-                Serial.println("[SensorApp] WiFi connection successful - ready for Nemo API calls");
-                setTimezoneRule(_tzRule.c_str());
-                Serial.print("[SensorApp] Time server: ");
-                Serial.println(_timeServer);
-                Serial.print("[SensorApp] TZ rule: ");
-                Serial.println(_tzRule);
-                timeSynced = syncTimeFromNtp(_timeServer.c_str());
-                if (timeSynced) {
-                    // Re-apply TZ after NTP sync; some ESP32 configTime() paths can leave TZ unapplied for the first time() use
-                    setTimezoneRule(_tzRule.c_str());
-                    lastUpdatedTime = getLocalTimeForDisplay("%m/%d %H:%M");
-                    Serial.print("[SensorApp] Time displayed on e-ink: ");
-                    Serial.println(lastUpdatedTime);
-                    time_t now = time(nullptr);
-                    Serial.print("[SensorApp] Epoch when building display time: ");
-                    Serial.println((long)now);
-                }
-            } else {
-                Serial.println("[SensorApp] WiFi connection failed - Nemo API calls will be skipped");
+    // Oversample once (single-shot reads, outliers dropped), then reuse for display and Nemo.
+    // Second read after display/SPI disable often fails (I2C -1), so keep a single acquisition phase.
+    _readOk = getAveragedSensorReadings(_tempC, _humidity);
+    _timeSynced = false;
+
+    // Local history for the sparkline; the RTC keeps the clock through deep sleep
+    if (_readOk && WakeScheduler::clockValid()) {
+        SensorHistoryRtcState* history =
+            rtcState().slot<SensorHistoryRtcState>(RTC_SLOT_SENSOR_HISTORY, SENSOR_HISTORY_RTC_STATE_VERSION);
+        if (history != nullptr) {
+            sensorHistoryAdd(*history, static_cast<uint32_t>(time(nullptr)), _tempC, _humidity);
+            SensorHistorySummary temp;
+            if (sensorHistorySummary(history->temp, temp)) {
+                Serial.printf("[SensorApp] History: %u buckets, %.2f..%.2f C, mean %.2f C, %+.2f C/h\n",
+                              temp.buckets, temp.min, temp.max, temp.mean, temp.slopePerHour);
             }
-        } else {
-            Serial.println("[SensorApp] No WiFi credentials stored. Sensor data will display without WiFi strength.");
         }
     }
+    _lastUpdatedTime = "";
+}
 
-    // Average multiple I2C reads once, then reuse for display and Nemo.
-    // Second read after display/SPI disable often fails (I2C -1), so keep a single acquisition phase.
+void SensorApp::fetch(AppCycle& cycle) {
+    Serial.println("[SensorApp] WiFi connection successful - ready for Nemo API calls");
+    setTimezoneRule(_tzRule.c_str());
+    Serial.print("[SensorApp] Time server: ");
+    Serial.println(_timeServer);
+    Serial.print("[SensorApp] TZ rule: ");
+    Serial.println(_tzRule);
+
+    // AppManager already ran the scheduler's NTP resync if it was due
+    _timeSynced = WakeScheduler::clockValid();
+    if (_timeSynced) {
+        // Re-apply TZ after NTP sync; some ESP32 configTime() paths can leave TZ unapplied for the first time() use
+        setTimezoneRule(_tzRule.c_str());
+        _lastUpdatedTime = getLocalTimeForDisplay(_updatedTime == SENSOR_UPDATED_DATE ? "%m/%d" : "%m/%d %H:%M");
+        Serial.print("[SensorApp] Time displayed on e-ink: ");
+        Serial.println(_lastUpdatedTime);
+        time_t now = time(nullptr);
+        Serial.print("[SensorApp] Epoch when building display time: ");
+        Serial.println((long)now);
+    }
+}
+
+String SensorApp::historyCaption(const SensorHistoryRtcState& history, bool useCelsius) const {
+    SensorHistorySummary temp;
+    if (!sensorHistorySummary(history.temp, temp) || temp.buckets < 2) {
+        return String();
+    }
+    float scale = useCelsius ? 1.0f : 9.0f / 5.0f;
+    float offset = useCelsius ? 0.0f : 32.0f;
+    String caption = String(SENSOR_HISTORY_BUCKETS * SENSOR_HISTORY_BUCKET_SEC / 3600) + "h " +
+                     String(temp.min * scale + offset, 1) + "-" + String(temp.max * scale + offset, 1) +
+                     (useCelsius ? "C" : "F");
+    if (temp.hasSlope) {
+        float slope = temp.slopePerHour * scale;
+        caption += String(slope >= 0.0f ? " +" : " ") + String(slope, 1) + "/h";
+    }
+    SensorHistorySummary humidity;
+    if (sensorHistorySummary(history.humidity, humidity)) {
+        caption += " RH " + String(humidity.min, 0) + "-" + String(humidity.max, 0) + "%";
+    }
+    return caption;
+}
+
+void SensorApp::render(AppCycle& cycle) {
     bool useCelsius = (_units == "C");
-    float tempC = 0.0f;
-    float humidity = 0.0f;
-    bool readOk = getAveragedSensorReadings(tempC, humidity, 5);
-    String sensorData = readOk
-        ? formatSensorDataForDisplay(tempC, humidity, useCelsius, wifiConnected, lastUpdatedTime)
+
+    // Sparkline band once the local history has two buckets
+    SensorHistoryRtcState* history =
+        _showHistory && _readOk
+            ? rtcState().slot<SensorHistoryRtcState>(RTC_SLOT_SENSOR_HISTORY, SENSOR_HISTORY_RTC_STATE_VERSION)
+            : nullptr;
+    String caption = history != nullptr ? historyCaption(*history, useCelsius) : String();
+    bool trend = caption.length() > 0;
+
+    // Skip the ~15 s refresh when nothing on screen would visibly change
+    SensorFrame frame;
+    frame.readOk = _readOk;
+    frame.wifiShown = cycle.wifiConnected;
+    frame.batteryPercent = cycle.batteryPercent;
+    frame.tempC = _tempC;
+    frame.humidity = _humidity;
+    frame.now = static_cast<uint32_t>(time(nullptr));
+    frame.layoutHash = sensorLayoutHash(_units.c_str());
+    frame.layoutHash = sensorLayoutHash(_sensorLocation.c_str(), frame.layoutHash);
+    char policy[3] = {_updatedTime, trend ? 'H' : '-', '\0'};
+    frame.layoutHash = sensorLayoutHash(policy, frame.layoutHash);
+    if (_updatedTime == SENSOR_UPDATED_DATE) {
+        frame.layoutHash = sensorLayoutHash(_lastUpdatedTime.c_str(), frame.layoutHash);
+    }
+
+    // The frame is only what this app last drew; any other draw since then invalidates it
+    SensorRtcState* state = rtcState().slot<SensorRtcState>(RTC_SLOT_SENSOR_APP, SENSOR_RTC_STATE_VERSION);
+    if (state != nullptr && _display && !_display->shownPanel().ownedBy(RTC_SLOT_SENSOR_APP)) {
+        state->shown.valid = false;
+    }
+    SensorRepaint reason = state != nullptr ? sensorRepaintDecision(_repaint, state->shown, frame)
+                                            : SensorRepaint::FirstPaint;
+    if (reason == SensorRepaint::Skip) {
+        Serial.printf("[SensorApp] Panel kept (%.2f C, %.1f %%RH within deadband, painted %lus ago)\n", _tempC,
+                      _humidity, (unsigned long)(frame.now - state->shown.paintedAt));
+        if (_display) {
+            _display->disableSPI();
+        }
+        return;
+    }
+    Serial.printf("[SensorApp] Repainting: %s\n", sensorRepaintName(reason));
+
+    // The trend layout has room for three text lines; the update time moves into the band caption
+    String sensorData = _readOk
+        ? formatSensorDataForDisplay(_tempC, _humidity, useCelsius, cycle.wifiConnected && !trend,
+                                     _lastUpdatedTime, _updatedTime != SENSOR_UPDATED_OFF)
         : "Sensor Error\nRead failed";
 
     // When location is set, use it as the red header line; otherwise use default title
@@ -197,53 +389,60 @@ void SensorApp::loop() {
     }
 
     if (_display) {
-        renderSensorData(_display, sensorData, batteryPercent);
+        if (trend) {
+            int16_t points[SENSOR_HISTORY_BUCKETS + 1];
+            int count = sensorHistoryPoints(*history, history->temp, points, SENSOR_HISTORY_BUCKETS + 1);
+            String updated = (cycle.wifiConnected && _updatedTime != SENSOR_UPDATED_OFF) ? _lastUpdatedTime : "";
+            renderSensorTrend(_display, sensorData, points, count, caption, updated, cycle.batteryPercent);
+        } else {
+            renderSensorData(_display, sensorData, cycle.batteryPercent);
+        }
+        _display->recordShownPanel(RTC_SLOT_SENSOR_APP, frame.layoutHash, cycle.batteryPercent);
+        if (state != nullptr) {
+            sensorRepaintRecord(state->shown, frame);
+        }
     }
     if (_display) {
         _display->disableSPI();
     }
+}
 
-    // Optionally POST to Nemo using the same readings (no second I2C read)
-    if (_nemoToken.length() > 0 && _nemoUrl.length() > 0) {
-        if (!readOk) {
-            Serial.println("[SensorApp] Nemo POST skipped: sensor read failed earlier");
-        } else if (!wifiConnected) {
-            Serial.println("[SensorApp] Nemo POST skipped: WiFi required for time sync and upload");
-        } else {
-            setTimezoneRule(_tzRule.c_str());
-            if (!timeSynced && !syncTimeFromNtp(_timeServer.c_str())) {
-                Serial.println("[SensorApp] Time sync failed before Nemo POST");
-            } else {
-                String createdDate = getIso8601CreatedDate();
-                if (createdDate.length() > 0) {
-                    Serial.println("[SensorApp] Nemo POST: calling postSensorDataToNemo");
-                    postSensorDataToNemo(_nemoUrl.c_str(), _nemoToken.c_str(),
-                                        _temperatureSensorId.c_str(), _humiditySensorId.c_str(), _batterySensorId.c_str(),
-                                        tempC, humidity, batteryPercent, createdDate.c_str());
-                } else {
-                    Serial.println("[SensorApp] Nemo POST skipped: could not get time for created_date");
-                }
-            }
-        }
+void SensorApp::publish(AppCycle& cycle) {
+    // POST to Nemo using the same readings (no second I2C read)
+    if (_nemoToken.length() == 0 || _nemoUrl.length() == 0) {
+        return;
     }
-
-    // Disable WiFi after displaying and posting to save power
-    if (_wifi) {
-        _wifi->disconnect();
+    if (!_readOk) {
+        Serial.println("[SensorApp] Nemo POST skipped: sensor read failed earlier");
+        return;
     }
 
-    // Enter deep sleep until next cycle (or delay if no power manager)
-    uint32_t sleepSeconds = _refreshIntervalMinutes * 60UL;
-    if (_power) {
-        Serial.print("[SensorApp] Entering deep sleep for ");
-        Serial.print(_refreshIntervalMinutes);
-        Serial.println(" min");
-        _power->enterDeepSleep(sleepSeconds);
+    if (!_timeSynced && !syncTimeFromNtp(_timeServer.c_str())) {
+        Serial.println("[SensorApp] Time sync failed before Nemo POST");
+        return;
+    }
+    setTimezoneRule(_tzRule.c_str());
+    String createdDate = getIso8601CreatedDate();
+    if (createdDate.length() > 0) {
+        Serial.println("[SensorApp] Nemo POST: calling postSensorDataToNemo");
+        postSensorDataToNemo(_nemoUrl.c_str(), _nemoToken.c_str(),
+                            _temperatureSensorId.c_str(), _humiditySensorId.c_str(), _batterySensorId.c_str(),
+                            _tempC, _humidity, cycle.batteryPercent, createdDate.c_str());
     } else {
-        delay(sleepSeconds * 1000UL);
+        Serial.println("[SensorApp] Nemo POST skipped: could not get time for created_date");
     }
 }
 
+WakeRequest SensorApp::finish(AppCycle& cycle) {
+    if (!cycle.wifiConnected && _nemoToken.length() > 0 && _nemoUrl.length() > 0) {
+        Serial.println("[SensorApp] Nemo POST skipped: WiFi required for time sync and upload");
+    }
+
+    // Sleep until next cycle; WiFi comes up again whenever credentials are stored
+    bool radioNext = ColdStartBle::getStoredWiFiSSID().length() > 0;
+    return WakeRequest::refresh(_refreshIntervalMinutes * 60UL, radioNext);
+}
+
 void SensorApp::end() {
     Serial.println("[SensorApp] Ending Sensor App");
 
@@ -11,14 +11,24 @@ public:
 
     // App lifecycle
     bool begin() override;
-    void loop() override;
     void end() override;
 
+    // Cycle phases: read the SHT31 while WiFi associates, post to Nemo while rendering
+    bool wantsNetwork() override;
+    void acquire(AppCycle& cycle) override;
+    void fetch(AppCycle& cycle) override;
+    void render(AppCycle& cycle) override;
+    void publish(AppCycle& cycle) override;
+    WakeRequest finish(AppCycle& cycle) override;
+
     // App identification
     const char* getName() override { return "sensor"; }
 
     // Configuration (via BLE: units, wifi, nemo token/url, refresh interval, sensor ID)
     bool configure(const JsonObject& config) override;
+    void resetConfig() override { assignDefaults(*this); }
+    size_t saveSettings(uint8_t* buf, size_t cap) override;
+    bool loadSettings(const uint8_t* buf, size_t len) override;
 
 private:
     // Display units: "C" or "F" (default F)
@@ -44,6 +54,21 @@ private:
 
     // Display: header line shown in red (e.g. "Gowning Room")
     String _sensorLocation;
+
+    // Repaint policy: deadbands and min/max repaint interval (see repaint_policy.h)
+    SensorRepaintPolicy _repaint;
+    char _updatedTime = SENSOR_UPDATED_TIME;
+    bool _showHistory = SENSOR_DEFAULT_SHOW_HISTORY;
+
+    // Current cycle: one averaged reading shared by display and Nemo
+    float _tempC = 0.0f;
+    float _humidity = 0.0f;
+    bool _readOk = false;
+    bool _timeSynced = false;
+    String _lastUpdatedTime;
+
+    /** Sparkline caption from the local history; empty when there is not enough of it yet. */
+    String historyCaption(const SensorHistoryRtcState& history, bool useCelsius) const;
 };
 
 #endif // SENSOR_APP_H
@@ -2,9 +2,20 @@
 #define SENSOR_APP_CONFIG_H
 
 #include "../../core/hardware_config.h"
+#include "history.h"
+#include "repaint_policy.h"
 
-// SHT31 I2C address (default)
-#define SHT31_I2C_ADDR 0x44
+// SHT31 oversampling per wake (single-shot, ~18 ms each): at least MIN samples, more while
+// the next one fits the budget, up to MAX; outliers are dropped before averaging
+#ifndef SENSOR_SHT31_MIN_SAMPLES
+#define SENSOR_SHT31_MIN_SAMPLES 3
+#endif
+#ifndef SENSOR_SHT31_MAX_SAMPLES
+#define SENSOR_SHT31_MAX_SAMPLES 8
+#endif
+#ifndef SENSOR_SHT31_BUDGET_MS
+#define SENSOR_SHT31_BUDGET_MS 150
+#endif
 
 // Default Nemo API endpoint
 #define SENSOR_APP_DEFAULT_NEMO_URL "https://nemo.stanford.edu/api/sensors/sensor_data/"
@@ -34,4 +45,67 @@
 #define SENSOR_APP_DEFAULT_TIMEZONE SENSOR_APP_TIMEZONE_PACIFIC
 #define SENSOR_APP_DEFAULT_TZ_RULE SENSOR_APP_TZ_RULE_PACIFIC
 
+// Repaint policy defaults (config keys tempDeadbandC, humidityDeadband, minRepaintMinutes,
+// maxRepaintMinutes, updatedTime). A deadband of 0 repaints on every wake.
+#ifndef SENSOR_DEFAULT_TEMP_DEADBAND_C
+#define SENSOR_DEFAULT_TEMP_DEADBAND_C 0.3f
+#endif
+#ifndef SENSOR_DEFAULT_HUMIDITY_DEADBAND
+#define SENSOR_DEFAULT_HUMIDITY_DEADBAND 2.0f
+#endif
+#ifndef SENSOR_DEFAULT_MIN_REPAINT_MINUTES
+#define SENSOR_DEFAULT_MIN_REPAINT_MINUTES 0
+#endif
+#ifndef SENSOR_DEFAULT_MAX_REPAINT_MINUTES
+#define SENSOR_DEFAULT_MAX_REPAINT_MINUTES 60
+#endif
+#ifndef SENSOR_BATTERY_DEADBAND_PCT
+#define SENSOR_BATTERY_DEADBAND_PCT 10
+#endif
+
+// Sparkline band of the local 24 h history (config key showHistory)
+#ifndef SENSOR_DEFAULT_SHOW_HISTORY
+#define SENSOR_DEFAULT_SHOW_HISTORY true
+#endif
+
+// "Updated:" line: time of the repaint ("%m/%d %H:%M"), date only (the day rolling over
+// forces one repaint), or no line at all
+#define SENSOR_UPDATED_TIME 'T'
+#define SENSOR_UPDATED_DATE 'D'
+#define SENSOR_UPDATED_OFF  'O'
+
+// Compiled settings. Deadbands are kept in hundredths so the struct stays integer-only.
+#define SENSOR_APP_SETTINGS_VERSION 3
+
+struct __attribute__((packed)) SensorAppSettings {
+    uint8_t version;
+    char units;                      // 'C' or 'F'
+    uint32_t refreshIntervalMinutes;
+    int32_t gmtOffsetSec;
+    int32_t daylightOffsetSec;
+    char nemoToken[96];
+    char nemoUrl[128];
+    char temperatureSensorId[24];
+    char humiditySensorId[24];
+    char batterySensorId[24];
+    char timeServer[64];
+    char timeZone[16];
+    char sensorLocation[64];
+    uint16_t tempDeadbandCentiC;     // 0.01 °C
+    uint16_t humidityDeadbandCenti;  // 0.01 %RH
+    uint16_t minRepaintMinutes;
+    uint16_t maxRepaintMinutes;
+    char updatedTime;                // SENSOR_UPDATED_*
+    uint8_t showHistory;
+};
+
+// Wake-to-wake state in the RTC state store (RTC_SLOT_SENSOR_APP); bump on layout change
+#define SENSOR_RTC_STATE_VERSION 2
+
+struct SensorRtcState {
+    bool battDateLoaded = false;  // battPostDate mirrors NVS (read once per power-on)
+    char battPostDate[11] = "";   // "YYYY-MM-DD" of the last battery POST
+    SensorShownFrame shown;       // what the panel shows (repaint policy)
+};
+
 #endif // SENSOR_APP_CONFIG_H
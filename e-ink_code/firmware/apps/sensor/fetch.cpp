@@ -1,7 +1,9 @@
 #include "fetch.h"
 #include "config.h"
+#include "../../app_manager/config_blob.h"
+#include "../../core/rtc/rtc_state_store.h"
+#include "../../core/sensor/sht31_engine.h"
 #include <Wire.h>
-#include <Adafruit_SHT31.h>
 #include <HTTPClient.h>
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
@@ -9,9 +11,6 @@
 #include <Preferences.h>
 #include <time.h>
 
-static Adafruit_SHT31 sht31 = Adafruit_SHT31();
-static bool sht31Ready = false;
-
 static String getDateKeyFromCreatedDate(const char* createdDate) {
     // Expected: "YYYY-MM-DDTHH:MM:SS.000000+HH:MM"
     if (createdDate == nullptr) return String();
@@ -19,8 +18,17 @@ static String getDateKeyFromCreatedDate(const char* createdDate) {
     return String(createdDate).substring(0, 10);
 }
 
+static SensorRtcState* sensorRtcState() {
+    return rtcState().slot<SensorRtcState>(RTC_SLOT_SENSOR_APP, SENSOR_RTC_STATE_VERSION);
+}
+
 static bool hasPostedBatteryForDate(const String& dateKey) {
     if (dateKey.length() == 0) return false;
+    // Normally answered from RTC; NVS is only read after power loss or a firmware change
+    SensorRtcState* state = sensorRtcState();
+    if (state != nullptr && state->battDateLoaded) {
+        return dateKey == state->battPostDate;
+    }
     Preferences prefs;
     if (!prefs.begin("sensor_app", true)) {
         Serial.println("[SensorApp] Preferences read open failed for battery post date");
@@ -28,11 +36,20 @@ static bool hasPostedBatteryForDate(const String& dateKey) {
     }
     String lastDate = prefs.getString("batt_post_date", "");
     prefs.end();
+    if (state != nullptr) {
+        packString(state->battPostDate, lastDate);
+        state->battDateLoaded = true;
+    }
     return lastDate == dateKey;
 }
 
 static void setPostedBatteryDate(const String& dateKey) {
     if (dateKey.length() == 0) return;
+    SensorRtcState* state = sensorRtcState();
+    if (state != nullptr) {
+        packString(state->battPostDate, dateKey);
+        state->battDateLoaded = true;
+    }
     Preferences prefs;
     if (!prefs.begin("sensor_app", false)) {
         Serial.println("[SensorApp] Preferences write open failed for battery post date");
@@ -44,66 +61,54 @@ static void setPostedBatteryDate(const String& dateKey) {
 
 bool initSensor() {
     Wire.begin(I2C_SDA, I2C_SCL);
-    if (sht31.begin(SHT31_I2C_ADDR)) {
-        sht31Ready = true;
+    if (sht31Device().begin()) {
         Serial.println("[SensorApp] SHT31 initialized");
         return true;
     }
     Serial.println("[SensorApp] SHT31 initialization failed!");
-    sht31Ready = false;
     return false;
 }
 
 bool getSensorReadingsRaw(float& tempC, float& humidity) {
-    if (!sht31Ready) {
-        if (!initSensor()) return false;
+    if (!sht31Device().ready() && !initSensor()) {
+        return false;
     }
-    tempC = sht31.readTemperature();
-    humidity = sht31.readHumidity();
-    if (isnan(tempC) || isnan(humidity)) {
-        Serial.println("[SensorApp] SHT31 read returned NaN values");
+    Sht31Sample sample;
+    if (!sht31Device().measure(sample)) {
+        Serial.println("[SensorApp] SHT31 read failed");
         return false;
     }
+    tempC = sample.tempC;
+    humidity = sample.humidity;
     return true;
 }
 
-bool getAveragedSensorReadings(float& avgTempC, float& avgHumidity, uint8_t sampleCount) {
-    if (sampleCount == 0) return false;
-
-    float tempSum = 0.0f;
-    float humiditySum = 0.0f;
-    uint8_t validSamples = 0;
-
-    for (uint8_t i = 0; i < sampleCount; ++i) {
-        float tempC = 0.0f;
-        float humidity = 0.0f;
-        if (getSensorReadingsRaw(tempC, humidity)) {
-            tempSum += tempC;
-            humiditySum += humidity;
-            ++validSamples;
-        } else {
-            Serial.printf("[SensorApp] Sensor sample %u/%u failed\n", i + 1, sampleCount);
-        }
-
-        // Small gap between sensor samples to avoid back-to-back reads.
-        if (i + 1 < sampleCount) {
-            delay(100);
-        }
+bool getAveragedSensorReadings(float& avgTempC, float& avgHumidity) {
+    if (!sht31Device().ready() && !initSensor()) {
+        return false;
     }
 
-    if (validSamples == 0) {
-        Serial.println("[SensorApp] Averaging failed: no valid sensor samples");
+    Sht31AcquireConfig config;
+    config.minSamples = SENSOR_SHT31_MIN_SAMPLES;
+    config.maxSamples = SENSOR_SHT31_MAX_SAMPLES;
+    config.budgetMs = SENSOR_SHT31_BUDGET_MS;
+    Sht31Result result;
+    if (!sht31Device().acquire(config, result)) {
+        Serial.printf("[SensorApp] Averaging failed: no valid sensor samples (%u CRC errors, %u failed)\n",
+                      result.crcErrors, result.failures);
         return false;
     }
 
-    avgTempC = tempSum / validSamples;
-    avgHumidity = humiditySum / validSamples;
-    Serial.printf("[SensorApp] Averaged %u/%u samples: %.2f C, %.2f %%RH\n",
-                  validSamples, sampleCount, avgTempC, avgHumidity);
+    avgTempC = result.tempC;
+    avgHumidity = result.humidity;
+    Serial.printf("[SensorApp] Averaged %u/%u samples in %lu ms (%u outliers, %u CRC errors): %.2f C, %.2f %%RH\n",
+                  result.used, result.taken, static_cast<unsigned long>(result.elapsedMs), result.rejected,
+                  result.crcErrors, avgTempC, avgHumidity);
     return true;
 }
 
-static String buildDisplayStringFromReadings(float tempC, float humidity, bool useCelsius, bool wifiConnected, String lastUpdatedTime) {
+static String buildDisplayStringFromReadings(float tempC, float humidity, bool useCelsius, bool wifiConnected,
+                                             String lastUpdatedTime, bool showUpdated = true) {
     float displayTemp = useCelsius ? tempC : (tempC * 9.0f / 5.0f + 32.0f);
     const char* unitStr = useCelsius ? "°C" : "°F";
 
@@ -128,9 +133,9 @@ static String buildDisplayStringFromReadings(float tempC, float humidity, bool u
             strengthDesc = "Very Poor";
         }
         result += String("\nWiFi: ") + String(rssi) + " dBm (" + strengthDesc + ")";
-        if (lastUpdatedTime.length() > 0) {
+        if (showUpdated && lastUpdatedTime.length() > 0) {
             result += String("\nUpdated: ") + lastUpdatedTime;
-        } else {
+        } else if (showUpdated) {
             result += String("\nUpdated: --");
         }
     }
@@ -138,8 +143,9 @@ static String buildDisplayStringFromReadings(float tempC, float humidity, bool u
     return result;
 }
 
-String formatSensorDataForDisplay(float tempC, float humidity, bool useCelsius, bool wifiConnected, String lastUpdatedTime) {
-    return buildDisplayStringFromReadings(tempC, humidity, useCelsius, wifiConnected, lastUpdatedTime);
+String formatSensorDataForDisplay(float tempC, float humidity, bool useCelsius, bool wifiConnected,
+                                  String lastUpdatedTime, bool showUpdated) {
+    return buildDisplayStringFromReadings(tempC, humidity, useCelsius, wifiConnected, lastUpdatedTime, showUpdated);
 }
 
 String fetchSensorData(bool useCelsius, bool wifiConnected, String lastUpdatedTime) {
@@ -13,14 +13,16 @@ bool initSensor();
 String fetchSensorData(bool useCelsius = false, bool wifiConnected = false, String lastUpdatedTime = "");
 
 // Format already-read temp (C) and humidity for display (no I2C read). Use after a single getSensorReadingsRaw().
-String formatSensorDataForDisplay(float tempC, float humidity, bool useCelsius, bool wifiConnected, String lastUpdatedTime);
+// showUpdated: false drops the "Updated:" line (updatedTime "off").
+String formatSensorDataForDisplay(float tempC, float humidity, bool useCelsius, bool wifiConnected,
+                                  String lastUpdatedTime, bool showUpdated = true);
 
 // Raw readings in Celsius (for Nemo API). Returns true if read succeeded.
 bool getSensorReadingsRaw(float& tempC, float& humidity);
 
-// Read sensor multiple times and return averaged values in Celsius/%RH.
+// Oversample within SENSOR_SHT31_BUDGET_MS, drop outliers, return the mean in Celsius/%RH.
 // Returns true if at least one reading succeeded.
-bool getAveragedSensorReadings(float& avgTempC, float& avgHumidity, uint8_t sampleCount = 5);
+bool getAveragedSensorReadings(float& avgTempC, float& avgHumidity);
 
 // Sync system time from NTP. Call when WiFi is connected. Returns true when time is set.
 bool syncTimeFromNtp(const char* ntpServer);
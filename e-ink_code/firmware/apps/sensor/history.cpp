@@ -0,0 +1,189 @@
+#include "history.h"
+#include <string.h>
+
+static const int kN = SENSOR_HISTORY_BUCKETS;
+
+static void resetSeries(SensorHistorySeries& s) {
+    memset(&s, 0, sizeof(s));
+    for (int i = 0; i < kN; i++) {
+        s.values[i] = SENSOR_HISTORY_MISSING;
+    }
+}
+
+SensorHistoryRtcState::SensorHistoryRtcState() {
+    resetSeries(temp);
+    resetSeries(humidity);
+}
+
+void sensorHistoryReset(SensorHistoryRtcState& history) {
+    history.openBucket = 0;
+    history.head = 0;
+    resetSeries(history.temp);
+    resetSeries(history.humidity);
+}
+
+// Deques are circular buffers of ring positions
+static uint8_t qAt(const uint8_t* q, uint8_t head, int i) {
+    return q[(head + i) % kN];
+}
+
+static void qPushBack(uint8_t* q, uint8_t head, uint8_t& len, uint8_t pos) {
+    q[(head + len) % kN] = pos;
+    len++;
+}
+
+static void qPopFront(uint8_t& head, uint8_t& len) {
+    head = static_cast<uint8_t>((head + 1) % kN);
+    len--;
+}
+
+/** Drop the oldest window slot (ring position @p pos) and shift every index down by one. */
+static void evictOldest(SensorHistorySeries& s, uint8_t pos) {
+    int16_t y = s.values[pos];
+    if (y != SENSOR_HISTORY_MISSING) {
+        // It sits at index 0, so it adds nothing to sumIY / sumI / sumII
+        s.sumY -= y;
+        s.present--;
+        if (s.minLen > 0 && qAt(s.minQ, s.minHead, 0) == pos) {
+            qPopFront(s.minHead, s.minLen);
+        }
+        if (s.maxLen > 0 && qAt(s.maxQ, s.maxHead, 0) == pos) {
+            qPopFront(s.maxHead, s.maxLen);
+        }
+    }
+    s.values[pos] = SENSOR_HISTORY_MISSING;
+
+    // i -> i - 1 for the remaining m present buckets
+    int32_t m = s.present;
+    s.sumIY -= s.sumY;
+    s.sumII = s.sumII - 2 * s.sumI + m;
+    s.sumI -= m;
+}
+
+/** Store @p y (or MISSING) as the newest window slot at ring position @p pos, index kN - 1. */
+static void appendNewest(SensorHistorySeries& s, uint8_t pos, int16_t y) {
+    s.values[pos] = y;
+    if (y == SENSOR_HISTORY_MISSING) {
+        return;
+    }
+    const int32_t i = kN - 1;
+    s.sumY += y;
+    s.sumIY += static_cast<int64_t>(i) * y;
+    s.sumI += i;
+    s.sumII += i * i;
+    s.present++;
+    while (s.minLen > 0 && s.values[qAt(s.minQ, s.minHead, s.minLen - 1)] >= y) {
+        s.minLen--;
+    }
+    qPushBack(s.minQ, s.minHead, s.minLen, pos);
+    while (s.maxLen > 0 && s.values[qAt(s.maxQ, s.maxHead, s.maxLen - 1)] <= y) {
+        s.maxLen--;
+    }
+    qPushBack(s.maxQ, s.maxHead, s.maxLen, pos);
+}
+
+static int16_t openAverage(const SensorHistorySeries& s) {
+    if (s.openCount == 0) {
+        return SENSOR_HISTORY_MISSING;
+    }
+    int32_t sum = s.openSum;
+    int32_t n = s.openCount;
+    return static_cast<int16_t>(sum >= 0 ? (sum + n / 2) / n : (sum - n / 2) / n);
+}
+
+static int16_t closeOpen(SensorHistorySeries& s) {
+    int16_t y = openAverage(s);
+    s.openSum = 0;
+    s.openCount = 0;
+    return y;
+}
+
+/** Slide the window by one bucket: the oldest leaves, @p tempY / @p humY enter as newest. */
+static void slide(SensorHistoryRtcState& h, int16_t tempY, int16_t humY) {
+    uint8_t pos = h.head;
+    evictOldest(h.temp, pos);
+    evictOldest(h.humidity, pos);
+    appendNewest(h.temp, pos, tempY);
+    appendNewest(h.humidity, pos, humY);
+    h.head = static_cast<uint8_t>((pos + 1) % kN);
+}
+
+static int16_t toCenti(float value) {
+    float scaled = value * 100.0f;
+    if (scaled > 32767.0f) scaled = 32767.0f;
+    if (scaled < -32767.0f) scaled = -32767.0f;
+    return static_cast<int16_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+void sensorHistoryAdd(SensorHistoryRtcState& history, uint32_t now, float tempC, float humidity) {
+    uint32_t bucket = now / SENSOR_HISTORY_BUCKET_SEC;
+    if (bucket == 0) {
+        return;  // clock not usable
+    }
+    if (history.openBucket != 0 && bucket < history.openBucket) {
+        sensorHistoryReset(history);
+    }
+    if (history.openBucket != 0 && bucket > history.openBucket) {
+        // Close the open bucket, then one empty bucket per bucket slept through
+        slide(history, closeOpen(history.temp), closeOpen(history.humidity));
+        uint32_t gap = bucket - history.openBucket - 1;
+        for (uint32_t i = 0; i < gap && i < static_cast<uint32_t>(kN); i++) {
+            slide(history, SENSOR_HISTORY_MISSING, SENSOR_HISTORY_MISSING);
+        }
+    }
+    history.openBucket = bucket;
+    history.temp.openSum += toCenti(tempC);
+    history.temp.openCount++;
+    history.humidity.openSum += toCenti(humidity);
+    history.humidity.openCount++;
+}
+
+bool sensorHistorySummary(const SensorHistorySeries& s, SensorHistorySummary& out) {
+    out = SensorHistorySummary();
+    int32_t m = s.present;
+    int32_t sumY = s.sumY;
+    int64_t sumIY = s.sumIY;
+    int64_t sumI = s.sumI;
+    int64_t sumII = s.sumII;
+    int32_t lo = s.minLen > 0 ? s.values[qAt(s.minQ, s.minHead, 0)] : INT32_MAX;
+    int32_t hi = s.maxLen > 0 ? s.values[qAt(s.maxQ, s.maxHead, 0)] : INT32_MIN;
+
+    // The open bucket joins as index kN
+    if (s.openCount > 0) {
+        int32_t y = openAverage(s);
+        m++;
+        sumY += y;
+        sumIY += static_cast<int64_t>(kN) * y;
+        sumI += kN;
+        sumII += static_cast<int64_t>(kN) * kN;
+        lo = y < lo ? y : lo;
+        hi = y > hi ? y : hi;
+    }
+    if (m == 0) {
+        return false;
+    }
+
+    out.buckets = static_cast<uint16_t>(m);
+    out.min = lo / 100.0f;
+    out.max = hi / 100.0f;
+    out.mean = static_cast<float>(sumY) / m / 100.0f;
+    int64_t denom = static_cast<int64_t>(m) * sumII - sumI * sumI;
+    if (m >= 2 && denom > 0) {
+        double perBucket = static_cast<double>(static_cast<int64_t>(m) * sumIY - sumI * sumY) / denom;
+        out.slopePerHour = static_cast<float>(perBucket * 3600.0 / SENSOR_HISTORY_BUCKET_SEC / 100.0);
+        out.hasSlope = true;
+    }
+    return true;
+}
+
+int sensorHistoryPoints(const SensorHistoryRtcState& history, const SensorHistorySeries& series,
+                        int16_t* out, int max) {
+    int count = 0;
+    for (int i = 0; i < kN && count < max; i++) {
+        out[count++] = series.values[(history.head + i) % kN];
+    }
+    if (count < max) {
+        out[count++] = openAverage(series);
+    }
+    return count;
+}
@@ -0,0 +1,89 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <stdint.h>
+
+/**
+ * Local 24 h temperature / humidity history for the sensor app, kept in the RTC
+ * state store (RTC_SLOT_SENSOR_HISTORY) so trends need no round trip to Nemo.
+ *
+ * Readings are averaged into fixed time buckets (SENSOR_HISTORY_BUCKET_SEC). The
+ * last SENSOR_HISTORY_BUCKETS closed buckets form a sliding window, plus the bucket
+ * still filling. Min / max / mean / least-squares slope are maintained as the window
+ * slides, so a wake costs O(1) however long the window is:
+ *  - min and max: monotonic deques of ring positions (amortised O(1) per bucket);
+ *  - mean and slope: running sums of y, i*y, i and i*i over present buckets, where i
+ *    is the position in the window; sliding by one shifts every i down by one, which
+ *    the sums absorb in closed form.
+ * Buckets the device slept through stay empty and are left out of every statistic.
+ * Values are stored as hundredths (centi-degrees C, centi-%RH) so the sums are exact.
+ *
+ * A power loss clears RTC memory and with it the history. No Arduino dependency:
+ * unit tested on the host (test/test_sensor_history).
+ */
+
+#ifndef SENSOR_HISTORY_BUCKETS
+#define SENSOR_HISTORY_BUCKETS 48
+#endif
+#ifndef SENSOR_HISTORY_BUCKET_SEC
+#define SENSOR_HISTORY_BUCKET_SEC 1800   // 48 x 30 min = 24 h
+#endif
+
+#define SENSOR_HISTORY_MISSING INT16_MIN
+#define SENSOR_HISTORY_RTC_STATE_VERSION 1
+
+static_assert(SENSOR_HISTORY_BUCKETS >= 2 && SENSOR_HISTORY_BUCKETS <= 255, "uint8_t ring positions");
+
+/** One series over the window of closed buckets. */
+struct SensorHistorySeries {
+    int16_t values[SENSOR_HISTORY_BUCKETS];   // by ring position; SENSOR_HISTORY_MISSING = empty
+    uint8_t minQ[SENSOR_HISTORY_BUCKETS];     // ring positions, values increasing
+    uint8_t maxQ[SENSOR_HISTORY_BUCKETS];     // ring positions, values decreasing
+    uint8_t minHead;
+    uint8_t minLen;
+    uint8_t maxHead;
+    uint8_t maxLen;
+    uint16_t present;                         // non-empty buckets in the window
+    int32_t sumY;
+    int64_t sumIY;
+    int32_t sumI;
+    int32_t sumII;
+    // Bucket being filled (not part of the window yet)
+    int32_t openSum;
+    uint16_t openCount;
+};
+
+struct SensorHistoryRtcState {
+    uint32_t openBucket = 0;   // time() / SENSOR_HISTORY_BUCKET_SEC; 0 = nothing recorded yet
+    uint8_t head = 0;          // ring position of the oldest bucket in the window
+    SensorHistorySeries temp;       // centi-degrees C
+    SensorHistorySeries humidity;   // centi-%RH
+
+    SensorHistoryRtcState();
+};
+
+struct SensorHistorySummary {
+    uint16_t buckets = 0;      // non-empty buckets, the open one included
+    float min = 0.0f;
+    float max = 0.0f;
+    float mean = 0.0f;
+    float slopePerHour = 0.0f;
+    bool hasSlope = false;     // needs two buckets
+};
+
+/** Add one reading taken at @p now (time()). A clock that went backwards clears the history. */
+void sensorHistoryAdd(SensorHistoryRtcState& history, uint32_t now, float tempC, float humidity);
+
+void sensorHistoryReset(SensorHistoryRtcState& history);
+
+/** Window plus open bucket, in degrees C / %RH. False when nothing was recorded. */
+bool sensorHistorySummary(const SensorHistorySeries& series, SensorHistorySummary& out);
+
+/**
+ * Bucket values oldest first, open bucket last (SENSOR_HISTORY_BUCKETS + 1 at most),
+ * SENSOR_HISTORY_MISSING for empty buckets. Returns the count written.
+ */
+int sensorHistoryPoints(const SensorHistoryRtcState& history, const SensorHistorySeries& series,
+                        int16_t* out, int max);
+
+#endif  // SENSOR_HISTORY_H
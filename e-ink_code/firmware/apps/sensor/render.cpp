@@ -1,7 +1,15 @@
 #include "render.h"
+#include "history.h"
 #include "../../core/display/display_manager.h"
 
 void renderSensorData(DisplayManager* display, String data, int batteryPercent) {
     if (display == nullptr) return;
     display->displayDefault(data, batteryPercent);
 }
+
+void renderSensorTrend(DisplayManager* display, String data, const int16_t* points, int count,
+                       String caption, String captionRight, int batteryPercent) {
+    if (display == nullptr) return;
+    display->displayWithSparkline(data, points, count, SENSOR_HISTORY_MISSING, caption, captionRight,
+                                  batteryPercent);
+}
@@ -8,5 +8,8 @@ class DisplayManager;
 
 // Render functions
 void renderSensorData(DisplayManager* display, String data, int batteryPercent);
+// Readings above a sparkline band of the local history (points in centi-units, oldest first)
+void renderSensorTrend(DisplayManager* display, String data, const int16_t* points, int count,
+                       String caption, String captionRight, int batteryPercent);
 
 #endif // SENSOR_APP_RENDER_H
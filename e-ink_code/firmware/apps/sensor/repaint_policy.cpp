@@ -0,0 +1,71 @@
+#include "repaint_policy.h"
+
+static float absDiff(float a, float b) {
+    return a > b ? a - b : b - a;
+}
+
+SensorRepaint sensorRepaintDecision(const SensorRepaintPolicy& policy, const SensorShownFrame& shown,
+                                    const SensorFrame& frame) {
+    if (!shown.valid) {
+        return SensorRepaint::FirstPaint;
+    }
+    if (frame.layoutHash != shown.layoutHash) {
+        return SensorRepaint::Layout;
+    }
+    if (frame.readOk != shown.readOk || frame.wifiShown != shown.wifiShown) {
+        return SensorRepaint::Status;
+    }
+    if (frame.now < shown.paintedAt) {
+        return SensorRepaint::MaxAge;
+    }
+    uint32_t age = frame.now - shown.paintedAt;
+    if (policy.maxIntervalSec > 0 && age >= policy.maxIntervalSec) {
+        return SensorRepaint::MaxAge;
+    }
+    if (age < policy.minIntervalSec || !frame.readOk) {
+        return SensorRepaint::Skip;
+    }
+    // A zero deadband repaints on every wake, like before deadbands existed
+    int batteryMoved = frame.batteryPercent - shown.batteryPercent;
+    if (absDiff(frame.tempC, shown.tempC) >= policy.tempDeadbandC ||
+        absDiff(frame.humidity, shown.humidity) >= policy.humidityDeadband ||
+        (batteryMoved < 0 ? -batteryMoved : batteryMoved) >= policy.batteryDeadband) {
+        return SensorRepaint::Changed;
+    }
+    return SensorRepaint::Skip;
+}
+
+void sensorRepaintRecord(SensorShownFrame& shown, const SensorFrame& frame) {
+    shown.valid = true;
+    shown.readOk = frame.readOk;
+    shown.wifiShown = frame.wifiShown;
+    shown.batteryPercent = static_cast<int8_t>(frame.batteryPercent);
+    shown.tempC = frame.tempC;
+    shown.humidity = frame.humidity;
+    shown.paintedAt = frame.now;
+    shown.layoutHash = frame.layoutHash;
+}
+
+const char* sensorRepaintName(SensorRepaint reason) {
+    switch (reason) {
+        case SensorRepaint::Skip: return "skip";
+        case SensorRepaint::FirstPaint: return "first paint";
+        case SensorRepaint::Layout: return "layout";
+        case SensorRepaint::Status: return "status";
+        case SensorRepaint::Changed: return "changed";
+        case SensorRepaint::MaxAge: return "max age";
+    }
+    return "?";
+}
+
+uint32_t sensorLayoutHash(const char* text, uint32_t seed) {
+    uint32_t hash = seed;
+    for (const char* p = text; p != nullptr && *p != '\0'; p++) {
+        hash ^= static_cast<uint8_t>(*p);
+        hash *= 16777619u;
+    }
+    // Separator, so ("ab","c") and ("a","bc") differ
+    hash ^= 0xFF;
+    hash *= 16777619u;
+    return hash;
+}
@@ -0,0 +1,65 @@
+#ifndef SENSOR_REPAINT_POLICY_H
+#define SENSOR_REPAINT_POLICY_H
+
+#include <stdint.h>
+
+/**
+ * Decides whether a sensor wake repaints the panel. A full three-colour refresh takes
+ * about 15 s and is the most expensive part of a wake; the panel keeps its image when
+ * it is skipped, so small drifts in the reading are simply left on screen.
+ *
+ * No Arduino dependency: unit tested on the host (test/test_sensor_repaint).
+ */
+
+struct SensorRepaintPolicy {
+    float tempDeadbandC = 0.3f;      // repaint when the temperature moved at least this far
+    float humidityDeadband = 2.0f;   // %RH
+    uint8_t batteryDeadband = 10;    // percentage points
+    uint32_t minIntervalSec = 0;     // value changes wait at least this long after a repaint
+    uint32_t maxIntervalSec = 3600;  // repaint at least this often regardless (0 = never forced)
+};
+
+/** What the panel currently shows (kept in SensorRtcState). */
+struct SensorShownFrame {
+    bool valid = false;        // false: panel content unknown (power-on, firmware change, other draw)
+    bool readOk = false;
+    bool wifiShown = false;    // signal / "Updated:" lines are on screen
+    int8_t batteryPercent = -1;
+    float tempC = 0.0f;
+    float humidity = 0.0f;
+    uint32_t paintedAt = 0;    // time()
+    uint32_t layoutHash = 0;   // units, location, "Updated:" text under the date policy
+};
+
+/** This wake's reading, in the same terms. */
+struct SensorFrame {
+    bool readOk = false;
+    bool wifiShown = false;
+    int batteryPercent = -1;
+    float tempC = 0.0f;
+    float humidity = 0.0f;
+    uint32_t now = 0;
+    uint32_t layoutHash = 0;
+};
+
+enum class SensorRepaint : uint8_t {
+    Skip = 0,
+    FirstPaint,   // nothing known about the panel
+    Layout,       // settings or the shown date changed
+    Status,       // sensor error or WiFi lines appeared / went away
+    Changed,      // a value left its deadband
+    MaxAge,       // maxIntervalSec passed (or the clock went backwards)
+};
+
+SensorRepaint sensorRepaintDecision(const SensorRepaintPolicy& policy, const SensorShownFrame& shown,
+                                    const SensorFrame& frame);
+
+/** Record a repaint of @p frame. */
+void sensorRepaintRecord(SensorShownFrame& shown, const SensorFrame& frame);
+
+const char* sensorRepaintName(SensorRepaint reason);
+
+/** FNV-1a over a NUL-terminated string, chained through @p seed. */
+uint32_t sensorLayoutHash(const char* text, uint32_t seed = 2166136261u);
+
+#endif  // SENSOR_REPAINT_POLICY_H
@@ -3,9 +3,26 @@
 #include "render.h"
 #include "config.h"
 #include "../../core/display/display_manager.h"
-#include "../../core/power/power_manager.h"
 #include "../../core/bluetooth/cold_start_ble.h"
-#include "../../core/wifi/wifi_manager.h"
+#include "../../core/rtc/rtc_state_store.h"
+#include "../../app_manager/config_blob.h"
+
+// FNV-1a; chain by passing the previous hash as seed
+static uint32_t labelHash(const char* s, uint32_t seed = 2166136261u) {
+    uint32_t h = seed;
+    for (; s != nullptr && *s != '\0'; ++s) {
+        h = (h ^ static_cast<uint8_t>(*s)) * 16777619u;
+    }
+    return h;
+}
+
+static ShelfRtcState* shelfRtcState() {
+    return rtcState().slot<ShelfRtcState>(RTC_SLOT_SHELF_APP, SHELF_RTC_STATE_VERSION);
+}
+
+static bool hasCachedLabel(const ShelfRtcState* state, uint32_t source) {
+    return state != nullptr && state->source == source && state->label[0] != '\0';
+}
 
 ShelfApp::ShelfApp() : _serverHost(SHELF_APP_DEFAULT_SERVER_HOST), _serverPort(SHELF_APP_DEFAULT_SERVER_PORT) {
 }
@@ -78,6 +95,39 @@ bool ShelfApp::configure(const JsonObject& config) {
     return true;
 }
 
+size_t ShelfApp::saveSettings(uint8_t* buf, size_t cap) {
+    if (cap < sizeof(ShelfAppSettings)) {
+        return 0;
+    }
+    ShelfAppSettings settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.version = SHELF_APP_SETTINGS_VERSION;
+    settings.serverPort = _serverPort;
+    settings.refreshIntervalMinutes = _refreshIntervalMinutes;
+    if (!packString(settings.binId, _binId) || !packString(settings.serverHost, _serverHost)) {
+        Serial.println("[ShelfApp] Config value too long for compiled settings");
+        return 0;
+    }
+    memcpy(buf, &settings, sizeof(settings));
+    return sizeof(settings);
+}
+
+bool ShelfApp::loadSettings(const uint8_t* buf, size_t len) {
+    ShelfAppSettings settings;
+    if (len != sizeof(settings)) {
+        return false;
+    }
+    memcpy(&settings, buf, sizeof(settings));
+    if (settings.version != SHELF_APP_SETTINGS_VERSION) {
+        return false;
+    }
+    _serverPort = settings.serverPort;
+    _refreshIntervalMinutes = settings.refreshIntervalMinutes;
+    _binId = unpackString(settings.binId);
+    _serverHost = unpackString(settings.serverHost);
+    return true;
+}
+
 bool ShelfApp::begin() {
     Serial.println("[ShelfApp] Starting Shelf App");
     
@@ -93,71 +143,92 @@ String ShelfApp::buildServerUrl() const {
     return "http://" + _serverHost + ":" + String(_serverPort);
 }
 
-void ShelfApp::loop() {
-    // Get battery percentage
-    int batteryPercent = -1;
-    if (_power) {
-        batteryPercent = _power->getBatteryPercentage();
-    }
-    
-    // Try to connect WiFi if we have bin ID and server configured
-    bool wifiConnected = false;
-    if (_wifi && _binId.length() > 0 && _serverHost.length() > 0 && _serverPort > 0) {
-        String wifiSSID = ColdStartBle::getStoredWiFiSSID();
-        String wifiPassword = ColdStartBle::getStoredWiFiPassword();
-        if (wifiSSID.length() > 0) {
-            Serial.println("[ShelfApp] WiFi connection requested");
-            wifiConnected = _wifi->begin(wifiSSID.c_str(), wifiPassword.c_str());
-            if (wifiConnected) {
-                Serial.println("[ShelfApp] WiFi connection successful - ready for server API calls");
-            } else {
-                Serial.println("[ShelfApp] WiFi connection failed - will show error");
-            }
-        } else {
-            Serial.println("[ShelfApp] No WiFi credentials stored. Bin data cannot be fetched.");
+uint32_t ShelfApp::cacheSource() const {
+    return labelHash(_binId.c_str(), labelHash(buildServerUrl().c_str()));
+}
+
+bool ShelfApp::isLookupConfigured() const {
+    return _binId.length() > 0 && _serverHost.length() > 0 && _serverPort > 0;
+}
+
+bool ShelfApp::wantsNetwork() {
+    // Only connect WiFi if we have bin ID and server configured
+    return isLookupConfigured();
+}
+
+void ShelfApp::fetch(AppCycle& cycle) {
+    Serial.println("[ShelfApp] WiFi connection successful - ready for server API calls");
+    String serverUrl = buildServerUrl();
+    ShelfRtcState* state = shelfRtcState();
+    uint32_t source = cacheSource();
+    bool cached = hasCachedLabel(state, source);
+
+    // With a cached label the request carries its ETag; an unchanged bin answers 304
+    String etag = cached ? String(state->etag) : String();
+    String text;
+    ShelfFetchResult result = fetchShelfData(_binId.c_str(), serverUrl.c_str(), etag, text);
+    if (result == ShelfFetchResult::Updated) {
+        _shelfData = text;
+        if (state != nullptr) {
+            // Cache only what fits; an uncached label is fetched in full next time
+            bool fits = text.length() < sizeof(state->label) && etag.length() < sizeof(state->etag);
+            state->source = fits ? source : 0;
+            strlcpy(state->etag, fits ? etag.c_str() : "", sizeof(state->etag));
+            strlcpy(state->label, fits ? text.c_str() : "", sizeof(state->label));
         }
-    }
-    
-    // Fetch shelf data
-    String shelfData;
-    if (_binId.length() > 0 && _serverHost.length() > 0 && _serverPort > 0 && wifiConnected) {
-        String serverUrl = buildServerUrl();
-        shelfData = fetchShelfData(_binId.c_str(), serverUrl.c_str());
+    } else if (cached) {
+        // 304, or the request failed: the cached label is still the best thing to show
+        if (result == ShelfFetchResult::Failed) {
+            Serial.println("[ShelfApp] Lookup failed; keeping the cached label");
+        }
+        _shelfData = state->label;
     } else {
+        _shelfData = text.length() > 0 ? text : String("API Error\nNo cached label");
+    }
+}
+
+void ShelfApp::render(AppCycle& cycle) {
+    ShelfRtcState* state = shelfRtcState();
+
+    // Without a fetch this cycle, explain why (or keep the last label if WiFi just failed)
+    if (!cycle.wifiConnected) {
         if (_binId.length() == 0) {
-            shelfData = "Shelf Label\nBin ID not configured";
+            _shelfData = "Shelf Label\nBin ID not configured";
         } else if (_serverHost.length() == 0 || _serverPort == 0) {
-            shelfData = "Shelf Label\nServer not configured";
+            _shelfData = "Shelf Label\nServer not configured";
+        } else if (hasCachedLabel(state, cacheSource())) {
+            Serial.println("[ShelfApp] WiFi not connected; keeping the cached label");
+            _shelfData = state->label;
         } else {
-            shelfData = "Shelf Label\nWiFi not connected";
+            _shelfData = "Shelf Label\nWiFi not connected";
         }
     }
+
+    // Skip the panel refresh when the label and battery reading are what it already shows
+    uint32_t shownHash = labelHash(_shelfData.c_str());
+    int battery = cycle.batteryPercent;
+    if (_display && _display->shownPanel().unchanged(RTC_SLOT_SHELF_APP, shownHash, battery, SHELF_BATTERY_DEADBAND_PCT)) {
+        Serial.println("[ShelfApp] Label unchanged; panel kept");
+        _display->disableSPI();
+        return;
+    }
     
     // Render shelf data
     if (_display) {
-        renderShelfData(_display, shelfData, batteryPercent);
+        renderShelfData(_display, _shelfData, battery);
+        _display->recordShownPanel(RTC_SLOT_SHELF_APP, shownHash, battery);
     }
     
     // Disable SPI after display update
     if (_display) {
         _display->disableSPI();
     }
-    
-    // Disable WiFi after fetching to save power
-    if (_wifi) {
-        _wifi->disconnect();
-    }
-    
-    // Enter deep sleep until next cycle (or delay if no power manager)
-    uint32_t sleepSeconds = _refreshIntervalMinutes * 60UL;
-    if (_power) {
-        Serial.print("[ShelfApp] Entering deep sleep for ");
-        Serial.print(_refreshIntervalMinutes);
-        Serial.println(" min");
-        _power->enterDeepSleep(sleepSeconds);
-    } else {
-        delay(sleepSeconds * 1000UL);
-    }
+}
+
+WakeRequest ShelfApp::finish(AppCycle& cycle) {
+    // Sleep until next cycle; WiFi is only used when the bin lookup is configured
+    bool radioNext = isLookupConfigured() && ColdStartBle::getStoredWiFiSSID().length() > 0;
+    return WakeRequest::refresh(_refreshIntervalMinutes * 60UL, radioNext);
 }
 
 void ShelfApp::end() {
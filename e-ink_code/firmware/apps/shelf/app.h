@@ -2,6 +2,7 @@
 #define SHELF_APP_H
 
 #include "../../app_manager/app_interface.h"
+#include "config.h"
 
 class ShelfApp : public AppInterface {
 public:
@@ -10,14 +11,22 @@ public:
     
     // App lifecycle
     bool begin() override;
-    void loop() override;
     void end() override;
+
+    // Cycle phases
+    bool wantsNetwork() override;
+    void fetch(AppCycle& cycle) override;
+    void render(AppCycle& cycle) override;
+    WakeRequest finish(AppCycle& cycle) override;
     
     // App identification
     const char* getName() override { return "shelf"; }
     
     // Configuration (via BLE: bin ID, server URL, refresh interval)
     bool configure(const JsonObject& config) override;
+    void resetConfig() override { assignDefaults(*this); }
+    size_t saveSettings(uint8_t* buf, size_t cap) override;
+    bool loadSettings(const uint8_t* buf, size_t len) override;
 
 private:
     // Bin ID to look up
@@ -30,8 +39,14 @@ private:
     // Refresh interval in minutes (default: 5)
     uint32_t _refreshIntervalMinutes = 5;
     
-    // Helper to build server URL from host and port
+    // Text for this cycle's render (bin data, or why there is none)
+    String _shelfData;
+
+    // Helpers to build server URL from host and port
+    bool isLookupConfigured() const;
     String buildServerUrl() const;
+    // Identifies the cached label's server + bin (a config change drops the cache)
+    uint32_t cacheSource() const;
 };
 
 #endif // SHELF_APP_H
@@ -7,4 +7,34 @@
 #define SHELF_APP_DEFAULT_SERVER_HOST "192.168.1.100"
 #define SHELF_APP_DEFAULT_SERVER_PORT 8080
 
+#include <stdint.h>
+
+// Compiled settings: lookup target and refresh interval
+#define SHELF_APP_SETTINGS_VERSION 1
+
+struct __attribute__((packed)) ShelfAppSettings {
+    uint8_t version;
+    uint16_t serverPort;
+    uint32_t refreshIntervalMinutes;
+    char binId[32];
+    char serverHost[64];
+};
+
+// Last label in the RTC state store (RTC_SLOT_SHELF_APP); bump on layout change.
+// The ETag is sent as If-None-Match, so an unchanged bin costs a 304 and no panel refresh.
+// What is on the panel is DisplayManager's record (shown_panel.h), with labelHash() as the hash.
+#define SHELF_RTC_STATE_VERSION 3
+#ifndef SHELF_LABEL_TEXT_MAX
+#define SHELF_LABEL_TEXT_MAX 160     // longer labels are shown but not cached
+#endif
+#ifndef SHELF_BATTERY_DEADBAND_PCT
+#define SHELF_BATTERY_DEADBAND_PCT 10  // battery change that redraws an unchanged label
+#endif
+
+struct ShelfRtcState {
+    uint32_t source = 0;                  // hash of server URL + bin id the cache belongs to
+    char etag[48] = "";
+    char label[SHELF_LABEL_TEXT_MAX] = "";
+};
+
 #endif // SHELF_APP_CONFIG_H
@@ -3,17 +3,20 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 
-String fetchShelfData(const char* binId, const char* serverUrl) {
+ShelfFetchResult fetchShelfData(const char* binId, const char* serverUrl, String& etag, String& text) {
     if (WiFi.status() != WL_CONNECTED) {
-        return "WiFi Error\nNot connected";
+        text = "WiFi Error\nNot connected";
+        return ShelfFetchResult::Failed;
     }
     
     if (binId == nullptr || *binId == '\0') {
-        return "Config Error\nBin ID not set";
+        text = "Config Error\nBin ID not set";
+        return ShelfFetchResult::Failed;
     }
     
     if (serverUrl == nullptr || *serverUrl == '\0') {
-        return "Config Error\nServer URL not set";
+        text = "Config Error\nServer URL not set";
+        return ShelfFetchResult::Failed;
     }
     
     // Build request URL: http://server:port/bin/<binId>
@@ -30,11 +33,19 @@ String fetchShelfData(const char* binId, const char* serverUrl) {
     HTTPClient http;
     if (!http.begin(url)) {
         Serial.println("[ShelfApp] fetchShelfData: http.begin failed");
-        return "API Error\nFailed to connect";
+        text = "API Error\nFailed to connect";
+        return ShelfFetchResult::Failed;
     }
     
     // Set timeout
     http.setTimeout(10000);  // 10 second timeout
+
+    // Revalidate the cached label: an unchanged bin answers 304 with no body
+    const char* responseHeaders[] = {"ETag"};
+    http.collectHeaders(responseHeaders, 1);
+    if (etag.length() > 0) {
+        http.addHeader("If-None-Match", etag);
+    }
     
     int httpCode = http.GET();
     
@@ -42,13 +53,22 @@ String fetchShelfData(const char* binId, const char* serverUrl) {
         Serial.printf("[ShelfApp] fetchShelfData: HTTP GET failed, error: %s\n", 
                       http.errorToString(httpCode).c_str());
         http.end();
-        return "API Error\nConnection failed";
+        text = "API Error\nConnection failed";
+        return ShelfFetchResult::Failed;
+    }
+
+    if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        Serial.printf("[ShelfApp] fetchShelfData: Bin '%s' unchanged (%s)\n", binId, etag.c_str());
+        http.end();
+        return ShelfFetchResult::NotModified;
     }
     
     if (httpCode == 404) {
         Serial.printf("[ShelfApp] fetchShelfData: Bin '%s' not found\n", binId);
         http.end();
-        return "Bin Not Found\nID: " + String(binId);
+        etag = "";
+        text = "Bin Not Found\nID: " + String(binId);
+        return ShelfFetchResult::Updated;
     }
     
     if (httpCode < 200 || httpCode >= 300) {
@@ -56,10 +76,12 @@ String fetchShelfData(const char* binId, const char* serverUrl) {
         String response = http.getString();
         Serial.println("Response: " + response);
         http.end();
-        return "API Error\nHTTP " + String(httpCode);
+        text = "API Error\nHTTP " + String(httpCode);
+        return ShelfFetchResult::Failed;
     }
     
     String payload = http.getString();
+    String newEtag = http.header("ETag");
     http.end();
     
     // Parse JSON response from server
@@ -71,7 +93,8 @@ String fetchShelfData(const char* binId, const char* serverUrl) {
         Serial.print("[ShelfApp] fetchShelfData: JSON parse error: ");
         Serial.println(error.c_str());
         Serial.println("Payload: " + payload);
-        return "API Error\nInvalid JSON";
+        text = "API Error\nInvalid JSON";
+        return ShelfFetchResult::Failed;
     }
     
     // Build display string
@@ -108,5 +131,7 @@ String fetchShelfData(const char* binId, const char* serverUrl) {
     Serial.println("[ShelfApp] fetchShelfData: Success");
     Serial.println("Result: " + result);
     
-    return result;
+    etag = newEtag;
+    text = result;
+    return ShelfFetchResult::Updated;
 }
@@ -3,9 +3,16 @@
 
 #include <Arduino.h>
 
+enum class ShelfFetchResult {
+    Updated,      // text holds the new label (etag updated, empty if the server sent none)
+    NotModified,  // 304: the cached label for etag is still current
+    Failed,       // text holds an error message; a cached label is still worth showing
+};
+
 // Shelf data fetching functions
 // binId: The bin ID to look up (can be numeric string or name)
 // serverUrl: Base URL of the bin lookup server (e.g., "http://192.168.1.100:8080")
-String fetchShelfData(const char* binId, const char* serverUrl);
+// etag: sent as If-None-Match when non-empty
+ShelfFetchResult fetchShelfData(const char* binId, const char* serverUrl, String& etag, String& text);
 
 #endif // SHELF_APP_FETCH_H
@@ -0,0 +1,144 @@
+#include "ble_config_frames.h"
+#include <string.h>
+
+static uint16_t readU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void writeU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void writeU32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+BleConfigAssembler::BleConfigAssembler(uint8_t* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity) {
+    reset();
+}
+
+void BleConfigAssembler::reset() {
+    _expectedLength = 0;
+    _expectedCrc = 0;
+    _crc = 0;
+    _received = 0;
+    _ack.status = BLE_CONFIG_STATUS_IDLE;
+    _ack.nextSeq = 0;
+    _ack.received = 0;
+    if (_capacity > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+uint8_t BleConfigAssembler::fail(uint8_t status) {
+    reset();
+    _ack.status = status;
+    return status;
+}
+
+uint8_t BleConfigAssembler::feed(const uint8_t* data, size_t len) {
+    if (data == nullptr || len == 0) {
+        return _ack.status;
+    }
+
+    // Legacy clients write the whole JSON in one go
+    if (data[0] == '{' && !inProgress()) {
+        if (len >= _capacity) {
+            return fail(BLE_CONFIG_STATUS_TOO_LARGE);
+        }
+        reset();
+        memcpy(_buffer, data, len);
+        _buffer[len] = '\0';
+        _received = len;
+        _ack.received = (uint32_t)len;
+        _ack.status = BLE_CONFIG_STATUS_COMPLETE;
+        return _ack.status;
+    }
+
+    switch (data[0]) {
+        case BLE_CONFIG_FRAME_START: {
+            if (len != BLE_CONFIG_START_FRAME_SIZE) {
+                return fail(BLE_CONFIG_STATUS_BAD_FRAME);
+            }
+            uint32_t total = readU32(data + 1);
+            if (total == 0) {
+                return fail(BLE_CONFIG_STATUS_BAD_FRAME);
+            }
+            if (total >= _capacity) {
+                return fail(BLE_CONFIG_STATUS_TOO_LARGE);
+            }
+            reset();
+            _expectedLength = total;
+            _expectedCrc = readU32(data + 5);
+            _ack.status = BLE_CONFIG_STATUS_PROGRESS;
+            return _ack.status;
+        }
+
+        case BLE_CONFIG_FRAME_DATA: {
+            if (!inProgress() || len < BLE_CONFIG_DATA_HEADER_SIZE) {
+                return fail(BLE_CONFIG_STATUS_BAD_FRAME);
+            }
+            uint16_t seq = readU16(data + 1);
+            if (seq != _ack.nextSeq) {
+                // Keep what we have; the sender rewinds to nextSeq
+                _ack.status = BLE_CONFIG_STATUS_BAD_SEQUENCE;
+                return _ack.status;
+            }
+            size_t payloadLen = len - BLE_CONFIG_DATA_HEADER_SIZE;
+            if (_received + payloadLen > _expectedLength) {
+                return fail(BLE_CONFIG_STATUS_BAD_FRAME);
+            }
+            memcpy(_buffer + _received, data + BLE_CONFIG_DATA_HEADER_SIZE, payloadLen);
+            _crc = crc32(_crc, data + BLE_CONFIG_DATA_HEADER_SIZE, payloadLen);
+            _received += payloadLen;
+            _ack.nextSeq++;
+            _ack.received = (uint32_t)_received;
+            _ack.status = BLE_CONFIG_STATUS_PROGRESS;
+
+            if (_received == _expectedLength) {
+                if (_crc != _expectedCrc) {
+                    return fail(BLE_CONFIG_STATUS_BAD_CRC);
+                }
+                _buffer[_received] = '\0';
+                _expectedLength = 0;
+                _ack.status = BLE_CONFIG_STATUS_COMPLETE;
+            }
+            return _ack.status;
+        }
+
+        case BLE_CONFIG_FRAME_ABORT:
+            return fail(BLE_CONFIG_STATUS_ABORTED);
+
+        default:
+            return fail(BLE_CONFIG_STATUS_BAD_FRAME);
+    }
+}
+
+size_t BleConfigAssembler::encodeAck(const BleConfigAck& ack, uint16_t mtu, uint16_t capacity, uint8_t* out) {
+    out[0] = ack.status;
+    writeU16(out + 1, ack.nextSeq);
+    writeU32(out + 3, ack.received);
+    writeU16(out + 7, mtu);
+    writeU16(out + 9, capacity);
+    return BLE_CONFIG_ACK_SIZE;
+}
+
+uint32_t BleConfigAssembler::crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    // Bitwise: configs are a few KB and arrive at BLE speed, a table is not worth 1 KB of RAM
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
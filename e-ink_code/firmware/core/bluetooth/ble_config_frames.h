@@ -0,0 +1,86 @@
+#ifndef BLE_CONFIG_FRAMES_H
+#define BLE_CONFIG_FRAMES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Framed config transfer over the cold-start TX characteristic (ff01).
+ *
+ * A config larger than one ATT write is sent as
+ *   START  [0x01][u32 totalLength][u32 crc32]
+ *   DATA   [0x02][u16 seq][payload...]        seq counts from 0, payload up to MTU - 6
+ *   ABORT  [0x03]
+ * (all integers little-endian, crc32 is the zlib/IEEE CRC of the whole payload).
+ * A write that starts with '{' while no transfer is open is taken as a complete
+ * legacy single-write JSON config, so existing clients keep working.
+ *
+ * Progress and the result are notified on the RX characteristic (ff02) as
+ *   [status][u16 nextSeq][u32 received][u16 mtu][u16 capacity]
+ * On BLE_CONFIG_STATUS_BAD_SEQUENCE the transfer stays open and the sender
+ * resumes from nextSeq; every other error closes it.
+ *
+ * Kept free of Arduino / NimBLE so it can be unit tested on the host
+ * (pio test -e native).
+ */
+
+#define BLE_CONFIG_FRAME_START  0x01
+#define BLE_CONFIG_FRAME_DATA   0x02
+#define BLE_CONFIG_FRAME_ABORT  0x03
+
+#define BLE_CONFIG_STATUS_IDLE          0x00
+#define BLE_CONFIG_STATUS_PROGRESS      0x01
+#define BLE_CONFIG_STATUS_COMPLETE      0x02
+#define BLE_CONFIG_STATUS_BAD_SEQUENCE  0x81
+#define BLE_CONFIG_STATUS_BAD_CRC       0x82
+#define BLE_CONFIG_STATUS_TOO_LARGE     0x83
+#define BLE_CONFIG_STATUS_BAD_FRAME     0x84
+#define BLE_CONFIG_STATUS_ABORTED       0x85
+
+#define BLE_CONFIG_START_FRAME_SIZE  9
+#define BLE_CONFIG_DATA_HEADER_SIZE  3
+#define BLE_CONFIG_ACK_SIZE          11
+
+struct BleConfigAck {
+    uint8_t status;
+    uint16_t nextSeq;
+    uint32_t received;
+};
+
+class BleConfigAssembler {
+public:
+    /** buffer must hold capacity bytes; the assembled payload is NUL-terminated, so
+     *  the largest accepted config is capacity - 1 bytes. */
+    BleConfigAssembler(uint8_t* buffer, size_t capacity);
+
+    void reset();
+
+    /** Feed one characteristic write. Returns the resulting ack status. */
+    uint8_t feed(const uint8_t* data, size_t len);
+
+    bool isComplete() const { return _ack.status == BLE_CONFIG_STATUS_COMPLETE; }
+    bool inProgress() const { return _expectedLength > 0; }
+    const char* text() const { return reinterpret_cast<const char*>(_buffer); }
+    size_t length() const { return _received; }
+    size_t capacity() const { return _capacity; }
+    const BleConfigAck& ack() const { return _ack; }
+
+    /** Encode an ack notification (BLE_CONFIG_ACK_SIZE bytes). */
+    static size_t encodeAck(const BleConfigAck& ack, uint16_t mtu, uint16_t capacity, uint8_t* out);
+
+    /** zlib-compatible CRC-32; pass 0 to start. */
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+private:
+    uint8_t fail(uint8_t status);
+
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _expectedLength;
+    uint32_t _expectedCrc;
+    uint32_t _crc;
+    size_t _received;
+    BleConfigAck _ack;
+};
+
+#endif // BLE_CONFIG_FRAMES_H
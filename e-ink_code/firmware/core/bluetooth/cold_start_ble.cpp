@@ -1,12 +1,18 @@
 #include "cold_start_ble.h"
+#include "ble_config_frames.h"
 #include "NimBLEDevice.h"
 #include <WiFi.h>
-#include <Preferences.h>
+#include <esp_pm.h>
+#include "../config/config_store.h"
 #include <ArduinoJson.h>
 #include "../display/display_manager.h"
+#include "../../app_manager/app_manager.h"
+#include "../../app_manager/config_blob.h"
+#include "../../app_manager/config_transform.h"
 
 // Forward declaration
 extern DisplayManager displayManager;
+extern AppManager appManager;
 
 // Compile-time check for BLE support
 #ifndef CONFIG_BT_ENABLED
@@ -34,12 +40,38 @@ extern DisplayManager displayManager;
 #define COLD_START_TX_CHAR_UUID "0000ff01-0000-1000-8000-00805f9b34fb"
 #define COLD_START_RX_CHAR_UUID "0000ff02-0000-1000-8000-00805f9b34fb"
 
-#define PENDING_CONFIG_MAX 2048
+// configJson is stored as an NVS string, which is limited to 4000 bytes including the NUL
+#define PENDING_CONFIG_MAX 4000
+// Ask for the largest ATT MTU so framed transfers need few writes; the central may offer less
+#define COLD_START_BLE_MTU 517
+
+// Pending config: reassembled by the BLE callback, processed in main loop (avoids crash from heavy work in BLE task)
+static uint8_t s_pendingConfigBuffer[PENDING_CONFIG_MAX];
+static BleConfigAssembler s_assembler(s_pendingConfigBuffer, sizeof(s_pendingConfigBuffer));
+static volatile bool s_pendingConfig = false;
+
+// Ack state shared between the BLE task (writer) and ColdStartBle::loop() (notifier)
+static portMUX_TYPE s_ackMux = portMUX_INITIALIZER_UNLOCKED;
+static BleConfigAck s_ack = {BLE_CONFIG_STATUS_IDLE, 0, 0};
+static volatile bool s_ackDirty = false;
+static volatile uint16_t s_mtu = 23;  // BLE default until the central negotiates
+static NimBLECharacteristic* s_rxChar = nullptr;
+
+// Advertising intervals are in 0.625 ms units
+struct AdvTier {
+    uint32_t startSeconds;
+    uint16_t minInterval;
+    uint16_t maxInterval;
+    esp_power_level_t power;
+    float estimatedMa;
+    const char* name;
+};
 
-// Pending config: filled by BLE callback, processed in main loop (avoids crash from heavy work in BLE task)
-static char s_pendingConfigBuffer[PENDING_CONFIG_MAX];
-static size_t s_pendingConfigLength = 0;
-static bool s_pendingConfig = false;
+static const AdvTier kAdvTiers[] = {
+    {0,                             32,   48,   ESP_PWR_LVL_P9, BLE_EST_ADV_FAST_MA,   "fast"},
+    {COLD_START_BLE_FAST_SECONDS,   244,  338,  ESP_PWR_LVL_P6, BLE_EST_ADV_MEDIUM_MA, "medium"},
+    {COLD_START_BLE_MEDIUM_SECONDS, 1636, 2056, ESP_PWR_LVL_N0, BLE_EST_ADV_SLOW_MA,   "slow"},
+};
 
 // Default app name for this build (matches main.cpp)
 #if defined(APP_FUN) && !defined(APP_SENSOR) && !defined(APP_SHELF) && !defined(APP_MESSAGES)
@@ -98,6 +130,30 @@ static bool isAppAvailable(const char* appName) {
 #endif
 }
 
+/**
+ * App check for a received config. A playlist ("mode": "playlist") is accepted when at
+ * least one entry's mode is in this build; AppManager skips the others. On rejection
+ * `requested` names the app to show on the mismatch screen.
+ */
+static bool isConfigAvailable(const JsonDocument& doc, const char*& requested) {
+    requested = doc["mode"].as<const char*>();
+    if (requested == nullptr || strcmp(requested, "playlist") != 0) {
+        return isAppAvailable(requested);
+    }
+    bool any = false;
+    for (JsonVariantConst entry : doc["playlist"].as<JsonArrayConst>()) {
+        const char* app = entry["mode"].as<const char*>();
+        if (isAppAvailable(app)) {
+            any = true;
+        } else if (app != nullptr) {
+            Serial.print("[ColdStartBle] Playlist entry not in this firmware, skipped: ");
+            Serial.println(app);
+            requested = app;
+        }
+    }
+    return any;
+}
+
 /** Callback that sets a flag when a central connects.
  *  Keep this minimal (no Serial, no allocation): runs in BLE task context; heavy work can crash.
  */
@@ -110,39 +166,71 @@ public:
     void onDisconnect(NimBLEServer* /*pServer*/) override {
         *_connectedFlag = false;
     }
+    void onMTUChange(uint16_t mtu, ble_gap_conn_desc* /*desc*/) override {
+        s_mtu = mtu;
+        s_ackDirty = true;  // re-announce so the sender can size its frames
+    }
 
 private:
     bool* _connectedFlag;
 };
 
 /** Callback that handles data written to the TX characteristic.
- *  Only copies payload to a buffer and sets a flag. Heavy work (Preferences, restart)
- *  is done in ColdStartBle::loop() to avoid crashing (BLE callbacks run in BLE task).
+ *  Only feeds the frame to the reassembly buffer and records the ack. Notifications and
+ *  heavy work (JSON, NVS, app switch) are done in ColdStartBle::loop() to avoid crashing
+ *  (BLE callbacks run in BLE task).
  */
 class ColdStartBleTxCallbacks : public NimBLECharacteristicCallbacks {
 public:
     void onWrite(NimBLECharacteristic* pCharacteristic) override {
-        std::string value = pCharacteristic->getValue();
-        size_t length = value.length();
-        if (length == 0 || s_pendingConfig) return;
-        size_t copyLen = (length < PENDING_CONFIG_MAX) ? length : (PENDING_CONFIG_MAX - 1);
-        memcpy(s_pendingConfigBuffer, value.data(), copyLen);
-        s_pendingConfigBuffer[copyLen] = '\0';
-        s_pendingConfigLength = copyLen;
-        s_pendingConfig = true;
+        NimBLEAttValue value = pCharacteristic->getValue();
+        if (value.length() == 0 || s_pendingConfig) return;
+        s_assembler.feed(value.data(), value.length());
+        portENTER_CRITICAL(&s_ackMux);
+        s_ack = s_assembler.ack();
+        portEXIT_CRITICAL(&s_ackMux);
+        s_ackDirty = true;
+        if (s_assembler.isComplete()) {
+            s_pendingConfig = true;
+        }
     }
 };
 
+/** Send the latest transfer status on the RX characteristic. Called from loop(). */
+static void notifyConfigAck() {
+    if (!s_ackDirty || s_rxChar == nullptr) {
+        return;
+    }
+    s_ackDirty = false;
+    BleConfigAck ack;
+    portENTER_CRITICAL(&s_ackMux);
+    ack = s_ack;
+    portEXIT_CRITICAL(&s_ackMux);
+
+    uint8_t frame[BLE_CONFIG_ACK_SIZE];
+    BleConfigAssembler::encodeAck(ack, s_mtu, PENDING_CONFIG_MAX - 1, frame);
+    s_rxChar->setValue(frame, sizeof(frame));
+    s_rxChar->notify();
+
+    static uint8_t lastStatus = BLE_CONFIG_STATUS_IDLE;
+    if (ack.status != lastStatus || (ack.status & 0x80)) {
+        Serial.printf("[ColdStartBle] Config transfer status 0x%02x: %u bytes, next seq %u (MTU %u)\n",
+                      ack.status, (unsigned)ack.received, ack.nextSeq, s_mtu);
+        lastStatus = ack.status;
+    }
+}
+
 /** Process config received via BLE. Called from main loop (not from BLE callback). */
 static void processPendingConfig() {
-    String jsonString(s_pendingConfigBuffer);
-    s_pendingConfigLength = 0;
+    uint32_t receivedMs = millis();
+    String jsonString(s_assembler.text());
+    s_assembler.reset();
     if (jsonString.length() == 0 || !jsonString.startsWith("{") || !jsonString.endsWith("}")) {
         Serial.println("[ColdStartBle] Pending config invalid or not JSON, ignoring");
         return;
     }
     Serial.println("[ColdStartBle] Processing received config...");
-    DynamicJsonDocument doc(2048);
+    DynamicJsonDocument doc(configJsonCapacity(jsonString.length()));
     DeserializationError error = deserializeJson(doc, jsonString);
     if (error) {
         Serial.print("[ColdStartBle] JSON parse error: ");
@@ -152,8 +240,8 @@ static void processPendingConfig() {
     
     // Validate that the requested app exists in this firmware build
     if (doc.containsKey("mode")) {
-        const char* requestedApp = doc["mode"].as<const char*>();
-        if (!isAppAvailable(requestedApp)) {
+        const char* requestedApp = nullptr;
+        if (!isConfigAvailable(doc, requestedApp)) {
             // Config app doesn't match firmware - show error and don't store/restart
             Serial.print("[ColdStartBle] Config mismatch: ");
             Serial.print(requestedApp);
@@ -169,22 +257,22 @@ static void processPendingConfig() {
             return;
         }
     }
-    Preferences preferences;
-    preferences.begin("config", false);
+    // Everything below is staged in the ConfigStore and written with a single commit
+    ConfigStore& store = ConfigStore::instance();
     const char* wifiSSID = nullptr;
     if (doc.containsKey("wifiSSID")) wifiSSID = doc["wifiSSID"];
     else if (doc.containsKey("wifiSsid")) wifiSSID = doc["wifiSsid"];
-    if (wifiSSID != nullptr) preferences.putString("wifiSSID", wifiSSID);
-    if (doc.containsKey("wifiPassword")) preferences.putString("wifiPassword", doc["wifiPassword"].as<const char*>());
-    if (doc.containsKey("mode")) preferences.putString("mode", doc["mode"].as<const char*>());
-    if (doc.containsKey("refreshInterval")) preferences.putUInt("refreshInterval", doc["refreshInterval"].as<uint32_t>());
-    if (doc.containsKey("timestamp")) preferences.putULong64("timestamp", doc["timestamp"].as<uint64_t>());
+    if (wifiSSID != nullptr) store.putString("wifiSSID", wifiSSID);
+    if (doc.containsKey("wifiPassword")) store.putString("wifiPassword", doc["wifiPassword"].as<const char*>());
+    if (doc.containsKey("mode")) store.putString("mode", doc["mode"].as<const char*>());
+    if (doc.containsKey("refreshInterval")) store.putUInt("refreshInterval", doc["refreshInterval"].as<uint32_t>());
+    if (doc.containsKey("timestamp")) store.putULong64("timestamp", doc["timestamp"].as<uint64_t>());
     if (doc.containsKey("apis") && doc["apis"].is<JsonObject>()) {
         String apisJson;
         serializeJson(doc["apis"], apisJson);
-        preferences.putString("apis", apisJson);
+        store.putString("apis", apisJson);
     }
-    auto putSanitizedFriendly = [&preferences](const char* raw) -> void {
+    auto putSanitizedFriendly = [&store](const char* raw) -> void {
         if (raw == nullptr) return;
         String s(raw);
         s.trim();
@@ -192,7 +280,7 @@ static void processPendingConfig() {
             s = s.substring(0, 160);
         }
         if (s.length() > 0) {
-            preferences.putString("deviceFriendlyName", s);
+            store.putString("deviceFriendlyName", s);
         }
     };
     if (doc.containsKey("displayName")) {
@@ -209,7 +297,7 @@ static void processPendingConfig() {
             did = did.substring(0, 64);
         }
         if (did.length() > 0) {
-            preferences.putString("deviceId", did);
+            store.putString("deviceId", did);
         }
     } else if (doc.containsKey("device_id")) {
         String did(doc["device_id"].as<const char*>());
@@ -218,24 +306,24 @@ static void processPendingConfig() {
             did = did.substring(0, 64);
         }
         if (did.length() > 0) {
-            preferences.putString("deviceId", did);
+            store.putString("deviceId", did);
         }
     }
     // Shelf app: bin ID, server host, server port
     if (doc.containsKey("binId")) {
-        preferences.putString("binId", doc["binId"].as<const char*>());
+        store.putString("binId", doc["binId"].as<const char*>());
     } else if (doc.containsKey("bin_id")) {
-        preferences.putString("binId", doc["bin_id"].as<const char*>());
+        store.putString("binId", doc["bin_id"].as<const char*>());
     }
     if (doc.containsKey("serverHost")) {
-        preferences.putString("serverHost", doc["serverHost"].as<const char*>());
+        store.putString("serverHost", doc["serverHost"].as<const char*>());
     } else if (doc.containsKey("server_host")) {
-        preferences.putString("serverHost", doc["server_host"].as<const char*>());
+        store.putString("serverHost", doc["server_host"].as<const char*>());
     }
     if (doc.containsKey("serverPort")) {
-        preferences.putUInt("serverPort", doc["serverPort"].as<uint16_t>());
+        store.putUInt("serverPort", doc["serverPort"].as<uint16_t>());
     } else if (doc.containsKey("server_port")) {
-        preferences.putUInt("serverPort", doc["server_port"].as<uint16_t>());
+        store.putUInt("serverPort", doc["server_port"].as<uint16_t>());
     }
     // Legacy support: if serverUrl is provided, try to parse it
     if (doc.containsKey("serverUrl") || doc.containsKey("server_url")) {
@@ -247,22 +335,142 @@ static void processPendingConfig() {
         String hostPort = (protocolEnd >= 0) ? serverUrl.substring(protocolEnd + 3) : serverUrl;
         int colonPos = hostPort.indexOf(':');
         if (colonPos > 0) {
-            preferences.putString("serverHost", hostPort.substring(0, colonPos));
-            preferences.putUInt("serverPort", hostPort.substring(colonPos + 1).toInt());
+            store.putString("serverHost", hostPort.substring(0, colonPos));
+            store.putUInt("serverPort", hostPort.substring(colonPos + 1).toInt());
         } else {
-            preferences.putString("serverHost", hostPort);
+            store.putString("serverHost", hostPort);
         }
     }
-    preferences.putString("configJson", jsonString);
-    preferences.putBool("skipBLE", true);
-    preferences.end();
-    Serial.println("[ColdStartBle] Configuration saved, restarting...");
-    Serial.flush();
-    delay(1000);
-    ESP.restart();
+    store.putString("configJson", jsonString);
+
+    // Compile once here so every later wake maps a packed struct instead of re-parsing JSON.
+    // A stale blob must never outlive the JSON it came from, so clear it on any failure.
+    static uint8_t blob[CONFIG_BLOB_MAX];
+    size_t blobLen = 0;
+    String appConfigJson;
+    bool applied = transformStoredConfig(jsonString.c_str(), appConfigJson) &&
+                   appManager.configureFromJson(appConfigJson.c_str());
+    if (applied) {
+        blobLen = appManager.compileConfigBlob(blob, sizeof(blob));
+    }
+    if (blobLen > 0) {
+        store.putBytes("configBlob", blob, blobLen);
+    } else {
+        store.remove("configBlob");
+    }
+
+    if (!applied) {
+        // Could not configure in place: persist and let the normal boot path try
+        store.putBool("skipBLE", true);
+        store.commit();
+        store.logStats("Provisioning");
+        Serial.println("[ColdStartBle] Configuration saved, restarting...");
+        Serial.flush();
+        delay(1000);
+        ESP.restart();
+        return;
+    }
+
+    // Hot apply: the app is already configured, so start it and let the main loop
+    // render now. NVS is written by a background task while the app fetches;
+    // enterDeepSleep() waits for it. The RTC snapshot is refreshed so the next
+    // timer wake restores the new settings. begin() ends the app setup() started first.
+    store.commitAsync();
+    appManager.saveRtcSnapshot();
+    appManager.begin();
+    Serial.print("[ColdStartBle] Configuration applied without restart in ms=");
+    Serial.println((uint32_t)(millis() - receivedMs));
+}
+
+ColdStartBle::ColdStartBle()
+    : _active(false), _startMillis(0), _connected(false), _tier(0), _lastAccountMillis(0),
+      _connectedMs(0), _idleMs(0), _lightSleep(false), _savedCpuMhz(0) {
+    for (int i = 0; i < ADV_TIER_COUNT; i++) {
+        _tierMs[i] = 0;
+    }
+}
+
+void ColdStartBle::applyAdvertisingTier(int tier) {
+    const AdvTier& t = kAdvTiers[tier];
+    NimBLEAdvertising* pAdv = NimBLEDevice::getAdvertising();
+    bool wasAdvertising = pAdv->isAdvertising();
+    if (wasAdvertising) {
+        pAdv->stop();
+    }
+    pAdv->setMinInterval(t.minInterval);
+    pAdv->setMaxInterval(t.maxInterval);
+    NimBLEDevice::setPower(t.power, ESP_BLE_PWR_TYPE_ADV);
+    // While connected the stack restarts advertising itself after disconnect, with these settings
+    if (wasAdvertising) {
+        pAdv->start();
+    }
+    _tier = tier;
+    Serial.printf("[ColdStartBle] Advertising tier %s: %u-%u ms\n", t.name,
+                  (unsigned)(t.minInterval * 5 / 8), (unsigned)(t.maxInterval * 5 / 8));
+}
+
+void ColdStartBle::accountTime() {
+    uint32_t now = millis();
+    uint32_t delta = now - _lastAccountMillis;
+    _lastAccountMillis = now;
+    if (_connected) {
+        _connectedMs += delta;
+    } else {
+        _tierMs[_tier] += delta;
+    }
+}
+
+void ColdStartBle::endWindow(const char* reason) {
+    accountTime();
+    s_rxChar = nullptr;
+    NimBLEDevice::deinit(true);
+    _active = false;
+
+#if CONFIG_PM_ENABLE
+    if (_lightSleep) {
+        esp_pm_config_esp32c3_t pm = {};
+        pm.max_freq_mhz = _savedCpuMhz;
+        pm.min_freq_mhz = _savedCpuMhz;
+        pm.light_sleep_enable = false;
+        esp_pm_configure(&pm);
+    }
+#endif
+    if (_savedCpuMhz > 0 && getCpuFrequencyMhz() != _savedCpuMhz) {
+        setCpuFrequencyMhz(_savedCpuMhz);
+    }
+
+    // Energy estimate for the window vs. the old schedule (fast advertising at +9 dBm
+    // for the whole window with loop() spinning)
+    uint32_t totalMs = _connectedMs;
+    float radioMas = _connectedMs * BLE_EST_CONNECTED_MA;
+    for (int i = 0; i < ADV_TIER_COUNT; i++) {
+        totalMs += _tierMs[i];
+        radioMas += _tierMs[i] * kAdvTiers[i].estimatedMa;
+    }
+    uint32_t idleMs = _idleMs < totalMs ? _idleMs : totalMs;
+    float idleMa = _lightSleep ? BLE_EST_LIGHT_SLEEP_MA : BLE_EST_CPU_IDLE_MA;
+    float cpuMas = (totalMs - idleMs) * BLE_EST_CPU_ACTIVE_MA + idleMs * idleMa;
+    float estimateMas = (radioMas + cpuMas) / 1000.0f;
+    float baselineMas = (_connectedMs * BLE_EST_CONNECTED_MA +
+                         (totalMs - _connectedMs) * BLE_EST_ADV_FAST_MA +
+                         totalMs * BLE_EST_CPU_ACTIVE_MA) / 1000.0f;
+
+    Serial.printf("[ColdStartBle] BLE window ended (%s) after %u ms: fast %u / medium %u / slow %u / connected %u ms, idle %u ms%s\n",
+                  reason, (unsigned)totalMs, (unsigned)_tierMs[0], (unsigned)_tierMs[1],
+                  (unsigned)_tierMs[2], (unsigned)_connectedMs, (unsigned)idleMs,
+                  _lightSleep ? " (light sleep)" : "");
+    Serial.printf("[ColdStartBle] Estimated energy: %.1f mAs (%.2f uAh), fixed fast schedule: %.1f mAs (%.2f uAh)\n",
+                  estimateMas, estimateMas / 3.6f, baselineMas, baselineMas / 3.6f);
 }
 
-ColdStartBle::ColdStartBle() : _active(false), _startMillis(0), _connected(false) {}
+void ColdStartBle::idle() {
+    if (!_active) {
+        return;
+    }
+    uint32_t start = millis();
+    delay(COLD_START_BLE_IDLE_MS);
+    _idleMs += millis() - start;
+}
 
 void ColdStartBle::begin(esp_sleep_wakeup_cause_t wakeup_cause, esp_reset_reason_t reset_reason, bool skip_ble) {
     // Be permissive: if this boot was NOT caused by deep sleep, always allow BLE.
@@ -298,6 +506,7 @@ void ColdStartBle::begin(esp_sleep_wakeup_cause_t wakeup_cause, esp_reset_reason
     
     // Initialize BLE device with name
     NimBLEDevice::init(COLD_START_BLE_DEVICE_NAME);
+    NimBLEDevice::setMTU(COLD_START_BLE_MTU);
     Serial.println("[ColdStartBle] BLE device initialized successfully");
 
     // Print BLE MAC address for debugging
@@ -308,6 +517,7 @@ void ColdStartBle::begin(esp_sleep_wakeup_cause_t wakeup_cause, esp_reset_reason
     // ESP_PWR_LVL_P9 = maximum power (19.5 dBm)
     NimBLEDevice::setPower(ESP_PWR_LVL_P9);
     Serial.println("[ColdStartBle] BLE power set to maximum (19.5 dBm)");
+    // (advertising power is lowered by the later tiers in loop())
 
     NimBLEServer* pServer = NimBLEDevice::createServer();
     if (!pServer) {
@@ -382,6 +592,13 @@ void ColdStartBle::begin(esp_sleep_wakeup_cause_t wakeup_cause, esp_reset_reason
         return;
     }
     Serial.println("[ColdStartBle] RX characteristic created");
+    // Readable before any transfer so a client can learn the buffer size
+    s_assembler.reset();
+    s_ack = s_assembler.ack();
+    uint8_t idleAck[BLE_CONFIG_ACK_SIZE];
+    BleConfigAssembler::encodeAck(s_ack, s_mtu, PENDING_CONFIG_MAX - 1, idleAck);
+    pRxChar->setValue(idleAck, sizeof(idleAck));
+    s_rxChar = pRxChar;
     Serial.print("  - RX Characteristic UUID: ");
     Serial.println(COLD_START_RX_CHAR_UUID);
 
@@ -429,6 +646,8 @@ void ColdStartBle::begin(esp_sleep_wakeup_cause_t wakeup_cause, esp_reset_reason
     // Small delay to ensure BLE stack is ready
     delay(200);
 
+    applyAdvertisingTier(0);
+
     // Start advertising (after service started and adv data set)
     if (!pAdvertising->start()) {
         NimBLEDevice::deinit(true);
@@ -441,16 +660,38 @@ void ColdStartBle::begin(esp_sleep_wakeup_cause_t wakeup_cause, esp_reset_reason
 
     _active = true;
     _startMillis = millis();
+    _lastAccountMillis = _startMillis;
     _connected = false;
+
+    // BLE housekeeping does not need 160 MHz. With power management compiled in, let the
+    // idle task light-sleep between advertising events as well.
+    _savedCpuMhz = getCpuFrequencyMhz();
+#if CONFIG_PM_ENABLE
+    esp_pm_config_esp32c3_t pm = {};
+    pm.max_freq_mhz = 80;
+    pm.min_freq_mhz = 40;
+    pm.light_sleep_enable = true;
+    esp_err_t pmErr = esp_pm_configure(&pm);
+    _lightSleep = (pmErr == ESP_OK);
+    if (!_lightSleep) {
+        Serial.printf("[ColdStartBle] Light sleep unavailable (%s)\n", esp_err_to_name(pmErr));
+    }
+#endif
+    if (!_lightSleep) {
+        setCpuFrequencyMhz(80);
+    }
     Serial.println("[ColdStartBle] BLE enabled for 3 minutes or until connected (cold start)");
 }
 
 void ColdStartBle::loop() {
     // Config received in BLE callback: process in main loop to avoid crash (no heavy work in BLE task)
+    if (_active) {
+        notifyConfigAck();
+    }
     if (s_pendingConfig) {
+        delay(100);  // let the COMPLETE notification go out before the stack is torn down
         s_pendingConfig = false;
-        NimBLEDevice::deinit(true);
-        _active = false;
+        endWindow("config received");
         processPendingConfig();
         return;
     }
@@ -459,9 +700,18 @@ void ColdStartBle::loop() {
         return;
     }
 
+    accountTime();
     uint32_t elapsed = (uint32_t)(millis() - _startMillis);
     bool timeout = (elapsed >= (COLD_START_BLE_WINDOW_SECONDS * 1000u));
 
+    int tier = _tier;
+    while (tier + 1 < ADV_TIER_COUNT && elapsed >= kAdvTiers[tier + 1].startSeconds * 1000u) {
+        tier++;
+    }
+    if (tier != _tier) {
+        applyAdvertisingTier(tier);
+    }
+
     // Log connection state changes from main loop (not from BLE callback, to avoid crash)
     static bool lastConnected = false;
     if (_connected && !lastConnected) {
@@ -497,8 +747,7 @@ void ColdStartBle::loop() {
     // Only disable BLE when the window has timed out and no one is connected.
     // While a client is connected we stay up so they can discover services and send config.
     if (timeout && !_connected) {
-        NimBLEDevice::deinit(true);
-        _active = false;
+        endWindow(lastConnected ? "client disconnected" : "timeout");
         if (lastConnected) {
             Serial.println("[ColdStartBle] BLE disabled (client disconnected)");
         } else {
@@ -508,43 +757,41 @@ void ColdStartBle::loop() {
 }
 
 String ColdStartBle::getStoredWiFiSSID() {
-    Preferences preferences;
-    preferences.begin("config", true); // true = read-only mode
-    String ssid = preferences.getString("wifiSSID", "");
-    preferences.end();
-    return ssid;
+    return ConfigStore::instance().wifiSSID();
 }
 
 String ColdStartBle::getStoredWiFiPassword() {
-    Preferences preferences;
-    preferences.begin("config", true); // true = read-only mode
-    String password = preferences.getString("wifiPassword", "");
-    preferences.end();
-    return password;
+    return ConfigStore::instance().wifiPassword();
 }
 
 String ColdStartBle::getStoredConfigJson() {
-    Preferences preferences;
-    preferences.begin("config", true); // true = read-only mode
-    String configJson = preferences.getString("configJson", "");
-    preferences.end();
-    return configJson;
+    return ConfigStore::instance().configJson();
+}
+
+size_t ColdStartBle::getStoredConfigBlob(uint8_t* buf, size_t cap) {
+    size_t len = 0;
+    const uint8_t* blob = ConfigStore::instance().configBlob(&len);
+    if (blob == nullptr || len > cap) {
+        return 0;
+    }
+    memcpy(buf, blob, len);
+    return len;
+}
+
+void ColdStartBle::putStoredConfigBlob(const uint8_t* blob, size_t len) {
+    if (len > 0) {
+        ConfigStore::instance().putBytes("configBlob", blob, len);
+    } else {
+        ConfigStore::instance().remove("configBlob");
+    }
 }
 
 String ColdStartBle::getStoredDeviceId() {
-    Preferences preferences;
-    preferences.begin("config", true);
-    String id = preferences.getString("deviceId", "");
-    preferences.end();
-    return id;
+    return ConfigStore::instance().deviceId();
 }
 
 String ColdStartBle::getStoredFriendlyName() {
-    Preferences preferences;
-    preferences.begin("config", true);
-    String name = preferences.getString("deviceFriendlyName", "");
-    preferences.end();
-    return name;
+    return ConfigStore::instance().friendlyName();
 }
 
 void ColdStartBle::putStoredDeviceId(const String& deviceId) {
@@ -556,10 +803,7 @@ void ColdStartBle::putStoredDeviceId(const String& deviceId) {
     if (id.length() == 0) {
         return;
     }
-    Preferences preferences;
-    preferences.begin("config", false);
-    preferences.putString("deviceId", id);
-    preferences.end();
+    ConfigStore::instance().putString("deviceId", id);
 }
 
 void ColdStartBle::putStoredFriendlyName(const String& friendlyName) {
@@ -568,36 +812,25 @@ void ColdStartBle::putStoredFriendlyName(const String& friendlyName) {
     if (name.length() > 160) {
         name = name.substring(0, 160);
     }
-    Preferences preferences;
-    preferences.begin("config", false);
-    preferences.putString("deviceFriendlyName", name);
-    preferences.end();
+    ConfigStore::instance().putString("deviceFriendlyName", name);
 }
 
 bool ColdStartBle::hasStoredConfig() {
-    Preferences preferences;
-    preferences.begin("config", true); // true = read-only mode
-    bool hasConfig = preferences.isKey("configJson");
-    preferences.end();
-    return hasConfig;
+    return ConfigStore::instance().hasConfigJson();
 }
 
 bool ColdStartBle::shouldSkipBle() {
-    Preferences preferences;
-    if (!preferences.begin("config", false)) { // false = read/write mode
-        Serial.println("[ColdStartBle] ERROR: Failed to open Preferences for skipBle check");
-        return false;
-    }
-    
-    bool skipBle = preferences.getBool("skipBLE", false);
+    ConfigStore& store = ConfigStore::instance();
+    bool skipBle = store.skipBle();
     Serial.print("[ColdStartBle] Checking skipBLE flag: ");
     Serial.println(skipBle ? "TRUE (will skip BLE)" : "FALSE (will enable BLE)");
     
     if (skipBle) {
-        // Clear the flag after checking
-        preferences.remove("skipBLE");
+        // Clear the flag now rather than at sleep: a crash later in this wake
+        // must not leave BLE skipped on the next power-on as well
+        store.remove("skipBLE");
+        store.commit();
         Serial.println("[ColdStartBle] ✓ Found skipBLE flag, cleared it");
     }
-    preferences.end();
     return skipBle;
 }
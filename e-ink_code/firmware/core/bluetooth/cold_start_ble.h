@@ -4,12 +4,54 @@
 #include <Arduino.h>
 #include <esp_sleep.h>
 #include <esp_system.h>
+#include "hardware_config.h"
+
+// Advertising tiers: fast right after power-on, when someone is most likely holding
+// the phone next to the display, then progressively slower and quieter.
+#ifndef COLD_START_BLE_FAST_SECONDS
+#define COLD_START_BLE_FAST_SECONDS 10      // 20-30 ms interval, +9 dBm
+#endif
+#ifndef COLD_START_BLE_MEDIUM_SECONDS
+#define COLD_START_BLE_MEDIUM_SECONDS 30    // then 152-211 ms, +6 dBm; afterwards 1.0-1.3 s, 0 dBm
+#endif
+// How long loop() yields between BLE housekeeping passes. The CPU runs at 80 MHz during
+// the window; light sleep between BLE events only happens on a core built with
+// CONFIG_PM_ENABLE and tickless idle, which the stock Arduino core is not (the log then
+// shows "Light sleep unavailable").
+#ifndef COLD_START_BLE_IDLE_MS
+#define COLD_START_BLE_IDLE_MS 100
+#endif
+
+// Rough average currents (mA) used only for the per-window energy estimate in the log.
+// Radio figures are on top of the CPU figures.
+#ifndef BLE_EST_ADV_FAST_MA
+#define BLE_EST_ADV_FAST_MA      3.0f
+#endif
+#ifndef BLE_EST_ADV_MEDIUM_MA
+#define BLE_EST_ADV_MEDIUM_MA    0.4f
+#endif
+#ifndef BLE_EST_ADV_SLOW_MA
+#define BLE_EST_ADV_SLOW_MA      0.08f
+#endif
+#ifndef BLE_EST_CONNECTED_MA
+#define BLE_EST_CONNECTED_MA     2.0f
+#endif
+#ifndef BLE_EST_CPU_ACTIVE_MA
+#define BLE_EST_CPU_ACTIVE_MA    20.0f
+#endif
+#ifndef BLE_EST_CPU_IDLE_MA
+#define BLE_EST_CPU_IDLE_MA      12.0f
+#endif
+#ifndef BLE_EST_LIGHT_SLEEP_MA
+#define BLE_EST_LIGHT_SLEEP_MA   1.0f
+#endif
 
 /**
  * Enables Bluetooth for a short window only on cold start (power-on reset).
  * Does nothing when waking from deep sleep (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED).
  *
- * BLE stays on for up to COLD_START_BLE_WINDOW_SECONDS (60 s), or until config is received (then device restarts).
+ * BLE stays on for up to COLD_START_BLE_WINDOW_SECONDS (60 s), or until config is received
+ * (then the config is applied to the running app and rendered without a restart).
  * When a central connects, BLE remains active so it can discover services and send config.
  */
 class ColdStartBle {
@@ -38,6 +80,12 @@ public:
     /** True when BLE window is active (cold start and not yet timed out / connected). */
     bool isActive() const { return _active; }
 
+    /**
+     * Call from loop() while isActive() instead of spinning: yields for
+     * COLD_START_BLE_IDLE_MS so the idle task can light-sleep between BLE events.
+     */
+    void idle();
+
     /**
      * Get stored WiFi SSID from Preferences.
      * Returns empty string if not set.
@@ -56,13 +104,22 @@ public:
      */
     static String getStoredConfigJson();
 
+    /**
+     * Copy the compiled config blob (see app_manager/config_blob.h) into buf.
+     * Returns its length, or 0 if none is stored or it does not fit.
+     */
+    static size_t getStoredConfigBlob(uint8_t* buf, size_t cap);
+
+    /** Store (len > 0) or clear (len == 0) the compiled config blob. */
+    static void putStoredConfigBlob(const uint8_t* blob, size_t len);
+
     /**
      * Check if configuration is stored in Preferences.
      */
     static bool hasStoredConfig();
 
     /**
-     * Check if BLE should be skipped on this boot (e.g., after config-triggered restart).
+     * Check if BLE should be skipped on this boot (e.g., after a config that could not be hot-applied forced a restart).
      * Clears the flag after checking.
      */
     static bool shouldSkipBle();
@@ -84,9 +141,24 @@ public:
     static void putStoredFriendlyName(const String& friendlyName);
 
 private:
+    static const int ADV_TIER_COUNT = 3;
+
+    void applyAdvertisingTier(int tier);
+    void accountTime();
+    void endWindow(const char* reason);
+
     bool _active;
     uint32_t _startMillis;
     bool _connected;
+
+    // Advertising schedule and energy bookkeeping for the current window
+    int _tier;
+    uint32_t _lastAccountMillis;
+    uint32_t _tierMs[ADV_TIER_COUNT];
+    uint32_t _connectedMs;
+    uint32_t _idleMs;
+    bool _lightSleep;
+    uint32_t _savedCpuMhz;
 };
 
 #endif // COLD_START_BLE_H
@@ -0,0 +1,288 @@
+#include "config_store.h"
+#include <nvs.h>
+#include <freertos/task.h>
+
+static bool readString(nvs_handle_t handle, const char* key, String& out) {
+    size_t len = 0;
+    if (nvs_get_str(handle, key, nullptr, &len) != ESP_OK || len == 0) {
+        return false;
+    }
+    char* buf = static_cast<char*>(malloc(len));
+    if (buf == nullptr) {
+        return false;
+    }
+    bool ok = nvs_get_str(handle, key, buf, &len) == ESP_OK;
+    if (ok) {
+        out = buf;
+    }
+    free(buf);
+    return ok;
+}
+
+ConfigStore& ConfigStore::instance() {
+    static ConfigStore store;
+    return store;
+}
+
+ConfigStore::ConfigStore()
+    : _loaded(false), _hasConfigJson(false), _skipBle(false), _blobLen(0),
+      _stagedCount(0), _inflightCount(0), _commitInFlight(false), _inflightOk(true),
+      _nvsOpens(0), _nvsCommits(0) {
+    _commitDone = xSemaphoreCreateBinary();
+}
+
+void ConfigStore::load() {
+    if (_loaded) {
+        return;
+    }
+    _loaded = true;
+
+    nvs_handle_t handle;
+    _nvsOpens++;
+    esp_err_t err = nvs_open(CONFIG_STORE_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        // ESP_ERR_NVS_NOT_FOUND: never provisioned, every key keeps its default
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            Serial.printf("[ConfigStore] NVS open failed: %s\n", esp_err_to_name(err));
+        }
+        return;
+    }
+
+    readString(handle, "wifiSSID", _wifiSSID);
+    readString(handle, "wifiPassword", _wifiPassword);
+    readString(handle, "deviceId", _deviceId);
+    readString(handle, "deviceFriendlyName", _friendlyName);
+    _hasConfigJson = readString(handle, "configJson", _configJson);
+
+    uint8_t skip = 0;
+    _skipBle = nvs_get_u8(handle, "skipBLE", &skip) == ESP_OK && skip != 0;
+
+    size_t blobLen = 0;
+    if (nvs_get_blob(handle, "configBlob", nullptr, &blobLen) == ESP_OK &&
+        blobLen > 0 && blobLen <= sizeof(_blob) &&
+        nvs_get_blob(handle, "configBlob", _blob, &blobLen) == ESP_OK) {
+        _blobLen = blobLen;
+    }
+
+    nvs_close(handle);
+}
+
+const String& ConfigStore::wifiSSID() { load(); return _wifiSSID; }
+const String& ConfigStore::wifiPassword() { load(); return _wifiPassword; }
+const String& ConfigStore::deviceId() { load(); return _deviceId; }
+const String& ConfigStore::friendlyName() { load(); return _friendlyName; }
+const String& ConfigStore::configJson() { load(); return _configJson; }
+bool ConfigStore::hasConfigJson() { load(); return _hasConfigJson; }
+bool ConfigStore::skipBle() { load(); return _skipBle; }
+
+const uint8_t* ConfigStore::configBlob(size_t* len) {
+    load();
+    *len = _blobLen;
+    return _blobLen > 0 ? _blob : nullptr;
+}
+
+ConfigStore::Staged* ConfigStore::stage(const char* key, StagedType type) {
+    load();  // so the cache update below is not overwritten by a later lazy load
+
+    Staged* entry = nullptr;
+    for (int i = 0; i < _stagedCount; i++) {
+        if (strcmp(_staged[i].key, key) == 0) {
+            entry = &_staged[i];  // last write to a key wins
+            break;
+        }
+    }
+    if (entry == nullptr) {
+        if (_stagedCount == CONFIG_STORE_MAX_STAGED) {
+            Serial.println("[ConfigStore] Too many staged writes, committing early");
+            commit();
+        }
+        entry = &_staged[_stagedCount++];
+        strncpy(entry->key, key, sizeof(entry->key) - 1);
+        entry->key[sizeof(entry->key) - 1] = '\0';
+        entry->bytes = nullptr;
+    }
+    free(entry->bytes);
+    entry->bytes = nullptr;
+    entry->len = 0;
+    entry->str = "";
+    entry->num = 0;
+    entry->type = type;
+    return entry;
+}
+
+void ConfigStore::updateCache(const char* key, const Staged& entry) {
+    bool removed = entry.type == STAGED_REMOVE;
+    if (strcmp(key, "wifiSSID") == 0) _wifiSSID = removed ? String() : entry.str;
+    else if (strcmp(key, "wifiPassword") == 0) _wifiPassword = removed ? String() : entry.str;
+    else if (strcmp(key, "deviceId") == 0) _deviceId = removed ? String() : entry.str;
+    else if (strcmp(key, "deviceFriendlyName") == 0) _friendlyName = removed ? String() : entry.str;
+    else if (strcmp(key, "configJson") == 0) {
+        _configJson = removed ? String() : entry.str;
+        _hasConfigJson = !removed;
+    } else if (strcmp(key, "skipBLE") == 0) _skipBle = !removed && entry.num != 0;
+    else if (strcmp(key, "configBlob") == 0) {
+        _blobLen = 0;
+        if (!removed && entry.len <= sizeof(_blob)) {
+            memcpy(_blob, entry.bytes, entry.len);
+            _blobLen = entry.len;
+        }
+    }
+}
+
+void ConfigStore::putString(const char* key, const String& value) {
+    Staged* entry = stage(key, STAGED_STRING);
+    entry->str = value;
+    updateCache(key, *entry);
+}
+
+void ConfigStore::putUInt(const char* key, uint32_t value) {
+    Staged* entry = stage(key, STAGED_U32);
+    entry->num = value;
+    updateCache(key, *entry);
+}
+
+void ConfigStore::putULong64(const char* key, uint64_t value) {
+    Staged* entry = stage(key, STAGED_U64);
+    entry->num = value;
+    updateCache(key, *entry);
+}
+
+void ConfigStore::putBool(const char* key, bool value) {
+    Staged* entry = stage(key, STAGED_BOOL);
+    entry->num = value ? 1 : 0;
+    updateCache(key, *entry);
+}
+
+void ConfigStore::putBytes(const char* key, const uint8_t* data, size_t len) {
+    Staged* entry = stage(key, STAGED_BYTES);
+    entry->bytes = static_cast<uint8_t*>(malloc(len));
+    if (entry->bytes == nullptr) {
+        Serial.println("[ConfigStore] Out of memory staging blob");
+        entry->type = STAGED_REMOVE;
+    } else {
+        memcpy(entry->bytes, data, len);
+        entry->len = len;
+    }
+    updateCache(key, *entry);
+}
+
+void ConfigStore::remove(const char* key) {
+    Staged* entry = stage(key, STAGED_REMOVE);
+    updateCache(key, *entry);
+}
+
+bool ConfigStore::writeEntries(Staged* entries, int count) {
+    nvs_handle_t handle;
+    _nvsOpens++;
+    esp_err_t err = nvs_open(CONFIG_STORE_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        Serial.printf("[ConfigStore] NVS open for write failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
+
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        Staged& entry = entries[i];
+        switch (entry.type) {
+            case STAGED_STRING: err = nvs_set_str(handle, entry.key, entry.str.c_str()); break;
+            case STAGED_U32:    err = nvs_set_u32(handle, entry.key, (uint32_t)entry.num); break;
+            case STAGED_U64:    err = nvs_set_u64(handle, entry.key, entry.num); break;
+            case STAGED_BOOL:   err = nvs_set_u8(handle, entry.key, (uint8_t)entry.num); break;
+            case STAGED_BYTES:  err = nvs_set_blob(handle, entry.key, entry.bytes, entry.len); break;
+            case STAGED_REMOVE:
+                err = nvs_erase_key(handle, entry.key);
+                if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
+                break;
+        }
+        if (err != ESP_OK) {
+            Serial.printf("[ConfigStore] Write of %s failed: %s\n", entry.key, esp_err_to_name(err));
+            ok = false;
+        }
+        free(entry.bytes);
+        entry.bytes = nullptr;
+        entry.str = "";
+    }
+
+    _nvsCommits++;
+    err = nvs_commit(handle);
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        Serial.printf("[ConfigStore] NVS commit failed: %s\n", esp_err_to_name(err));
+        ok = false;
+    }
+
+    Serial.printf("[ConfigStore] Committed %d key(s)\n", count);
+    return ok;
+}
+
+bool ConfigStore::commit() {
+    bool ok = waitForCommit();
+    if (_stagedCount == 0) {
+        return ok;
+    }
+    ok = writeEntries(_staged, _stagedCount) && ok;
+    _stagedCount = 0;
+    return ok;
+}
+
+void ConfigStore::commitTask(void* arg) {
+    ConfigStore* store = static_cast<ConfigStore*>(arg);
+    store->_inflightOk = store->writeEntries(store->_inflight, store->_inflightCount);
+    store->_inflightCount = 0;
+    xSemaphoreGive(store->_commitDone);
+    vTaskDelete(nullptr);
+}
+
+bool ConfigStore::commitAsync() {
+    if (!waitForCommit()) {
+        return false;
+    }
+    if (_stagedCount == 0) {
+        return true;
+    }
+
+    // Move ownership of the staged entries to the task; new puts start a fresh batch
+    for (int i = 0; i < _stagedCount; i++) {
+        Staged& src = _staged[i];
+        Staged& dst = _inflight[i];
+        memcpy(dst.key, src.key, sizeof(dst.key));
+        dst.type = src.type;
+        dst.str = src.str;
+        dst.num = src.num;
+        dst.bytes = src.bytes;
+        dst.len = src.len;
+        src.str = "";
+        src.bytes = nullptr;
+    }
+    _inflightCount = _stagedCount;
+    _stagedCount = 0;
+    _commitInFlight = true;
+
+    if (_commitDone == nullptr ||
+        xTaskCreate(commitTask, "cfg_commit", 4096, this, 1, nullptr) != pdPASS) {
+        Serial.println("[ConfigStore] Background commit unavailable, writing now");
+        _commitInFlight = false;
+        bool ok = writeEntries(_inflight, _inflightCount);
+        _inflightCount = 0;
+        return ok;
+    }
+    return true;
+}
+
+bool ConfigStore::waitForCommit(uint32_t timeoutMs) {
+    if (!_commitInFlight) {
+        return true;
+    }
+    if (xSemaphoreTake(_commitDone, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+        Serial.println("[ConfigStore] Timed out waiting for background commit");
+        return false;
+    }
+    _commitInFlight = false;
+    return _inflightOk;
+}
+
+void ConfigStore::logStats(const char* where) const {
+    Serial.printf("[ConfigStore] %s: %u NVS open(s), %u commit(s) this wake%s\n",
+                  where, (unsigned)_nvsOpens, (unsigned)_nvsCommits,
+                  _stagedCount > 0 ? " (writes pending)" : "");
+}
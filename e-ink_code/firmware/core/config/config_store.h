@@ -0,0 +1,105 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#define CONFIG_STORE_NAMESPACE   "config"
+#define CONFIG_STORE_BLOB_MAX    2048
+#define CONFIG_STORE_MAX_STAGED  24
+
+/**
+ * In-memory view of the "config" NVS namespace.
+ *
+ * The first read loads every key the firmware uses in a single NVS open, and
+ * all later readers (WiFi credentials, device id / name for every aggregator
+ * request, stored JSON, compiled blob) are served from RAM. Writes are staged
+ * and flushed by commit() in one open + one nvs_commit; PowerManager commits
+ * before deep sleep so nothing staged during a wake is lost. commitAsync()
+ * does the same write from a background task (used after BLE hot-apply).
+ */
+class ConfigStore {
+public:
+    static ConfigStore& instance();
+
+    // Readers (lazy single-pass load on first use)
+    const String& wifiSSID();
+    const String& wifiPassword();
+    const String& deviceId();
+    const String& friendlyName();
+    const String& configJson();
+    bool hasConfigJson();
+    bool skipBle();
+    /** Compiled config blob, or nullptr (len = 0) if none is stored. */
+    const uint8_t* configBlob(size_t* len);
+
+    // Staged writes; nothing touches flash until commit()
+    void putString(const char* key, const String& value);
+    void putUInt(const char* key, uint32_t value);
+    void putULong64(const char* key, uint64_t value);
+    void putBool(const char* key, bool value);
+    void putBytes(const char* key, const uint8_t* data, size_t len);
+    void remove(const char* key);
+
+    /** Write everything staged with one NVS open and one commit. */
+    bool commit();
+    /**
+     * Hand the staged writes to a background task and return immediately.
+     * Readers keep seeing the new values; commit() and waitForCommit() wait for it.
+     */
+    bool commitAsync();
+    bool waitForCommit(uint32_t timeoutMs = 5000);
+    bool hasPendingWrites() const { return _stagedCount > 0 || _commitInFlight; }
+
+    // Per-wake NVS statistics (RAM only, reset every boot)
+    uint32_t nvsOpens() const { return _nvsOpens; }
+    uint32_t nvsCommits() const { return _nvsCommits; }
+    void logStats(const char* where) const;
+
+private:
+    ConfigStore();
+
+    enum StagedType { STAGED_STRING, STAGED_U32, STAGED_U64, STAGED_BOOL, STAGED_BYTES, STAGED_REMOVE };
+
+    struct Staged {
+        char key[16];          // NVS keys are at most 15 characters
+        StagedType type;
+        String str;
+        uint64_t num;
+        uint8_t* bytes;
+        size_t len;
+    };
+
+    void load();
+    Staged* stage(const char* key, StagedType type);
+    void updateCache(const char* key, const Staged& entry);
+    bool writeEntries(Staged* entries, int count);
+    static void commitTask(void* arg);
+
+    bool _loaded;
+    String _wifiSSID;
+    String _wifiPassword;
+    String _deviceId;
+    String _friendlyName;
+    String _configJson;
+    bool _hasConfigJson;
+    bool _skipBle;
+    uint8_t _blob[CONFIG_STORE_BLOB_MAX];
+    size_t _blobLen;
+
+    Staged _staged[CONFIG_STORE_MAX_STAGED];
+    int _stagedCount;
+
+    // Entries owned by the background commit task while _commitInFlight is set
+    Staged _inflight[CONFIG_STORE_MAX_STAGED];
+    int _inflightCount;
+    volatile bool _commitInFlight;
+    bool _inflightOk;
+    SemaphoreHandle_t _commitDone;
+
+    uint32_t _nvsOpens;
+    uint32_t _nvsCommits;
+};
+
+#endif // CONFIG_STORE_H
@@ -1,5 +1,7 @@
 #include "display_manager.h"
 #include "hardware_config.h"
+#include "frame_canvas.h"
+#include "../rtc/rtc_state_store.h"
 
 // Display object instance
 GxEPD2_3C<GxEPD2_290_C90c, GxEPD2_290_C90c::HEIGHT> display(GxEPD2_290_C90c(CS_PIN, DC_PIN, RST_PIN, BUSY_PIN));
@@ -7,6 +9,24 @@ GxEPD2_3C<GxEPD2_290_C90c, GxEPD2_290_C90c::HEIGHT> display(GxEPD2_290_C90c(CS_P
 DisplayManager::DisplayManager() : _initialized(false) {
 }
 
+ShownPanel& DisplayManager::shown() {
+    if (_shown == nullptr) {
+        _shown = rtcState().slot<ShownPanel>(RTC_SLOT_DISPLAY, SHOWN_PANEL_VERSION);
+        if (_shown == nullptr) {
+            _shown = &_volatileShown;
+        }
+    }
+    return *_shown;
+}
+
+const ShownPanel& DisplayManager::shownPanel() {
+    return shown();
+}
+
+void DisplayManager::recordShownPanel(uint16_t owner, uint32_t hash, int batteryPercent) {
+    shown().record(owner, hash, batteryPercent);
+}
+
 void DisplayManager::initSPI() {
     // ESP32-C3 has only one SPI peripheral, so we use the default SPI instance
     // Set CS pin as OUTPUT before initializing SPI
@@ -57,6 +77,11 @@ void DisplayManager::hibernate() {
 // Helper function to render text with word wrapping
 // Returns the final Y position after rendering
 int DisplayManager::renderTextWithWrap(String text, int startX, int startY, int maxWidth, int lineHeight, uint16_t textColor) {
+    return renderTextWithWrap(display, text, startX, startY, maxWidth, lineHeight, textColor);
+}
+
+int DisplayManager::renderTextWithWrap(Adafruit_GFX& gfx, String text, int startX, int startY, int maxWidth,
+                                       int lineHeight, uint16_t textColor) {
     int yPos = startY;
     int xPos = startX;
     String word = "";
@@ -96,7 +121,7 @@ int DisplayManager::renderTextWithWrap(String text, int startX, int startY, int
         String currentWord = words[i];
         int16_t x1, y1;
         uint16_t w, h;
-        display.getTextBounds(currentWord, xPos, yPos, &x1, &y1, &w, &h);
+        gfx.getTextBounds(currentWord, xPos, yPos, &x1, &y1, &w, &h);
         
         // Check if current word fits on current line
         bool fitsOnCurrentLine = (xPos + w <= maxWidth);
@@ -112,7 +137,7 @@ int DisplayManager::renderTextWithWrap(String text, int startX, int startY, int
             String nextWord = words[i + 1];
             int16_t nx1, ny1;
             uint16_t nw, nh;
-            display.getTextBounds(nextWord, xPos + w + wordSpacing, yPos, &nx1, &ny1, &nw, &nh);
+            gfx.getTextBounds(nextWord, xPos + w + wordSpacing, yPos, &nx1, &ny1, &nw, &nh);
             
             // If next word wouldn't fit, and current word is short (<= 4 chars), wrap both
             if (xPos + w + wordSpacing + nw > maxWidth && currentWord.length() <= 4) {
@@ -124,11 +149,11 @@ int DisplayManager::renderTextWithWrap(String text, int startX, int startY, int
             yPos += lineHeight;
             xPos = startX;
             // Recalculate bounds at new position
-            display.getTextBounds(currentWord, xPos, yPos, &x1, &y1, &w, &h);
+            gfx.getTextBounds(currentWord, xPos, yPos, &x1, &y1, &w, &h);
         }
         
-        display.setCursor(xPos, yPos);
-        display.print(currentWord);
+        gfx.setCursor(xPos, yPos);
+        gfx.print(currentWord);
         xPos += w + wordSpacing; // Double spacing between words
     }
     
@@ -138,6 +163,10 @@ int DisplayManager::renderTextWithWrap(String text, int startX, int startY, int
 
 // Helper function to display battery percentage in upper right corner in red
 void DisplayManager::displayBatteryPercentage(int batteryPercent) {
+    displayBatteryPercentage(display, batteryPercent);
+}
+
+void DisplayManager::displayBatteryPercentage(Adafruit_GFX& gfx, int batteryPercent) {
     if (batteryPercent < 0) return; // Skip if invalid
     
     String batteryText = String(batteryPercent) + "%";
@@ -145,21 +174,22 @@ void DisplayManager::displayBatteryPercentage(int batteryPercent) {
     // Get text bounds to position in upper right corner
     int16_t x1, y1;
     uint16_t w, h;
-    display.getTextBounds(batteryText, 0, 0, &x1, &y1, &w, &h);
+    gfx.getTextBounds(batteryText, 0, 0, &x1, &y1, &w, &h);
     
     // Position in upper right corner with padding (10 pixels from right edge, aligned with header text)
-    int displayWidth = display.width();
+    int displayWidth = gfx.width();
     int xPos = displayWidth - w - 10;
     int yPos = 20;
     
     // Display in red
-    display.setTextColor(GxEPD_RED);
-    display.setCursor(xPos, yPos);
-    display.print(batteryText);
+    gfx.setTextColor(GxEPD_RED);
+    gfx.setCursor(xPos, yPos);
+    gfx.print(batteryText);
 }
 
 // Display function specifically for earthquake facts
 void DisplayManager::displayEarthquakeFact(String earthquakeData, int batteryPercent) {
+    shown().clear();  // cleared first: an interrupted refresh leaves the panel unknown
     // Reinitialize SPI if it was disabled
     initSPI();
     display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
@@ -217,6 +247,7 @@ void DisplayManager::displayEarthquakeFact(String earthquakeData, int batteryPer
 
 // Display function for ISS data
 void DisplayManager::displayISSData(String issData, int batteryPercent) {
+    shown().clear();
     // Reinitialize SPI if it was disabled
     initSPI();
     display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
@@ -274,6 +305,7 @@ void DisplayManager::displayISSData(String issData, int batteryPercent) {
 
 // Display shown on cold boot when in BLE configuration mode
 void DisplayManager::displayBluetoothConfigMode(const char* appName) {
+    shown().clear();
     initSPI();
     display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
     display.init(115200, true, 2, false);
@@ -317,6 +349,7 @@ void DisplayManager::displayBluetoothConfigMode(const char* appName) {
 
 // Display low battery warning message
 void DisplayManager::displayLowBatteryMessage() {
+    shown().clear();
     initSPI();
     display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
     display.init(115200, true, 2, false);
@@ -348,6 +381,7 @@ void DisplayManager::displayLowBatteryMessage() {
 
 // Display config mismatch error
 void DisplayManager::displayConfigMismatchError(const char* configApp, const char* firmwareApp) {
+    shown().clear();
     initSPI();
     display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
     display.init(115200, true, 2, false);
@@ -405,6 +439,7 @@ void DisplayManager::displayConfigMismatchError(const char* configApp, const cha
 
 // Display function for text only (all black, no red header)
 void DisplayManager::displayTextOnly(String text, int batteryPercent) {
+    shown().clear();
     initSPI();
     display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
     display.init(115200, true, 2, false);
@@ -428,9 +463,38 @@ void DisplayManager::displayTextOnly(String text, int batteryPercent) {
     releaseDisplayPower();
 }
 
+// Text-only layout into an off-screen frame (no battery; displayFrame() adds it)
+void DisplayManager::renderTextOnlyFrame(FrameCanvas& canvas, const String& text) {
+    canvas.setRotation(1); // Landscape orientation, as on the panel
+    canvas.setFont(&FreeMonoBold9pt7b);
+    canvas.fillScreen(GxEPD_WHITE);
+    canvas.setTextColor(GxEPD_BLACK);
+    renderTextWithWrap(canvas, text, 10, 20, 280, 25, GxEPD_BLACK);
+}
+
+// Push a pre-rendered frame: no font or layout work beyond the battery figure
+void DisplayManager::displayFrame(FrameCanvas& canvas, int batteryPercent) {
+    shown().clear();
+    if (batteryPercent >= 0) {
+        canvas.setRotation(1);
+        canvas.setFont(&FreeMonoBold9pt7b);
+        displayBatteryPercentage(canvas, batteryPercent);
+    }
+
+    initSPI();
+    display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
+    display.init(115200, true, 2, false);
+    display.writeImage(canvas.black(), canvas.red(), 0, 0, FrameCanvas::kWidth, FrameCanvas::kHeight);
+    display.refresh(false);
+
+    display.hibernate();
+    releaseDisplayPower();
+}
+
 // Default display function for general text
 // First line in red, rest in black
 void DisplayManager::displayDefault(String text, int batteryPercent) {
+    shown().clear();
     // Reinitialize SPI if it was disabled
     initSPI();
     display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
@@ -474,3 +538,97 @@ void DisplayManager::displayDefault(String text, int batteryPercent) {
     display.hibernate();
     releaseDisplayPower();
 }
+
+// Sensor trend layout: text in the top half, sparkline band in the bottom 50 px
+void DisplayManager::displayWithSparkline(String text, const int16_t* points, int count, int16_t missingValue,
+                                          String caption, String captionRight, int batteryPercent) {
+    shown().clear();
+    // Reinitialize SPI if it was disabled
+    initSPI();
+    display.epd2.selectSPI(SPI, SPISettings(4000000, MSBFIRST, SPI_MODE0));
+    display.init(115200, true, 2, false);
+    display.setRotation(1); // Landscape orientation
+    display.setFont(&FreeMonoBold9pt7b);
+
+    const int bandTop = 80;
+    display.setFullWindow();
+    display.firstPage();
+    do {
+        display.fillScreen(GxEPD_WHITE);
+
+        if (batteryPercent >= 0) {
+            displayBatteryPercentage(batteryPercent);
+        }
+
+        int newlinePos = text.indexOf('\n');
+        String firstLine = newlinePos > 0 ? text.substring(0, newlinePos) : text;
+        String restOfText = newlinePos > 0 ? text.substring(newlinePos + 1) : "";
+        display.setTextColor(GxEPD_RED);
+        int finalY = renderTextWithWrap(firstLine, 10, 20, 280, 25, GxEPD_RED);
+        if (restOfText.length() > 0) {
+            display.setTextColor(GxEPD_BLACK);
+            renderTextWithWrap(restOfText, 10, finalY, 280, 25, GxEPD_BLACK);
+        }
+
+        // Caption in the built-in 6x8 font (cursor is the top-left corner there)
+        display.setFont(nullptr);
+        display.setTextColor(GxEPD_BLACK);
+        display.setCursor(10, bandTop);
+        display.print(caption);
+        if (captionRight.length() > 0) {
+            display.setCursor(display.width() - 10 - 6 * (int)captionRight.length(), bandTop);
+            display.print(captionRight);
+        }
+        drawSparkline(points, count, missingValue, 10, bandTop + 12, display.width() - 20, display.height() - bandTop - 16);
+        display.setFont(&FreeMonoBold9pt7b);
+    } while (display.nextPage());
+
+    display.hibernate();
+    releaseDisplayPower();
+}
+
+void DisplayManager::drawSparkline(const int16_t* points, int count, int16_t missingValue, int x, int y, int w, int h) {
+    if (points == nullptr || count < 2 || w < 2 || h < 2) {
+        return;
+    }
+    int16_t lo = INT16_MAX;
+    int16_t hi = INT16_MIN;
+    int last = -1;
+    for (int i = 0; i < count; i++) {
+        if (points[i] == missingValue) continue;
+        lo = points[i] < lo ? points[i] : lo;
+        hi = points[i] > hi ? points[i] : hi;
+        last = i;
+    }
+    if (last < 0) {
+        return;
+    }
+
+    // Dotted baseline marks the band even where there is no data
+    for (int px = x; px < x + w; px += 4) {
+        display.drawPixel(px, y + h - 1, GxEPD_BLACK);
+    }
+
+    long span = (long)hi - lo;
+    int prevX = -1;
+    int prevY = -1;
+    for (int i = 0; i < count; i++) {
+        if (points[i] == missingValue) {
+            prevX = -1;  // gap: do not bridge it
+            continue;
+        }
+        int px = x + (int)((long)i * (w - 1) / (count - 1));
+        int py = span > 0 ? y + (h - 1) - (int)(((long)points[i] - lo) * (h - 1) / span) : y + h / 2;
+        if (prevX >= 0) {
+            display.drawLine(prevX, prevY, px, py, GxEPD_BLACK);
+            display.drawLine(prevX, prevY + 1, px, py + 1, GxEPD_BLACK);
+        } else {
+            display.drawPixel(px, py, GxEPD_BLACK);
+        }
+        if (i == last) {
+            display.fillCircle(px, py, 2, GxEPD_RED);
+        }
+        prevX = px;
+        prevY = py;
+    }
+}
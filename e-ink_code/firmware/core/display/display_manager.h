@@ -6,6 +6,9 @@
 #include <Fonts/FreeMonoBold9pt7b.h>
 #include <SPI.h>
 #include "hardware_config.h"
+#include "shown_panel.h"
+
+class FrameCanvas;
 
 // GxEPD2_290_C90c is for GDEM029C90 128x296 3-color display
 extern GxEPD2_3C<GxEPD2_290_C90c, GxEPD2_290_C90c::HEIGHT> display;
@@ -19,23 +22,44 @@ public:
     // Display functions
     void displayDefault(String text, int batteryPercent = -1);
     void displayTextOnly(String text, int batteryPercent = -1);
+    // Text (title line in red) above a sparkline band along the bottom of the panel.
+    // points: oldest first, missingValue = gap. caption / captionRight: small-font line above the band.
+    void displayWithSparkline(String text, const int16_t* points, int count, int16_t missingValue,
+                              String caption, String captionRight, int batteryPercent = -1);
     void displayEarthquakeFact(String earthquakeData, int batteryPercent = -1);
     void displayISSData(String issData, int batteryPercent = -1);
     void displayBluetoothConfigMode(const char* appName = nullptr);
     void displayLowBatteryMessage();
     void displayConfigMismatchError(const char* configApp, const char* firmwareApp);
+
+    // Pre-rendered frames: lay the text out once into a FrameCanvas (same layout as
+    // displayTextOnly()), then later push it with only the battery figure drawn on top
+    void renderTextOnlyFrame(FrameCanvas& canvas, const String& text);
+    void displayFrame(FrameCanvas& canvas, int batteryPercent = -1);
     
     // Helper functions
     int renderTextWithWrap(String text, int startX, int startY, int maxWidth, int lineHeight, uint16_t textColor);
+    int renderTextWithWrap(Adafruit_GFX& gfx, String text, int startX, int startY, int maxWidth, int lineHeight,
+                           uint16_t textColor);
     void displayBatteryPercentage(int batteryPercent);
+    void displayBatteryPercentage(Adafruit_GFX& gfx, int batteryPercent);
+    void drawSparkline(const int16_t* points, int count, int16_t missingValue, int x, int y, int w, int h);
     
+    // What is on the panel (shown_panel.h). Every display*() call above clears it; an app
+    // records its content after drawing and compares against it before the next draw.
+    const ShownPanel& shownPanel();
+    void recordShownPanel(uint16_t owner, uint32_t hash, int batteryPercent);
+
     // SPI management
     void initSPI();
     void disableSPI();
 
 private:
     void releaseDisplayPower();  // Set POWER_DISPLAY_SENSOR_PIN HIGH (power off)
+    ShownPanel& shown();
     bool _initialized;
+    ShownPanel* _shown = nullptr;
+    ShownPanel _volatileShown;  // used if the RTC arena is full
 };
 
 #endif // DISPLAY_MANAGER_H
@@ -0,0 +1,61 @@
+#include "frame_canvas.h"
+
+FrameCanvas::FrameCanvas()
+    : Adafruit_GFX(kWidth, kHeight),
+      _black(static_cast<uint8_t*>(malloc(kPlaneBytes))),
+      _red(static_cast<uint8_t*>(malloc(kPlaneBytes))) {
+    if (ok()) {
+        fillScreen(GxEPD_WHITE);
+    }
+}
+
+FrameCanvas::~FrameCanvas() {
+    free(_black);
+    free(_red);
+}
+
+void FrameCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (!ok() || x < 0 || y < 0 || x >= width() || y >= height()) {
+        return;
+    }
+    // Same mapping as GxEPD2_3C::drawPixel()
+    int16_t t;
+    switch (getRotation()) {
+        case 1:
+            t = x;
+            x = kWidth - 1 - y;
+            y = t;
+            break;
+        case 2:
+            x = kWidth - 1 - x;
+            y = kHeight - 1 - y;
+            break;
+        case 3:
+            t = x;
+            x = y;
+            y = kHeight - 1 - t;
+            break;
+    }
+    size_t i = x / 8 + static_cast<size_t>(y) * (kWidth / 8);
+    uint8_t bit = 1 << (7 - x % 8);
+    if (color == GxEPD_WHITE) {
+        _black[i] |= bit;
+        _red[i] |= bit;
+    } else if (color == GxEPD_BLACK) {
+        _black[i] &= ~bit;
+        _red[i] |= bit;
+    } else {
+        _black[i] |= bit;
+        _red[i] &= ~bit;
+    }
+}
+
+void FrameCanvas::fillScreen(uint16_t color) {
+    if (!ok()) {
+        return;
+    }
+    uint8_t black = color == GxEPD_BLACK ? 0x00 : 0xFF;
+    uint8_t red = (color == GxEPD_WHITE || color == GxEPD_BLACK) ? 0xFF : 0x00;
+    memset(_black, black, kPlaneBytes);
+    memset(_red, red, kPlaneBytes);
+}
@@ -0,0 +1,37 @@
+#ifndef FRAME_CANVAS_H
+#define FRAME_CANVAS_H
+
+#include <Arduino.h>
+#include <GxEPD2_3C.h>
+
+// Off-screen 3-colour frame in the panel's native layout: a black and a red 1-bit
+// plane (bit 0 = ink), the same buffers GxEPD2 sends with writeImage(). Drawing goes
+// through Adafruit_GFX with the panel's rotation mapping, so the DisplayManager
+// layouts render into it exactly as they would onto the panel.
+class FrameCanvas : public Adafruit_GFX {
+public:
+    static const int16_t kWidth = GxEPD2_290_C90c::WIDTH;    // native (portrait)
+    static const int16_t kHeight = GxEPD2_290_C90c::HEIGHT;
+    static const size_t kPlaneBytes = (kWidth / 8) * kHeight;
+
+    FrameCanvas();
+    ~FrameCanvas();
+
+    // False when the planes could not be allocated
+    bool ok() const { return _black != nullptr && _red != nullptr; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+
+    uint8_t* black() { return _black; }
+    uint8_t* red() { return _red; }
+
+private:
+    FrameCanvas(const FrameCanvas&) = delete;
+    FrameCanvas& operator=(const FrameCanvas&) = delete;
+
+    uint8_t* _black;
+    uint8_t* _red;
+};
+
+#endif // FRAME_CANVAS_H
@@ -0,0 +1,43 @@
+#ifndef SHOWN_PANEL_H
+#define SHOWN_PANEL_H
+
+#include <stdint.h>
+
+/**
+ * What is on the panel, kept by DisplayManager in the RTC state store (RTC_SLOT_DISPLAY).
+ * The e-paper holds its image through deep sleep, so a wake that would draw the same
+ * content again can skip the refresh. Every DisplayManager draw clears the record; an
+ * app that skips identical redraws records its content after drawing, under its own
+ * owner id, so a low-battery or BLE screen or another playlist app's draw never
+ * matches. The battery figure only counts once it moved deadbandPct points.
+ */
+#define SHOWN_PANEL_VERSION 1
+
+struct ShownPanel {
+    uint16_t owner = 0;     // RTC_SLOT_* id of the app that drew it; 0 = unknown / not an app
+    uint32_t hash = 0;      // owner-defined hash of what was drawn
+    int8_t battery = -1;    // battery figure drawn, -1 = none
+
+    bool ownedBy(uint16_t app) const { return owner != 0 && owner == app; }
+
+    bool unchanged(uint16_t app, uint32_t newHash, int newBattery, int deadbandPct) const {
+        if (!ownedBy(app) || hash != newHash) {
+            return false;
+        }
+        if (newBattery < 0 || battery < 0) {
+            return (newBattery < 0) == (battery < 0);  // only both unknown counts as unchanged
+        }
+        int moved = newBattery - battery;
+        return (moved < 0 ? -moved : moved) < deadbandPct;
+    }
+
+    void record(uint16_t app, uint32_t newHash, int newBattery) {
+        owner = app;
+        hash = newHash;
+        battery = static_cast<int8_t>(newBattery < 0 ? -1 : newBattery);
+    }
+
+    void clear() { *this = ShownPanel(); }
+};
+
+#endif // SHOWN_PANEL_H
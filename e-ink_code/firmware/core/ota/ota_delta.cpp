@@ -0,0 +1,183 @@
+#include "ota_delta.h"
+
+namespace {
+const uint8_t OP_END = 0x00;
+const uint8_t OP_COPY = 0x01;
+const uint8_t OP_LITERAL = 0x02;
+const uint8_t OP_ADD = 0x03;
+
+uint32_t readLe32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+}
+
+OtaDeltaApplier::OtaDeltaApplier()
+    : _source(nullptr), _target(0), _state(STATE_FAILED), _op(0),
+      _hdrLen(0), _hdrNeeded(0), _srcOffset(0), _remaining(0),
+      _targetSize(0), _sourceSize(0), _written(0) {
+}
+
+void OtaDeltaApplier::begin(const esp_partition_t* source, esp_ota_handle_t target) {
+    _source = source;
+    _target = target;
+    _state = STATE_HEADER;
+    _hdrLen = 0;
+    _hdrNeeded = 12;
+    _written = 0;
+}
+
+bool OtaDeltaApplier::writeFn(void* ctx, const uint8_t* data, size_t len) {
+    return static_cast<OtaDeltaApplier*>(ctx)->write(data, len);
+}
+
+bool OtaDeltaApplier::fail(const char* reason) {
+    Serial.printf("[OTA] Delta: %s\n", reason);
+    _state = STATE_FAILED;
+    return false;
+}
+
+bool OtaDeltaApplier::emit(const uint8_t* data, size_t len) {
+    if (_written + len > _targetSize) {
+        return fail("patch writes past target size");
+    }
+    esp_err_t err = esp_ota_write(_target, data, len);
+    if (err != ESP_OK) {
+        Serial.printf("[OTA] Write failed: %s\n", esp_err_to_name(err));
+        _state = STATE_FAILED;
+        return false;
+    }
+    _written += len;
+    return true;
+}
+
+bool OtaDeltaApplier::copyFromSource(uint32_t offset, uint32_t len) {
+    while (len > 0) {
+        size_t n = len < kChunkSize ? len : kChunkSize;
+        if (esp_partition_read(_source, offset, _chunk, n) != ESP_OK) {
+            return fail("read from running partition failed");
+        }
+        if (!emit(_chunk, n)) {
+            return false;
+        }
+        offset += n;
+        len -= n;
+    }
+    return true;
+}
+
+// Called once the opcode's fixed arguments are in _hdr.
+bool OtaDeltaApplier::startOp() {
+    switch (_op) {
+        case OP_COPY:
+        case OP_ADD:
+            _srcOffset = readLe32(_hdr);
+            _remaining = readLe32(_hdr + 4);
+            if (_srcOffset + _remaining > _sourceSize || _srcOffset + _remaining < _srcOffset) {
+                return fail("source range out of bounds");
+            }
+            if (_op == OP_COPY) {
+                if (!copyFromSource(_srcOffset, _remaining)) {
+                    return false;
+                }
+                _state = STATE_OPCODE;
+            } else {
+                _state = _remaining > 0 ? STATE_ADD : STATE_OPCODE;
+            }
+            return true;
+        case OP_LITERAL:
+            _remaining = readLe32(_hdr);
+            _state = _remaining > 0 ? STATE_LITERAL : STATE_OPCODE;
+            return true;
+        default:
+            return fail("unknown op");
+    }
+}
+
+bool OtaDeltaApplier::write(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        switch (_state) {
+            case STATE_HEADER:
+            case STATE_ARGS: {
+                size_t n = _hdrNeeded - _hdrLen;
+                if (n > len) n = len;
+                memcpy(_hdr + _hdrLen, data, n);
+                _hdrLen += n;
+                data += n;
+                len -= n;
+                if (_hdrLen < _hdrNeeded) {
+                    break;
+                }
+                if (_state == STATE_HEADER) {
+                    if (memcmp(_hdr, "EDP1", 4) != 0) {
+                        return fail("bad patch magic");
+                    }
+                    _targetSize = readLe32(_hdr + 4);
+                    _sourceSize = readLe32(_hdr + 8);
+                    if (_sourceSize > _source->size) {
+                        return fail("patch expects a larger source image");
+                    }
+                    Serial.printf("[OTA] Delta: %u byte source -> %u byte image\n",
+                                  (unsigned)_sourceSize, (unsigned)_targetSize);
+                    _state = STATE_OPCODE;
+                } else if (!startOp()) {
+                    return false;
+                }
+                break;
+            }
+            case STATE_OPCODE:
+                _op = *data++;
+                len--;
+                if (_op == OP_END) {
+                    if (_written != _targetSize) {
+                        return fail("patch ended before target size");
+                    }
+                    _state = STATE_DONE;
+                    break;
+                }
+                _hdrLen = 0;
+                _hdrNeeded = (_op == OP_LITERAL) ? 4 : 8;
+                _state = STATE_ARGS;
+                break;
+            case STATE_LITERAL: {
+                size_t n = _remaining < len ? _remaining : len;
+                if (!emit(data, n)) {
+                    return false;
+                }
+                data += n;
+                len -= n;
+                _remaining -= n;
+                if (_remaining == 0) {
+                    _state = STATE_OPCODE;
+                }
+                break;
+            }
+            case STATE_ADD: {
+                size_t n = _remaining < len ? _remaining : len;
+                if (n > kChunkSize) n = kChunkSize;
+                if (esp_partition_read(_source, _srcOffset, _chunk, n) != ESP_OK) {
+                    return fail("read from running partition failed");
+                }
+                for (size_t i = 0; i < n; i++) {
+                    _chunk[i] = (uint8_t)(_chunk[i] + data[i]);
+                }
+                if (!emit(_chunk, n)) {
+                    return false;
+                }
+                data += n;
+                len -= n;
+                _srcOffset += n;
+                _remaining -= n;
+                if (_remaining == 0) {
+                    _state = STATE_OPCODE;
+                }
+                break;
+            }
+            case STATE_DONE:
+                // Trailing bytes after END are ignored, same as OtaInflater.
+                return true;
+            case STATE_FAILED:
+                return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef OTA_DELTA_H
+#define OTA_DELTA_H
+
+#include <Arduino.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+
+/**
+ * Applies an "EDP1" binary patch (scripts/ota_delta.py) to the running image.
+ *
+ * The inflated patch is fed in arbitrary-sized pieces; COPY/ADD ops read the
+ * matching bytes from the running app partition and the result is streamed
+ * into the OTA handle, so neither image is ever held in RAM.
+ */
+class OtaDeltaApplier {
+public:
+    OtaDeltaApplier();
+
+    void begin(const esp_partition_t* source, esp_ota_handle_t target);
+
+    /** Feed the next piece of the (already inflated) patch. Returns false on a bad patch or I/O error. */
+    bool write(const uint8_t* data, size_t len);
+
+    /** True once the END op was seen and the target size matched. */
+    bool isFinished() const { return _state == STATE_DONE; }
+
+    size_t outputBytes() const { return _written; }
+
+    /** OtaInflater::OutputFn adapter; ctx is the applier. */
+    static bool writeFn(void* ctx, const uint8_t* data, size_t len);
+
+private:
+    enum State {
+        STATE_HEADER,
+        STATE_OPCODE,
+        STATE_ARGS,
+        STATE_LITERAL,
+        STATE_ADD,
+        STATE_DONE,
+        STATE_FAILED
+    };
+
+    bool fail(const char* reason);
+    bool emit(const uint8_t* data, size_t len);
+    bool copyFromSource(uint32_t offset, uint32_t len);
+    bool startOp();
+
+    static const size_t kChunkSize = 512;
+
+    const esp_partition_t* _source;
+    esp_ota_handle_t _target;
+    State _state;
+    uint8_t _op;
+    uint8_t _hdr[12];   // magic + target size + source size, or op arguments
+    size_t _hdrLen;
+    size_t _hdrNeeded;
+    uint32_t _srcOffset;
+    uint32_t _remaining;
+    uint32_t _targetSize;
+    uint32_t _sourceSize;
+    size_t _written;
+    uint8_t _chunk[kChunkSize];
+};
+
+#endif // OTA_DELTA_H
@@ -0,0 +1,220 @@
+#include "ota_download.h"
+
+OtaDownloadPipeline::OtaDownloadPipeline()
+    : _stream(nullptr), _contentLength(-1), _chunked(false), _received(0),
+      _chunkRemaining(0), _chunkNeedsCrlf(false), _freeQueue(nullptr), _fullQueue(nullptr),
+      _abort(false), _elapsedMs(0), _sinkMs(0) {
+    _buffers[0] = nullptr;
+    _buffers[1] = nullptr;
+}
+
+OtaDownloadPipeline::~OtaDownloadPipeline() {
+    free(_buffers[0]);
+    free(_buffers[1]);
+    if (_freeQueue) vQueueDelete(_freeQueue);
+    if (_fullQueue) vQueueDelete(_fullQueue);
+}
+
+bool OtaDownloadPipeline::run(Client* stream, int contentLength, bool chunked, SinkFn sink, void* ctx) {
+    _stream = stream;
+    _contentLength = chunked ? -1 : contentLength;
+    _chunked = chunked;
+    _received = 0;
+    _chunkRemaining = 0;
+    _chunkNeedsCrlf = false;
+    _abort = false;
+    _sinkMs = 0;
+
+    if (_buffers[0] == nullptr) _buffers[0] = static_cast<uint8_t*>(malloc(kBufferSize));
+    if (_buffers[1] == nullptr) _buffers[1] = static_cast<uint8_t*>(malloc(kBufferSize));
+    if (_freeQueue == nullptr) _freeQueue = xQueueCreate(2, sizeof(uint8_t));
+    if (_fullQueue == nullptr) _fullQueue = xQueueCreate(2, sizeof(Block));
+    if (!_buffers[0] || !_buffers[1] || !_freeQueue || !_fullQueue) {
+        Serial.println("[OTA] Download: not enough heap for pipeline buffers");
+        return false;
+    }
+    xQueueReset(_freeQueue);
+    xQueueReset(_fullQueue);
+    for (uint8_t i = 0; i < 2; i++) {
+        xQueueSend(_freeQueue, &i, 0);
+    }
+
+    uint32_t start = millis();
+    // TLS reads need a few KB of stack; run at our priority so neither side starves.
+    if (xTaskCreate(&OtaDownloadPipeline::producerTask, "ota_net", 6144, this,
+                    uxTaskPriorityGet(NULL), NULL) != pdPASS) {
+        Serial.println("[OTA] Download: failed to start network task");
+        return false;
+    }
+
+    bool ok = true;
+    size_t nextProgress = 64 * 1024;
+    for (;;) {
+        Block block;
+        xQueueReceive(_fullQueue, &block, portMAX_DELAY);
+        if (block.len > 0 && ok) {
+            uint32_t t0 = millis();
+            if (!sink(ctx, _buffers[block.index], block.len)) {
+                ok = false;
+                _abort = true;  // keep draining until the network task signs off
+            }
+            _sinkMs += millis() - t0;
+        }
+        if (block.last) {
+            ok = ok && block.ok;
+            break;
+        }
+        xQueueSend(_freeQueue, &block.index, portMAX_DELAY);
+
+        if (_received >= nextProgress) {
+            if (_contentLength > 0) {
+                Serial.printf("[OTA] Progress: %u%% (%u/%d bytes)\r",
+                              (unsigned)(_received * 100 / _contentLength), (unsigned)_received, _contentLength);
+            } else {
+                Serial.printf("[OTA] Downloaded: %u bytes\r", (unsigned)_received);
+            }
+            nextProgress += 64 * 1024;
+        }
+    }
+    _elapsedMs = millis() - start;
+
+    Serial.println();
+    float kbps = _elapsedMs > 0 ? (_received / 1024.0f) / (_elapsedMs / 1000.0f) : 0.0f;
+    Serial.printf("[OTA] Download %s: %u bytes in %u ms (%.1f KB/s, %u ms in sink)\n",
+                  ok ? "complete" : "failed", (unsigned)_received, (unsigned)_elapsedMs,
+                  kbps, (unsigned)_sinkMs);
+    return ok;
+}
+
+void OtaDownloadPipeline::producerTask(void* arg) {
+    static_cast<OtaDownloadPipeline*>(arg)->produce();
+    vTaskDelete(NULL);
+}
+
+void OtaDownloadPipeline::produce() {
+    for (;;) {
+        uint8_t index;
+        xQueueReceive(_freeQueue, &index, portMAX_DELAY);
+
+        Block block = {index, 0, false, true};
+        if (_abort) {
+            block.last = true;
+        } else {
+            block.ok = fillBlock(_buffers[index], block.len, block.last);
+            if (!block.ok) {
+                block.last = true;
+            }
+        }
+        // Nothing may touch `this` after the last block: run() returns on it.
+        bool last = block.last;
+        xQueueSend(_fullQueue, &block, portMAX_DELAY);
+        if (last) {
+            return;
+        }
+    }
+}
+
+// Fills up to kBufferSize body bytes; sets `last` once the body has ended cleanly.
+bool OtaDownloadPipeline::fillBlock(uint8_t* buf, size_t& len, bool& last) {
+    len = 0;
+    last = false;
+    while (len < kBufferSize) {
+        size_t want = kBufferSize - len;
+
+        if (_chunked) {
+            if (_chunkRemaining == 0) {
+                char line[32];
+                if (_chunkNeedsCrlf && (!readLine(line, sizeof(line)) || line[0] != '\0')) {
+                    Serial.println("[OTA] Download: malformed chunk terminator");
+                    return false;
+                }
+                if (!readLine(line, sizeof(line))) {
+                    Serial.println("[OTA] Download: connection lost reading chunk size");
+                    return false;
+                }
+                char* end = nullptr;
+                _chunkRemaining = strtoul(line, &end, 16);
+                if (end == line) {
+                    Serial.println("[OTA] Download: malformed chunk size");
+                    return false;
+                }
+                _chunkNeedsCrlf = true;
+                if (_chunkRemaining == 0) {
+                    // Final chunk: skip optional trailers up to the blank line
+                    while (readLine(line, sizeof(line)) && line[0] != '\0') {
+                    }
+                    last = true;
+                    return true;
+                }
+            }
+            if (want > _chunkRemaining) want = _chunkRemaining;
+        } else if (_contentLength >= 0) {
+            size_t left = (size_t)_contentLength - _received;
+            if (left == 0) {
+                last = true;
+                return true;
+            }
+            if (want > left) want = left;
+        }
+
+        int n = readSome(buf + len, want);
+        if (n < 0) {
+            Serial.println("[OTA] Download: stream stalled");
+            return false;
+        }
+        if (n == 0) {
+            if (_chunked || _contentLength >= 0) {
+                Serial.printf("[OTA] Download: connection closed early at %u bytes\n", (unsigned)_received);
+                return false;
+            }
+            last = true;  // no length and not chunked: close marks the end of the body
+            return true;
+        }
+        len += n;
+        _received += n;
+        if (_chunked) _chunkRemaining -= n;
+    }
+    if (_contentLength >= 0 && _received == (size_t)_contentLength) {
+        last = true;
+    }
+    return true;
+}
+
+// >0 bytes read, 0 when the peer closed with nothing buffered, -1 on stall timeout.
+int OtaDownloadPipeline::readSome(uint8_t* dst, size_t want) {
+    uint32_t start = millis();
+    for (;;) {
+        int avail = _stream->available();
+        if (avail > 0) {
+            int n = _stream->read(dst, want < (size_t)avail ? want : (size_t)avail);
+            if (n > 0) {
+                return n;
+            }
+        } else if (!_stream->connected()) {
+            return 0;
+        }
+        if (_abort || millis() - start > kStallTimeoutMs) {
+            return -1;
+        }
+        vTaskDelay(1);
+    }
+}
+
+// Reads one CRLF-terminated line (without the CRLF). False on close/stall.
+bool OtaDownloadPipeline::readLine(char* line, size_t cap) {
+    size_t n = 0;
+    for (;;) {
+        uint8_t c;
+        if (readSome(&c, 1) != 1) {
+            return false;
+        }
+        if (c == '\n') {
+            if (n > 0 && line[n - 1] == '\r') n--;
+            line[n] = '\0';
+            return true;
+        }
+        if (n + 1 < cap) {
+            line[n++] = (char)c;
+        }
+    }
+}
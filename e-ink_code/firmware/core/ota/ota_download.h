@@ -0,0 +1,68 @@
+#ifndef OTA_DOWNLOAD_H
+#define OTA_DOWNLOAD_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+/**
+ * Double-buffered HTTP body reader for OTA downloads.
+ *
+ * A network task fills one buffer while the caller's task hands the other to
+ * the sink (esp_ota_write, the inflater, ...), so flash erase/write time no
+ * longer stalls the socket. The body ends on Content-Length, on the final
+ * chunk of a chunked response, or on connection close when the server sent
+ * neither; a momentarily empty socket is just waited out (up to a stall timeout).
+ */
+class OtaDownloadPipeline {
+public:
+    /** Receives body bytes in order. Return false to abort the download. */
+    typedef bool (*SinkFn)(void* ctx, const uint8_t* data, size_t len);
+
+    OtaDownloadPipeline();
+    ~OtaDownloadPipeline();
+
+    /**
+     * Streams the response body from `stream` into `sink`. Blocks until the body
+     * is complete (true) or the sink fails, the stream stalls or closes early (false).
+     * contentLength < 0 means unknown.
+     */
+    bool run(Client* stream, int contentLength, bool chunked, SinkFn sink, void* ctx);
+
+    size_t bodyBytes() const { return _received; }
+    uint32_t elapsedMs() const { return _elapsedMs; }
+    uint32_t sinkMs() const { return _sinkMs; }   // time spent in the sink (flash writes)
+
+private:
+    static const size_t kBufferSize = 4096;
+    static const uint32_t kStallTimeoutMs = 15000;
+
+    struct Block {
+        uint8_t index;
+        size_t len;
+        bool last;
+        bool ok;
+    };
+
+    static void producerTask(void* arg);
+    void produce();
+    bool fillBlock(uint8_t* buf, size_t& len, bool& last);
+    int readSome(uint8_t* dst, size_t want);
+    bool readLine(char* line, size_t cap);
+
+    Client* _stream;
+    int _contentLength;
+    bool _chunked;
+    size_t _received;
+    size_t _chunkRemaining;
+    bool _chunkNeedsCrlf;
+    uint8_t* _buffers[2];
+    QueueHandle_t _freeQueue;
+    QueueHandle_t _fullQueue;
+    volatile bool _abort;
+    uint32_t _elapsedMs;
+    uint32_t _sinkMs;
+};
+
+#endif // OTA_DOWNLOAD_H
@@ -0,0 +1,96 @@
+#include "ota_inflate.h"
+#include "sdkconfig.h"
+
+#if CONFIG_IDF_TARGET_ESP32C3
+#include "esp32c3/rom/miniz.h"
+#elif CONFIG_IDF_TARGET_ESP32S3
+#include "esp32s3/rom/miniz.h"
+#else
+#include "rom/miniz.h"
+#endif
+
+OtaInflater::OtaInflater()
+    : _decomp(nullptr), _window(nullptr), _windowOffset(0),
+      _output(nullptr), _ctx(nullptr), _inputBytes(0), _outputBytes(0),
+      _finished(false), _failed(false) {
+}
+
+OtaInflater::~OtaInflater() {
+    end();
+}
+
+bool OtaInflater::begin(OutputFn output, void* ctx) {
+    end();
+    _decomp = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+    _window = static_cast<uint8_t*>(malloc(kWindowSize));
+    if (_decomp == nullptr || _window == nullptr) {
+        Serial.println("[OTA] Inflater: not enough heap for decoder window");
+        end();
+        return false;
+    }
+    tinfl_init(_decomp);
+    _windowOffset = 0;
+    _output = output;
+    _ctx = ctx;
+    _inputBytes = 0;
+    _outputBytes = 0;
+    _finished = false;
+    _failed = false;
+    return true;
+}
+
+bool OtaInflater::write(const uint8_t* data, size_t len) {
+    if (_decomp == nullptr || _failed) {
+        return false;
+    }
+    if (_finished) {
+        // Bytes after the zlib trailer are ignored (e.g. padding from the server).
+        return true;
+    }
+
+    for (;;) {
+        size_t inBytes = len;
+        size_t outBytes = kWindowSize - _windowOffset;
+        tinfl_status status = tinfl_decompress(
+            _decomp, data, &inBytes, _window, _window + _windowOffset, &outBytes,
+            TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+
+        data += inBytes;
+        len -= inBytes;
+        _inputBytes += inBytes;
+
+        if (outBytes > 0) {
+            if (!_output(_ctx, _window + _windowOffset, outBytes)) {
+                _failed = true;
+                return false;
+            }
+            _outputBytes += outBytes;
+            _windowOffset = (_windowOffset + outBytes) & (kWindowSize - 1);
+        }
+
+        if (status < TINFL_STATUS_DONE) {
+            Serial.printf("[OTA] Inflater: corrupt stream (status %d)\n", (int)status);
+            _failed = true;
+            return false;
+        }
+        if (status == TINFL_STATUS_DONE) {
+            _finished = true;
+            return true;
+        }
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT && len == 0) {
+            return true;
+        }
+        // TINFL_STATUS_HAS_MORE_OUTPUT: window flushed, keep draining.
+    }
+}
+
+void OtaInflater::end() {
+    if (_decomp != nullptr) {
+        free(_decomp);
+        _decomp = nullptr;
+    }
+    if (_window != nullptr) {
+        free(_window);
+        _window = nullptr;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef OTA_INFLATE_H
+#define OTA_INFLATE_H
+
+#include <Arduino.h>
+
+struct tinfl_decompressor_tag;
+
+/**
+ * Streaming zlib inflater for compressed OTA images (firmware.bin.zz).
+ *
+ * Network chunks are fed through the ROM miniz decoder into a fixed 32 KB
+ * dictionary window; each span the decoder flushes is handed to the output
+ * callback (normally esp_ota_write) before the window wraps, so RAM use stays
+ * bounded no matter how large the image is.
+ */
+class OtaInflater {
+public:
+    /** Receives inflated bytes. Return false to abort the stream. */
+    typedef bool (*OutputFn)(void* ctx, const uint8_t* data, size_t len);
+
+    OtaInflater();
+    ~OtaInflater();
+
+    /** Allocates decoder state + window. Returns false when the heap is too small. */
+    bool begin(OutputFn output, void* ctx);
+
+    /** Feed the next compressed chunk. Returns false on corrupt input or output failure. */
+    bool write(const uint8_t* data, size_t len);
+
+    /** OtaDownloadPipeline sink adapter; ctx is the inflater. */
+    static bool writeFn(void* ctx, const uint8_t* data, size_t len) {
+        return static_cast<OtaInflater*>(ctx)->write(data, len);
+    }
+
+    /** True once the zlib trailer (Adler-32) has been verified. */
+    bool isFinished() const { return _finished; }
+
+    size_t inputBytes() const { return _inputBytes; }
+    size_t outputBytes() const { return _outputBytes; }
+
+    /** Frees decoder state; safe to call more than once. */
+    void end();
+
+private:
+    static const size_t kWindowSize = 32768;  // TINFL_LZ_DICT_SIZE
+
+    tinfl_decompressor_tag* _decomp;
+    uint8_t* _window;
+    size_t _windowOffset;
+    OutputFn _output;
+    void* _ctx;
+    size_t _inputBytes;
+    size_t _outputBytes;
+    bool _finished;
+    bool _failed;
+};
+
+#endif // OTA_INFLATE_H
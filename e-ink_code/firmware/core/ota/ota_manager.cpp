@@ -1,10 +1,20 @@
 #include "ota_manager.h"
+#include "../config/config_store.h"
+#include <time.h>
 
-OTAManager::OTAManager() : _initialized(false), _updating(false) {
+// time() keeps counting through deep sleep, so these pace checks across wakes.
+// Both reset on power-up, which forces a check on the first wake after a cold boot.
+RTC_DATA_ATTR static time_t s_lastCheckTime = 0;
+RTC_DATA_ATTR static char s_manifestEtag[64] = "";
+
+OTAManager::OTAManager() : _initialized(false), _updating(false),
+                           _checkIntervalSeconds(OTA_CHECK_INTERVAL_SECONDS) {
     _versionCheckUrl[0] = '\0';
     _rootCA[0] = '\0';
     _password[0] = '\0';
     _firmwareUrl[0] = '\0';
+    _compressedFirmwareUrl[0] = '\0';
+    _patchUrl[0] = '\0';
     strncpy(_currentVersion, "1.0.0", sizeof(_currentVersion) - 1);
     _currentVersion[sizeof(_currentVersion) - 1] = '\0';
 }
@@ -39,6 +49,10 @@ void OTAManager::setCurrentVersion(const char* version) {
     }
 }
 
+void OTAManager::setCheckInterval(uint32_t seconds) {
+    _checkIntervalSeconds = seconds;
+}
+
 void OTAManager::begin() {
     _initialized = true;
     Serial.println("[OTA] HTTPS OTA Manager initialized");
@@ -69,6 +83,24 @@ int OTAManager::compareVersions(const char* version1, const char* version2) {
     return 0;
 }
 
+bool OTAManager::runningImageMatches(const char* sha256Hex) {
+    if (!sha256Hex || strlen(sha256Hex) != 64) {
+        return false;
+    }
+    // For app partitions this is the digest esptool appended to the image,
+    // which is exactly what make_manifest.py publishes as "from_sha256".
+    uint8_t digest[32];
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    if (!running || esp_partition_get_sha256(running, digest) != ESP_OK) {
+        return false;
+    }
+    char hex[65];
+    for (int i = 0; i < 32; i++) {
+        sprintf(hex + i * 2, "%02x", digest[i]);
+    }
+    return strcasecmp(hex, sha256Hex) == 0;
+}
+
 bool OTAManager::checkForUpdate() {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("[OTA] WiFi not connected, cannot check for updates");
@@ -97,15 +129,33 @@ bool OTAManager::checkForUpdate() {
     if (strlen(_password) > 0) {
         http.addHeader("X-OTA-Password", _password);
     }
+    // Manifest rarely changes; let the server answer 304 without a body
+    if (s_manifestEtag[0] != '\0') {
+        http.addHeader("If-None-Match", s_manifestEtag);
+    }
+    const char* headerKeys[] = {"ETag"};
+    http.collectHeaders(headerKeys, 1);
     
     int httpCode = http.GET();
+    if (httpCode > 0) {
+        s_lastCheckTime = time(nullptr);
+    }
+
+    if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        http.end();
+        Serial.println("[OTA] Manifest unchanged (304), already on latest version");
+        return false;
+    }
     
     if (httpCode == HTTP_CODE_OK) {
+        String etag = http.header("ETag");
         String payload = http.getString();
         http.end();
         
-        // Parse JSON response: {"version": "1.2.3", "url": "https://server/firmware.bin"}
-        DynamicJsonDocument doc(512);
+        // Parse JSON response: {"version": "1.2.3", "url": "https://server/firmware.bin",
+        //                      "compressed": {"url": "https://server/firmware.bin.zz", "encoding": "zlib"},
+        //                      "patches": {"1.2.2": {"url": "...", "from_sha256": "..."}}}
+        DynamicJsonDocument doc(2048);
         DeserializationError error = deserializeJson(doc, payload);
         
         if (error) {
@@ -132,9 +182,42 @@ bool OTAManager::checkForUpdate() {
             // Store firmware URL for download
             strncpy(_firmwareUrl, firmwareUrl, sizeof(_firmwareUrl) - 1);
             _firmwareUrl[sizeof(_firmwareUrl) - 1] = '\0';
+
+            // Prefer the zlib artefact when the manifest advertises one (roughly half the airtime)
+            _compressedFirmwareUrl[0] = '\0';
+            JsonObject compressed = doc["compressed"];
+            const char* encoding = compressed["encoding"] | "zlib";
+            const char* compressedUrl = compressed["url"];
+            if (compressedUrl && strcmp(encoding, "zlib") == 0) {
+                strncpy(_compressedFirmwareUrl, compressedUrl, sizeof(_compressedFirmwareUrl) - 1);
+                _compressedFirmwareUrl[sizeof(_compressedFirmwareUrl) - 1] = '\0';
+                Serial.printf("[OTA] Compressed image available (%u bytes)\n",
+                              compressed["size"].as<unsigned>());
+            }
+
+            // A delta only applies to the exact image we are running, so check its hash too
+            _patchUrl[0] = '\0';
+            JsonObject patch = doc["patches"][_currentVersion];
+            const char* patchUrl = patch["url"];
+            if (patchUrl) {
+                if (runningImageMatches(patch["from_sha256"])) {
+                    strncpy(_patchUrl, patchUrl, sizeof(_patchUrl) - 1);
+                    _patchUrl[sizeof(_patchUrl) - 1] = '\0';
+                    Serial.printf("[OTA] Delta patch available (%u bytes)\n",
+                                  patch["size"].as<unsigned>());
+                } else {
+                    Serial.println("[OTA] Delta patch skipped: running image hash differs");
+                }
+            }
             return true;
         } else {
             Serial.println("[OTA] Already on latest version");
+            // Only cache the validator once we've acted on this manifest, so a failed
+            // update is retried instead of being masked by a 304.
+            if (etag.length() > 0 && etag.length() < sizeof(s_manifestEtag)) {
+                strncpy(s_manifestEtag, etag.c_str(), sizeof(s_manifestEtag) - 1);
+                s_manifestEtag[sizeof(s_manifestEtag) - 1] = '\0';
+            }
             return false;
         }
     } else {
@@ -144,19 +227,71 @@ bool OTAManager::checkForUpdate() {
     }
 }
 
-bool OTAManager::downloadFirmware(const char* url, esp_ota_handle_t ota_handle) {
-    WiFiClientSecure client;
-    
-    // Set root CA certificate for certificate validation
-    client.setCACert(_rootCA);
+bool OTAManager::checkOnSchedule() {
+    if (!_initialized || WiFi.status() != WL_CONNECTED) {
+        return false;
+    }
+
+    time_t now = time(nullptr);
+    if (s_lastCheckTime != 0 && now >= s_lastCheckTime &&
+        (uint32_t)(now - s_lastCheckTime) < _checkIntervalSeconds) {
+        Serial.printf("[OTA] Skipping check, last one %lus ago (interval %lus)\n",
+                      (unsigned long)(now - s_lastCheckTime), (unsigned long)_checkIntervalSeconds);
+        return false;
+    }
+
+    if (checkForUpdate()) {
+        Serial.println("[OTA] Update available, performing update...");
+        return performUpdate();
+    }
+    return false;
+}
+
+uint32_t OTAManager::secondsUntilCheck() const {
+    if (!_initialized) {
+        return UINT32_MAX;
+    }
+    time_t now = time(nullptr);
+    if (s_lastCheckTime == 0 || now < s_lastCheckTime) {
+        return 0;
+    }
+    uint32_t elapsed = (uint32_t)(now - s_lastCheckTime);
+    return elapsed >= _checkIntervalSeconds ? 0 : _checkIntervalSeconds - elapsed;
+}
+
+bool OTAManager::writeToPartition(void* ctx, const uint8_t* data, size_t len) {
+    esp_ota_handle_t ota_handle = *static_cast<esp_ota_handle_t*>(ctx);
+    esp_err_t err = esp_ota_write(ota_handle, data, len);
+    if (err != ESP_OK) {
+        Serial.printf("[OTA] Write failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+bool OTAManager::discardBytes(void* ctx, const uint8_t* data, size_t len) {
+    return true;
+}
+
+bool OTAManager::downloadFirmware(const char* url, esp_ota_handle_t ota_handle, ImageEncoding encoding) {
+    // Plain HTTP is only useful for a LAN stand-in (see scripts/ota_bench_server.py)
+    bool secure = strncmp(url, "https://", 8) == 0;
+    WiFiClient plainClient;
+    WiFiClientSecure secureClient;
+    if (secure) {
+        // Set root CA certificate for certificate validation
+        secureClient.setCACert(_rootCA);
+    }
     
     HTTPClient http;
-    http.begin(client, url);
+    http.begin(secure ? static_cast<WiFiClient&>(secureClient) : plainClient, url);
     
     // Add password as header if set
     if (strlen(_password) > 0) {
         http.addHeader("X-OTA-Password", _password);
     }
+    const char* headerKeys[] = {"Transfer-Encoding"};
+    http.collectHeaders(headerKeys, 1);
     
     int httpCode = http.GET();
     
@@ -167,40 +302,106 @@ bool OTAManager::downloadFirmware(const char* url, esp_ota_handle_t ota_handle)
     }
     
     int contentLength = http.getSize();
-    Serial.printf("[OTA] Firmware size: %d bytes\n", contentLength);
-    
-    // Read and write firmware in chunks
-    WiFiClient* stream = http.getStreamPtr();
-    uint8_t buffer[1024];
-    int totalBytes = 0;
-    int bytesRead = 0;
+    bool chunked = http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+    bool compressed = encoding == IMAGE_ZLIB || encoding == IMAGE_DELTA;
+    Serial.printf("[OTA] Firmware size: %d bytes%s%s\n", contentLength,
+                  encoding == IMAGE_DELTA ? " (delta)" : compressed ? " (zlib)" : "",
+                  chunked ? ", chunked" : "");
+
+    OtaInflater inflater;
+    OtaDeltaApplier delta;
+    OtaDownloadPipeline::SinkFn sink = &OTAManager::writeToPartition;
+    void* sinkCtx = &ota_handle;
+    bool ready = true;
+    if (encoding == IMAGE_DELTA) {
+        delta.begin(esp_ota_get_running_partition(), ota_handle);
+        ready = inflater.begin(&OtaDeltaApplier::writeFn, &delta);
+    } else if (encoding == IMAGE_ZLIB) {
+        ready = inflater.begin(&OTAManager::writeToPartition, &ota_handle);
+    } else if (encoding == IMAGE_DISCARD) {
+        sink = &OTAManager::discardBytes;
+    }
+    if (compressed) {
+        sink = &OtaInflater::writeFn;
+        sinkCtx = &inflater;
+    }
+    if (!ready) {
+        http.end();
+        return false;
+    }
     
-    while (http.connected() && (bytesRead = stream->available())) {
-        if (bytesRead > 1024) bytesRead = 1024;
-        
-        int len = stream->readBytes(buffer, bytesRead);
-        if (len > 0) {
-            esp_err_t err = esp_ota_write(ota_handle, buffer, len);
-            if (err != ESP_OK) {
-                Serial.printf("[OTA] Write failed: %s\n", esp_err_to_name(err));
-                http.end();
-                return false;
-            }
-            totalBytes += len;
-            
-            // Print progress
-            if (contentLength > 0) {
-                int progress = (totalBytes * 100) / contentLength;
-                Serial.printf("[OTA] Progress: %d%% (%d/%d bytes)\r", progress, totalBytes, contentLength);
-            } else {
-                Serial.printf("[OTA] Downloaded: %d bytes\r", totalBytes);
-            }
+    // Network reads and flash writes overlap; the pipeline decides where the body ends
+    OtaDownloadPipeline pipeline;
+    bool ok = pipeline.run(http.getStreamPtr(), contentLength, chunked, sink, sinkCtx);
+    http.end();
+    if (!ok) {
+        return false;
+    }
+
+    if (compressed) {
+        if (!inflater.isFinished()) {
+            Serial.println("[OTA] Compressed stream ended early");
+            return false;
+        }
+        Serial.printf("[OTA] Inflated %u -> %u bytes\n",
+                      (unsigned)inflater.inputBytes(), (unsigned)inflater.outputBytes());
+    }
+    if (encoding == IMAGE_DELTA) {
+        if (!delta.isFinished()) {
+            Serial.println("[OTA] Delta patch incomplete");
+            return false;
         }
+        Serial.printf("[OTA] Patched image: %u bytes\n", (unsigned)delta.outputBytes());
     }
     
-    http.end();
-    Serial.println();
+    return true;
+}
+
+bool OTAManager::benchmarkDownload(const char* url, bool writeFlash) {
+    if (WiFi.status() != WL_CONNECTED) {
+        Serial.println("[OTA] WiFi not connected");
+        return false;
+    }
+    Serial.printf("[OTA] Benchmark: %s (%s)\n", url, writeFlash ? "network + flash" : "network only");
+    if (!writeFlash) {
+        return downloadFirmware(url, 0, IMAGE_DISCARD);
+    }
+
+    // Writes the inactive slot but never marks it bootable
+    const esp_partition_t* ota_partition = esp_ota_get_next_update_partition(NULL);
+    esp_ota_handle_t ota_handle = 0;
+    if (!ota_partition || esp_ota_begin(ota_partition, OTA_SIZE_UNKNOWN, &ota_handle) != ESP_OK) {
+        Serial.println("[OTA] Benchmark: esp_ota_begin failed");
+        return false;
+    }
+    bool ok = downloadFirmware(url, ota_handle, IMAGE_RAW);
+    esp_ota_abort(ota_handle);
+    return ok;
+}
+
+bool OTAManager::flashImage(const esp_partition_t* ota_partition, const char* url, ImageEncoding encoding) {
+    esp_ota_handle_t ota_handle = 0;
     
+    // Initialize OTA
+    esp_err_t err = esp_ota_begin(ota_partition, OTA_SIZE_UNKNOWN, &ota_handle);
+    if (err != ESP_OK) {
+        Serial.printf("[OTA] esp_ota_begin failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
+    
+    // Download firmware via HTTPS
+    if (!downloadFirmware(url, ota_handle, encoding)) {
+        Serial.println("[OTA] Firmware download failed");
+        esp_ota_abort(ota_handle);
+        return false;
+    }
+    
+    // Finalize OTA (validates the written image)
+    err = esp_ota_end(ota_handle);
+    if (err != ESP_OK) {
+        Serial.printf("[OTA] esp_ota_end failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
     return true;
 }
 
@@ -222,8 +423,6 @@ bool OTAManager::performUpdate() {
     
     _updating = true;
     Serial.println("[OTA] Starting HTTPS firmware update...");
-    Serial.print("[OTA] Downloading from: ");
-    Serial.println(_firmwareUrl);
     
     // Get the next OTA partition
     const esp_partition_t* ota_partition = esp_ota_get_next_update_partition(NULL);
@@ -236,34 +435,37 @@ bool OTAManager::performUpdate() {
     Serial.print("[OTA] Writing to partition: ");
     Serial.println(ota_partition->label);
     
-    esp_ota_handle_t ota_handle = 0;
-    
-    // Initialize OTA
-    esp_err_t err = esp_ota_begin(ota_partition, OTA_SIZE_UNKNOWN, &ota_handle);
-    if (err != ESP_OK) {
-        Serial.printf("[OTA] esp_ota_begin failed: %s\n", esp_err_to_name(err));
-        _updating = false;
-        return false;
+    // Smallest artefact first: delta patch, then zlib image, then the plain image.
+    // esp_ota_end() validates each result, so a bad patch simply falls through.
+    bool flashed = false;
+    if (strlen(_patchUrl) > 0) {
+        Serial.print("[OTA] Downloading delta patch from: ");
+        Serial.println(_patchUrl);
+        flashed = flashImage(ota_partition, _patchUrl, IMAGE_DELTA);
+        if (!flashed) {
+            Serial.println("[OTA] Delta update failed, falling back to compressed image");
+        }
     }
-    
-    // Download firmware via HTTPS
-    if (!downloadFirmware(_firmwareUrl, ota_handle)) {
-        Serial.println("[OTA] Firmware download failed");
-        esp_ota_abort(ota_handle);
-        _updating = false;
-        return false;
+    if (!flashed && strlen(_compressedFirmwareUrl) > 0) {
+        Serial.print("[OTA] Downloading compressed image from: ");
+        Serial.println(_compressedFirmwareUrl);
+        flashed = flashImage(ota_partition, _compressedFirmwareUrl, IMAGE_ZLIB);
+        if (!flashed) {
+            Serial.println("[OTA] Compressed update failed, falling back to full image");
+        }
     }
-    
-    // Finalize OTA
-    err = esp_ota_end(ota_handle);
-    if (err != ESP_OK) {
-        Serial.printf("[OTA] esp_ota_end failed: %s\n", esp_err_to_name(err));
+    if (!flashed) {
+        Serial.print("[OTA] Downloading from: ");
+        Serial.println(_firmwareUrl);
+        flashed = flashImage(ota_partition, _firmwareUrl, IMAGE_RAW);
+    }
+    if (!flashed) {
         _updating = false;
         return false;
     }
     
     // Set boot partition
-    err = esp_ota_set_boot_partition(ota_partition);
+    esp_err_t err = esp_ota_set_boot_partition(ota_partition);
     if (err != ESP_OK) {
         Serial.printf("[OTA] esp_ota_set_boot_partition failed: %s\n", esp_err_to_name(err));
         _updating = false;
@@ -272,6 +474,7 @@ bool OTAManager::performUpdate() {
     
     Serial.println("[OTA] Update successful! Rebooting...");
     _updating = false;
+    ConfigStore::instance().commit();
     delay(1000);
     ESP.restart();
     
@@ -8,6 +8,15 @@
 #include <esp_ota_ops.h>
 #include <esp_partition.h>
 #include <ArduinoJson.h>
+#include "ota_inflate.h"
+#include "ota_delta.h"
+#include "ota_download.h"
+#include "hardware_config.h"
+
+// Minimum time between manifest checks; the last check time survives deep sleep in RTC memory
+#ifndef OTA_CHECK_INTERVAL_SECONDS
+#define OTA_CHECK_INTERVAL_SECONDS (6UL * 60UL * 60UL)
+#endif
 
 class OTAManager {
 public:
@@ -21,11 +30,25 @@ public:
     void setRootCA(const char* rootCA);
     void setPassword(const char* password);
     void setCurrentVersion(const char* version);
+    void setCheckInterval(uint32_t seconds);
     
     // Check for updates and perform update if available
     bool checkForUpdate();
     bool performUpdate();
 
+    // Throttled check + update for apps to call once per wake while WiFi is up.
+    // Skips the HTTPS request until the check interval has elapsed; returns true
+    // only if an update was flashed (the device restarts before returning).
+    bool checkOnSchedule();
+
+    // Seconds until checkOnSchedule() would make a request (0 = due now). Used by
+    // WakeScheduler to report and merge the check with other radio work.
+    uint32_t secondsUntilCheck() const;
+
+    // Download throughput test against a (plain HTTP) stand-in server. With
+    // writeFlash the body goes to the inactive slot, which is never made bootable.
+    bool benchmarkDownload(const char* url, bool writeFlash);
+
 private:
     bool _initialized;
     bool _updating;
@@ -34,9 +57,23 @@ private:
     char _password[64];
     char _currentVersion[32];
     char _firmwareUrl[256];
+    char _compressedFirmwareUrl[256];  // zlib image from manifest "compressed.url" (optional)
+    uint32_t _checkIntervalSeconds;
+    char _patchUrl[256];               // delta from our version, manifest "patches.<version>.url" (optional)
+
+    enum ImageEncoding {
+        IMAGE_RAW,
+        IMAGE_ZLIB,
+        IMAGE_DELTA,  // zlib-wrapped EDP1 patch against the running partition
+        IMAGE_DISCARD // benchmark only: bytes are read and dropped
+    };
     
     int compareVersions(const char* version1, const char* version2);
-    bool downloadFirmware(const char* url, esp_ota_handle_t ota_handle);
+    bool runningImageMatches(const char* sha256Hex);
+    bool downloadFirmware(const char* url, esp_ota_handle_t ota_handle, ImageEncoding encoding);
+    bool flashImage(const esp_partition_t* ota_partition, const char* url, ImageEncoding encoding);
+    static bool writeToPartition(void* ctx, const uint8_t* data, size_t len);
+    static bool discardBytes(void* ctx, const uint8_t* data, size_t len);
 };
 
 #endif // OTA_MANAGER_H
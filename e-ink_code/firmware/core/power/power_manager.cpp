@@ -1,5 +1,7 @@
 #include "power_manager.h"
 #include "hardware_config.h"
+#include "../config/config_store.h"
+#include "../rtc/rtc_state_store.h"
 
 PowerManager::PowerManager() {
 }
@@ -60,6 +62,12 @@ float PowerManager::getBatteryVoltage() {
 }
 
 void PowerManager::enterDeepSleep(uint64_t sleepTimeSeconds) {
+    // Flush config writes staged during this wake (device id, migrated blob, ...)
+    ConfigStore::instance().commit();
+    // Seal RTC state changed this wake; without this it is discarded on the next boot
+    rtcState().commit();
+    ConfigStore::instance().logStats("Sleep");
+
  #if DISABLE_DEEP_SLEEP_FOR_TESTING
     Serial.print("[TESTING] Deep sleep disabled - delaying for ");
     Serial.print(sleepTimeSeconds);
@@ -93,6 +101,7 @@ void PowerManager::enterLowBatterySleep() {
     return;
 #endif
     Serial.println("Entering low battery sleep mode (periodic wakeup to check battery)...");
+    rtcState().commit();
     
     // Disable all peripherals before sleep
     disablePeripherals();
@@ -0,0 +1,211 @@
+#include "rtc_state_store.h"
+#include <string.h>
+
+#define RTC_STATE_MAGIC 0x53435452UL  // "RTCS"
+#define RTC_SLOT_FREE   0
+#define RTC_SLOT_STALE  0x1  // SlotHeader.flags: data failed its CRC at begin()
+
+// Headers are 8-byte multiples and capacities round up to 8, so slot data is
+// aligned for any plain struct (time_t / uint64_t included)
+struct RtcStateStore::ArenaHeader {
+    uint32_t magic;
+    uint32_t buildId;
+    uint32_t used;      // bytes in use, header included
+    uint32_t crc;       // over the fields above
+};
+
+struct RtcStateStore::SlotHeader {
+    uint16_t id;
+    uint16_t version;
+    uint16_t size;      // bytes the owner asked for
+    uint16_t capacity;  // bytes reserved (size rounded up; kept when a slot shrinks)
+    uint32_t crc;       // over id/version/size/capacity and the data
+    uint32_t flags;     // this boot only, not covered by the CRC
+};
+
+static size_t roundUp8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+RtcStateStore::RtcStateStore(uint8_t* arena, size_t size)
+    : _arena(arena), _size(size), _ready(false) {
+}
+
+RtcStateStore::ArenaHeader* RtcStateStore::header() const {
+    return reinterpret_cast<ArenaHeader*>(_arena);
+}
+
+uint32_t RtcStateStore::headerCrc() const {
+    return crc32(0, _arena, offsetof(ArenaHeader, crc));
+}
+
+void RtcStateStore::sealHeader() {
+    header()->crc = headerCrc();
+}
+
+void RtcStateStore::format(uint32_t buildId) {
+    memset(_arena, 0, _size);
+    ArenaHeader* h = header();
+    h->magic = RTC_STATE_MAGIC;
+    h->buildId = buildId;
+    h->used = sizeof(ArenaHeader);
+    sealHeader();
+}
+
+static uint32_t slotCrc(const uint8_t* slotStart, size_t headerSize, uint16_t capacity) {
+    // id, version, size, capacity, then the data (skipping crc / reserved)
+    uint32_t crc = RtcStateStore::crc32(0, slotStart, 8);
+    return RtcStateStore::crc32(crc, slotStart + headerSize, capacity);
+}
+
+bool RtcStateStore::begin(uint32_t buildId, bool warm) {
+    _ready = false;
+    if (_arena == nullptr || _size < sizeof(ArenaHeader) + sizeof(SlotHeader) + 8) {
+        return false;
+    }
+
+    ArenaHeader* h = header();
+    bool kept = warm && h->magic == RTC_STATE_MAGIC && h->buildId == buildId && h->crc == headerCrc() &&
+                h->used >= sizeof(ArenaHeader) && h->used <= _size;
+
+    // Every slot header must lie inside the used area, or the chain is not trusted
+    for (size_t offset = sizeof(ArenaHeader); kept && offset < h->used;) {
+        if (offset + sizeof(SlotHeader) > h->used) {
+            kept = false;
+            break;
+        }
+        SlotHeader* s = reinterpret_cast<SlotHeader*>(_arena + offset);
+        offset += sizeof(SlotHeader) + s->capacity;
+        kept = (s->capacity % 8) == 0 && offset <= h->used;
+        // Data is checked once per boot: after this the slot is live and changes freely
+        if (kept) {
+            s->flags = s->crc == slotCrc(reinterpret_cast<uint8_t*>(s), sizeof(SlotHeader), s->capacity)
+                           ? 0 : RTC_SLOT_STALE;
+        }
+    }
+
+    if (!kept) {
+        format(buildId);
+    }
+    _ready = true;
+    return kept;
+}
+
+void* RtcStateStore::slot(uint16_t id, uint16_t version, size_t size, bool* restored) {
+    if (restored != nullptr) {
+        *restored = false;
+    }
+    if (!_ready || id == RTC_SLOT_FREE || size == 0 || size > 0xFFF8) {
+        return nullptr;
+    }
+
+    ArenaHeader* h = header();
+    for (size_t offset = sizeof(ArenaHeader); offset < h->used;) {
+        SlotHeader* s = reinterpret_cast<SlotHeader*>(_arena + offset);
+        uint8_t* data = _arena + offset + sizeof(SlotHeader);
+        offset += sizeof(SlotHeader) + s->capacity;
+        if (s->id != id) {
+            continue;
+        }
+        if (s->version == version && s->size == size && !(s->flags & RTC_SLOT_STALE)) {
+            if (restored != nullptr) {
+                *restored = true;
+            }
+            return data;
+        }
+        if (size <= s->capacity) {
+            // New layout or stale data: reuse the space, back to defaults
+            s->version = version;
+            s->size = (uint16_t)size;
+            s->flags = 0;
+            memset(data, 0, s->capacity);
+            s->crc = slotCrc(reinterpret_cast<uint8_t*>(s), sizeof(SlotHeader), s->capacity);
+            return data;
+        }
+        // Grew past its space: retire it and allocate at the end
+        s->id = RTC_SLOT_FREE;
+    }
+
+    size_t capacity = roundUp8(size);
+    if (h->used + sizeof(SlotHeader) + capacity > _size) {
+        return nullptr;
+    }
+    SlotHeader* s = reinterpret_cast<SlotHeader*>(_arena + h->used);
+    uint8_t* data = _arena + h->used + sizeof(SlotHeader);
+    memset(s, 0, sizeof(SlotHeader) + capacity);
+    s->id = id;
+    s->version = version;
+    s->size = (uint16_t)size;
+    s->capacity = (uint16_t)capacity;
+    s->crc = slotCrc(reinterpret_cast<uint8_t*>(s), sizeof(SlotHeader), s->capacity);
+    h->used += (uint32_t)(sizeof(SlotHeader) + capacity);
+    sealHeader();
+    return data;
+}
+
+void RtcStateStore::commit() {
+    if (!_ready) {
+        return;
+    }
+    ArenaHeader* h = header();
+    for (size_t offset = sizeof(ArenaHeader); offset < h->used;) {
+        SlotHeader* s = reinterpret_cast<SlotHeader*>(_arena + offset);
+        offset += sizeof(SlotHeader) + s->capacity;
+        if (s->id != RTC_SLOT_FREE) {
+            s->crc = slotCrc(reinterpret_cast<uint8_t*>(s), sizeof(SlotHeader), s->capacity);
+        }
+    }
+    sealHeader();
+}
+
+void RtcStateStore::invalidate() {
+    if (_arena != nullptr && _size >= sizeof(ArenaHeader)) {
+        header()->magic = 0;
+    }
+}
+
+size_t RtcStateStore::used() const {
+    return _ready ? header()->used : 0;
+}
+
+uint32_t RtcStateStore::crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    // Bitwise zlib CRC: the arena is a few hundred bytes, once per wake
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include <esp_ota_ops.h>
+#include <esp_system.h>
+
+// Not zeroed at boot: survives deep sleep and warm resets, garbage after power loss
+RTC_NOINIT_ATTR static uint64_t s_arena[RTC_STATE_ARENA_SIZE / 8];
+
+RtcStateStore& rtcState() {
+    static RtcStateStore store(reinterpret_cast<uint8_t*>(s_arena), sizeof(s_arena));
+    return store;
+}
+
+static uint32_t firmwareBuildId() {
+    // ELF hash of the running image: any rebuild invalidates saved layouts
+    const esp_app_desc_t* desc = esp_ota_get_app_description();
+    return RtcStateStore::crc32(0, desc->app_elf_sha256, sizeof(desc->app_elf_sha256));
+}
+
+bool rtcStateBegin() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool warm = reason == ESP_RST_DEEPSLEEP || reason == ESP_RST_SW || reason == ESP_RST_PANIC ||
+                reason == ESP_RST_INT_WDT || reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT;
+    bool kept = rtcState().begin(firmwareBuildId(), warm);
+    Serial.printf("[RtcState] %s, %u/%u bytes in use\n", kept ? "State kept" : "Formatted",
+                  (unsigned)rtcState().used(), (unsigned)rtcState().capacity());
+    return kept;
+}
+#endif
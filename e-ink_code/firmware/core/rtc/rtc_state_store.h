@@ -0,0 +1,110 @@
+#ifndef RTC_STATE_STORE_H
+#define RTC_STATE_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <type_traits>
+
+/**
+ * Typed, versioned, CRC-checked state slots in RTC memory.
+ *
+ * Small per-wake state (rotation index, hold counters, last-post dates) lives
+ * here instead of NVS: it survives deep sleep at no flash cost, and it is
+ * dropped cleanly when it cannot be trusted.
+ *
+ *  - Arena: one RTC_NOINIT_ATTR buffer (RTC_STATE_ARENA_SIZE), formatted on a
+ *    power-on / brown-out reset, when the firmware build id changes, or when
+ *    its header is corrupt. RTC_NOINIT memory holds garbage after power loss,
+ *    so nothing is trusted without the magic, build id and header CRC.
+ *  - Slots: registered by a fixed id (see RTC_SLOT_* below) with a layout
+ *    version and size. A slot comes back with its previous contents only if
+ *    id, version, size and data CRC all match; otherwise it is reset to T().
+ *  - Not locked: a slot used from a second task (AppInterface::publish) must be
+ *    registered first, before that task starts; lookups of existing slots may
+ *    then run concurrently.
+ *  - commit() reseals every slot's CRC. PowerManager calls it before deep
+ *    sleep, so state changed on a wake that then crashed or was reset is
+ *    discarded rather than half-applied.
+ *
+ * Kept free of Arduino so it can be unit tested on the host
+ * (pio test -e native); the device arena and rtcState() are at the bottom.
+ */
+
+#ifndef RTC_STATE_ARENA_SIZE
+#define RTC_STATE_ARENA_SIZE 3072
+#endif
+
+// Slot ids (keep unique; bump the struct's version instead of reusing an id)
+#define RTC_SLOT_PLAYLIST    0x0001
+#define RTC_SLOT_DISPLAY     0x0002
+#define RTC_SLOT_FUN_APP     0x0101
+#define RTC_SLOT_FUN_HOLD    0x0102
+#define RTC_SLOT_FUN_QUEUE   0x0103
+#define RTC_SLOT_SENSOR_APP  0x0201
+#define RTC_SLOT_SENSOR_HISTORY 0x0202
+#define RTC_SLOT_SHELF_APP   0x0301
+#define RTC_SLOT_MESSAGES_APP 0x0401
+
+class RtcStateStore {
+public:
+    RtcStateStore(uint8_t* arena, size_t size);
+
+    /**
+     * Validate the arena for this boot. warm = the reset kept RTC memory
+     * powered (deep sleep wake, software reset, watchdog). Returns true when the
+     * previous contents were kept, false when the arena was formatted.
+     */
+    bool begin(uint32_t buildId, bool warm);
+
+    /** Raw slot; nullptr when the arena is full or begin() has not run. */
+    void* slot(uint16_t id, uint16_t version, size_t size, bool* restored = nullptr);
+
+    template <typename T>
+    T* slot(uint16_t id, uint16_t version, bool* restored = nullptr) {
+        static_assert(std::is_trivially_copyable<T>::value, "RTC slots hold plain data");
+        bool kept = false;
+        void* p = slot(id, version, sizeof(T), &kept);
+        if (p != nullptr && !kept) {
+            new (p) T();
+        }
+        if (restored != nullptr) {
+            *restored = kept;
+        }
+        return static_cast<T*>(p);
+    }
+
+    /** Reseal every slot (call before deep sleep). */
+    void commit();
+
+    /** Forget every slot (next begin() formats). */
+    void invalidate();
+
+    bool ready() const { return _ready; }
+    size_t used() const;
+    size_t capacity() const { return _size; }
+
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+private:
+    struct ArenaHeader;
+    struct SlotHeader;
+
+    ArenaHeader* header() const;
+    void format(uint32_t buildId);
+    void sealHeader();
+    uint32_t headerCrc() const;
+
+    uint8_t* _arena;
+    size_t _size;
+    bool _ready;
+};
+
+#if defined(ARDUINO)
+/** Device store over the RTC_NOINIT arena; begun from the reset reason in setup(). */
+RtcStateStore& rtcState();
+/** Call once early in setup(). Returns true when RTC state from the last wake was kept. */
+bool rtcStateBegin();
+#endif
+
+#endif // RTC_STATE_STORE_H
@@ -0,0 +1,187 @@
+#include "sht31_engine.h"
+
+static const uint16_t kCmdSingleShotHigh = 0x2400;  // high repeatability, clock stretching off
+static const uint16_t kCmdSoftReset = 0x30A2;
+
+Sht31Engine::Sht31Engine(Sht31Transport& bus, uint8_t addr) : _bus(bus), _addr(addr) {}
+
+uint8_t Sht31Engine::crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x31) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool Sht31Engine::command(uint16_t cmd) {
+    uint8_t bytes[2] = {static_cast<uint8_t>(cmd >> 8), static_cast<uint8_t>(cmd & 0xFF)};
+    return _bus.write(_addr, bytes, sizeof(bytes));
+}
+
+bool Sht31Engine::begin() {
+    if (_ready) {
+        return true;
+    }
+    _ready = command(kCmdSoftReset);
+    if (_ready) {
+        _bus.sleepMs(2);  // soft reset takes up to 1.5 ms
+    }
+    return _ready;
+}
+
+bool Sht31Engine::measure(Sht31Sample& out, bool* crcError) {
+    if (crcError != nullptr) {
+        *crcError = false;
+    }
+    if (!command(kCmdSingleShotHigh)) {
+        return false;
+    }
+    _bus.sleepMs(kConversionMs);
+
+    uint8_t data[6];
+    bool got = _bus.read(_addr, data, sizeof(data));
+    for (uint8_t retry = 0; !got && retry < kNotReadyRetries; retry++) {
+        _bus.sleepMs(1);
+        got = _bus.read(_addr, data, sizeof(data));
+    }
+    if (!got) {
+        return false;
+    }
+    if (crc8(data, 2) != data[2] || crc8(data + 3, 2) != data[5]) {
+        if (crcError != nullptr) {
+            *crcError = true;
+        }
+        return false;
+    }
+    out.tempC = rawToTempC(static_cast<uint16_t>((data[0] << 8) | data[1]));
+    out.humidity = rawToHumidity(static_cast<uint16_t>((data[3] << 8) | data[4]));
+    return true;
+}
+
+// Small n (<= SHT31_MAX_SAMPLES): insertion sort of a copy
+static float median(const float* values, int n) {
+    float sorted[SHT31_MAX_SAMPLES];
+    for (int i = 0; i < n; i++) {
+        float v = values[i];
+        int j = i;
+        for (; j > 0 && sorted[j - 1] > v; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = v;
+    }
+    return (n % 2) ? sorted[n / 2] : 0.5f * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+static float outlierLimit(const float* values, int n, float center, float k, float floor) {
+    float deviations[SHT31_MAX_SAMPLES];
+    for (int i = 0; i < n; i++) {
+        deviations[i] = values[i] > center ? values[i] - center : center - values[i];
+    }
+    float spread = 1.4826f * median(deviations, n);
+    return k * (spread > floor ? spread : floor);
+}
+
+bool Sht31Engine::acquire(const Sht31AcquireConfig& config, Sht31Result& out) {
+    out = Sht31Result();
+    uint32_t start = _bus.nowMs();
+    if (!_ready && !begin()) {
+        out.failures = 1;
+        out.elapsedMs = _bus.nowMs() - start;
+        return false;
+    }
+
+    int maxSamples = config.maxSamples > SHT31_MAX_SAMPLES ? SHT31_MAX_SAMPLES : config.maxSamples;
+    int minSamples = config.minSamples > maxSamples ? maxSamples : config.minSamples;
+    float temps[SHT31_MAX_SAMPLES];
+    float hums[SHT31_MAX_SAMPLES];
+    int n = 0;
+    uint32_t perSample = kConversionMs + 1;
+    // Bounded attempts so a sensor that stopped answering cannot stall the wake
+    for (int attempt = 0; n < maxSamples && attempt < maxSamples + 2; attempt++) {
+        uint32_t elapsed = _bus.nowMs() - start;
+        if (n >= minSamples && elapsed + perSample > config.budgetMs) {
+            break;
+        }
+        uint32_t sampleStart = _bus.nowMs();
+        Sht31Sample sample;
+        bool crcError = false;
+        if (measure(sample, &crcError)) {
+            temps[n] = sample.tempC;
+            hums[n] = sample.humidity;
+            n++;
+        } else if (crcError) {
+            out.crcErrors++;
+        } else {
+            out.failures++;
+            if (out.failures >= 2 && n == 0) {
+                break;  // not there
+            }
+        }
+        perSample = _bus.nowMs() - sampleStart;
+    }
+    out.taken = static_cast<uint8_t>(n);
+    out.elapsedMs = _bus.nowMs() - start;
+    if (n == 0) {
+        return false;
+    }
+
+    float tempMedian = median(temps, n);
+    float humMedian = median(hums, n);
+    float tempLimit = outlierLimit(temps, n, tempMedian, config.outlierK, config.minTempSpreadC);
+    float humLimit = outlierLimit(hums, n, humMedian, config.outlierK, config.minHumiditySpread);
+    float tempSum = 0.0f;
+    float humSum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float dt = temps[i] > tempMedian ? temps[i] - tempMedian : tempMedian - temps[i];
+        float dh = hums[i] > humMedian ? hums[i] - humMedian : humMedian - hums[i];
+        if (n >= 3 && (dt > tempLimit || dh > humLimit)) {
+            out.rejected++;
+            continue;
+        }
+        tempSum += temps[i];
+        humSum += hums[i];
+        out.used++;
+    }
+    out.tempC = tempSum / out.used;
+    out.humidity = humSum / out.used;
+    return true;
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include <Wire.h>
+
+bool Sht31WireTransport::write(uint8_t addr, const uint8_t* data, size_t len) {
+    _wire.beginTransmission(addr);
+    _wire.write(data, len);
+    return _wire.endTransmission() == 0;
+}
+
+bool Sht31WireTransport::read(uint8_t addr, uint8_t* data, size_t len) {
+    if (_wire.requestFrom(addr, static_cast<uint8_t>(len)) != len) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        data[i] = static_cast<uint8_t>(_wire.read());
+    }
+    return true;
+}
+
+void Sht31WireTransport::sleepMs(uint32_t ms) {
+    // Blocks only this task: WiFi keeps associating, and idle may light-sleep under PM
+    vTaskDelay(pdMS_TO_TICKS(ms) > 0 ? pdMS_TO_TICKS(ms) : 1);
+}
+
+uint32_t Sht31WireTransport::nowMs() {
+    return millis();
+}
+
+Sht31Engine& sht31Device() {
+    static Sht31WireTransport transport(Wire);
+    static Sht31Engine engine(transport, SHT31_DEFAULT_ADDR);
+    return engine;
+}
+#endif
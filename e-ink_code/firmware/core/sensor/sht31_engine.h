@@ -0,0 +1,116 @@
+#ifndef SHT31_ENGINE_H
+#define SHT31_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * SHT31 acquisition: single-shot measurements with outlier rejection.
+ *
+ *  - One sample is one write (0x2400: single shot, high repeatability, no clock
+ *    stretching) and one 6-byte read returning temperature and humidity together,
+ *    each with its CRC-8 (poly 0x31, init 0xFF). The Adafruit driver needed a
+ *    measurement per readTemperature() / readHumidity() call.
+ *  - The engine sleeps through the conversion (15.5 ms max) via the transport; the
+ *    device transport yields the task, so WiFi association keeps running and the
+ *    idle task may light-sleep when power management is enabled. A read NACKed
+ *    because the conversion is not done yet is retried after 1 ms.
+ *  - acquire() oversamples up to maxSamples while the next sample still fits the
+ *    time budget, then drops samples further than outlierK scaled MADs from the
+ *    median (either channel) and averages the rest. Samples with a bad CRC are
+ *    discarded and counted.
+ *
+ * Kept free of Arduino so it can be unit tested on the host against a mock of the
+ * bus protocol (pio test -e native); the Wire transport is at the bottom.
+ */
+
+#define SHT31_DEFAULT_ADDR 0x44
+#define SHT31_MAX_SAMPLES 16
+
+struct Sht31Sample {
+    float tempC = 0.0f;
+    float humidity = 0.0f;
+};
+
+/** I2C access and time for the engine. */
+class Sht31Transport {
+public:
+    virtual ~Sht31Transport() {}
+    /** False when the device NACKs. */
+    virtual bool write(uint8_t addr, const uint8_t* data, size_t len) = 0;
+    /** False when the device NACKs (conversion still running) or returns fewer bytes. */
+    virtual bool read(uint8_t addr, uint8_t* data, size_t len) = 0;
+    virtual void sleepMs(uint32_t ms) = 0;
+    virtual uint32_t nowMs() = 0;
+};
+
+struct Sht31AcquireConfig {
+    uint8_t minSamples = 3;        // taken even past the budget (if the sensor answers)
+    uint8_t maxSamples = 5;        // capped at SHT31_MAX_SAMPLES
+    uint32_t budgetMs = 150;       // no new sample once the next would end past this
+    float outlierK = 3.0f;         // reject beyond k * 1.4826 * MAD from the median
+    float minTempSpreadC = 0.1f;   // MAD floor: never reject within this of the median
+    float minHumiditySpread = 0.5f;
+};
+
+struct Sht31Result {
+    float tempC = 0.0f;
+    float humidity = 0.0f;
+    uint8_t taken = 0;      // samples with a good CRC
+    uint8_t used = 0;       // after outlier rejection
+    uint8_t rejected = 0;
+    uint8_t crcErrors = 0;
+    uint8_t failures = 0;   // command NACKed or no data
+    uint32_t elapsedMs = 0;
+};
+
+class Sht31Engine {
+public:
+    static const uint32_t kConversionMs = 16;   // high repeatability: 15.5 ms max
+    static const uint8_t kNotReadyRetries = 4;  // 1 ms apart
+
+    explicit Sht31Engine(Sht31Transport& bus, uint8_t addr = SHT31_DEFAULT_ADDR);
+
+    /** Soft reset (once per boot is enough). False when nothing answers at addr. */
+    bool begin();
+    bool ready() const { return _ready; }
+
+    /** One single-shot measurement. crcError is set when the data arrived but did not check out. */
+    bool measure(Sht31Sample& out, bool* crcError = nullptr);
+
+    /** Oversample within the budget, reject outliers, average. False when no sample was good. */
+    bool acquire(const Sht31AcquireConfig& config, Sht31Result& out);
+
+    static uint8_t crc8(const uint8_t* data, size_t len);
+    static float rawToTempC(uint16_t raw) { return -45.0f + 175.0f * raw / 65535.0f; }
+    static float rawToHumidity(uint16_t raw) { return 100.0f * raw / 65535.0f; }
+
+private:
+    bool command(uint16_t cmd);
+
+    Sht31Transport& _bus;
+    uint8_t _addr;
+    bool _ready = false;
+};
+
+#if defined(ARDUINO)
+class TwoWire;
+
+/** Arduino Wire transport; conversion waits yield the task (vTaskDelay). */
+class Sht31WireTransport : public Sht31Transport {
+public:
+    explicit Sht31WireTransport(TwoWire& wire) : _wire(wire) {}
+    bool write(uint8_t addr, const uint8_t* data, size_t len) override;
+    bool read(uint8_t addr, uint8_t* data, size_t len) override;
+    void sleepMs(uint32_t ms) override;
+    uint32_t nowMs() override;
+
+private:
+    TwoWire& _wire;
+};
+
+/** The board's SHT31 on Wire. Call Wire.begin(I2C_SDA, I2C_SCL) first; begin() is run once per boot. */
+Sht31Engine& sht31Device();
+#endif
+
+#endif  // SHT31_ENGINE_H
@@ -0,0 +1,25 @@
+#include "flash_fs.h"
+#include <FS.h>
+#include <LittleFS.h>
+
+static bool s_mountTried = false;
+static bool s_mounted = false;
+
+bool flashFsMount(const char* dir) {
+    if (!s_mountTried) {
+        s_mountTried = true;
+        uint32_t startMs = millis();
+        s_mounted = LittleFS.begin(true);
+        if (s_mounted) {
+            Serial.printf("[FlashFs] LittleFS mounted in %lu ms, %u/%u bytes used\n",
+                          (unsigned long)(millis() - startMs), (unsigned)LittleFS.usedBytes(),
+                          (unsigned)LittleFS.totalBytes());
+        } else {
+            Serial.println("[FlashFs] No filesystem partition; files on flash disabled");
+        }
+    }
+    if (s_mounted && dir != nullptr && !LittleFS.exists(dir)) {
+        LittleFS.mkdir(dir);
+    }
+    return s_mounted;
+}
@@ -0,0 +1,18 @@
+#ifndef FLASH_FS_H
+#define FLASH_FS_H
+
+#include <Arduino.h>
+
+/**
+ * The LittleFS data partition ("spiffs" in partitions.csv), shared by the apps
+ * that keep files on flash (fun fact packs, pre-rendered message frames).
+ *
+ * Mounted at most once per boot, on first use; a blank partition is formatted.
+ * Devices updated over OTA from a build without the partition have none, and
+ * every call returns false.
+ */
+
+/** Mount the partition once per boot and create `dir` if it is missing. False when there is none. */
+bool flashFsMount(const char* dir = nullptr);
+
+#endif // FLASH_FS_H
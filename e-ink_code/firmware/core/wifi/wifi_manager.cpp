@@ -1,9 +1,19 @@
 #include "wifi_manager.h"
 
-WiFiManager::WiFiManager() : _initialized(false), _ssid(nullptr), _password(nullptr) {
+WiFiManager::WiFiManager() : _initialized(false), _ssid(nullptr), _password(nullptr), _connectStartMs(0) {
 }
 
 bool WiFiManager::begin(const char* ssid, const char* password) {
+    if (!beginAsync(ssid, password)) {
+        return false;
+    }
+    return waitForConnection(WIFI_CONNECT_TIMEOUT_MS);
+}
+
+bool WiFiManager::beginAsync(const char* ssid, const char* password) {
+    if (ssid == nullptr || *ssid == '\0') {
+        return false;
+    }
     _ssid = ssid;
     _password = password;
     
@@ -14,17 +24,23 @@ bool WiFiManager::begin(const char* ssid, const char* password) {
     Serial.print("[WiFi] Attempting to connect to WiFi: ");
     Serial.println(_ssid);
     
+    // WiFi.begin() copies the credentials and returns once association has started
     WiFi.begin(_ssid, _password);
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 10) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
+    _connectStartMs = millis();
+    return true;
+}
+
+bool WiFiManager::waitForConnection(uint32_t timeoutMs) {
+    // Time spent on other work since beginAsync() counts towards the timeout
+    uint32_t waitStartMs = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - _connectStartMs < timeoutMs) {
+        delay(50);
     }
-    Serial.print(" [");
-    Serial.print(attempts * 500);
-    Serial.print("ms]");
+    Serial.print("[WiFi] Association took ");
+    Serial.print(millis() - _connectStartMs);
+    Serial.print("ms (");
+    Serial.print(millis() - waitStartMs);
+    Serial.print("ms waiting)");
     
     if (WiFi.status() == WL_CONNECTED) {
         Serial.println();
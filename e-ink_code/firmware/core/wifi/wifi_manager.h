@@ -4,10 +4,19 @@
 #include <Arduino.h>
 #include <WiFi.h>
 
+#ifndef WIFI_CONNECT_TIMEOUT_MS
+#define WIFI_CONNECT_TIMEOUT_MS 5000
+#endif
+
 class WiFiManager {
 public:
     WiFiManager();
     bool begin(const char* ssid, const char* password);
+    // Non-blocking connect: start association and return, so local work can run
+    // while the radio joins; waitForConnection() then blocks for the remainder.
+    // begin() is beginAsync() + waitForConnection(WIFI_CONNECT_TIMEOUT_MS).
+    bool beginAsync(const char* ssid, const char* password);
+    bool waitForConnection(uint32_t timeoutMs = WIFI_CONNECT_TIMEOUT_MS);
     void disconnect();
     bool isConnected();
     int getRSSI();
@@ -18,6 +27,7 @@ private:
     bool _initialized;
     const char* _ssid;
     const char* _password;
+    uint32_t _connectStartMs;
     
     String getWifiStatusString(wl_status_t status);
 };
@@ -4,7 +4,11 @@
 #include "core/power/power_manager.h"
 #include "core/ota/ota_manager.h"
 #include "core/bluetooth/cold_start_ble.h"
+#include "core/config/config_store.h"
+#include "core/rtc/rtc_state_store.h"
 #include "app_manager/app_manager.h"
+#include "app_manager/config_blob.h"
+#include "app_manager/config_transform.h"
 #include <ArduinoJson.h>
 // Include only selected apps (or all if no APP_* flags, for default env)
 #if defined(APP_FUN)
@@ -77,6 +81,56 @@ MessagesApp messagesApp;
 const char* TEST_CONFIG_JSON =
     "{\"app\": \"" DEFAULT_APP_NAME "\", \"config\": {}}";
 
+static uint8_t s_configBlob[CONFIG_BLOB_MAX];
+
+// JSON path: first boot after provisioning with older firmware, or when the blob is
+// missing/invalid. Compiles the result so the next wake takes the blob path.
+static void loadConfigFromJson() {
+    // Try to load configuration from Preferences (stored via BLE)
+    String storedConfigJson = ColdStartBle::getStoredConfigJson();
+    if (storedConfigJson.length() > 0) {
+        Serial.println("[Main] Found stored configuration from BLE");
+        Serial.print("[Main] Config JSON: ");
+        Serial.println(storedConfigJson);
+        
+        // The stored config format is: {"mode":"fun","timestamp":...,"refreshInterval":60,"apis":{...},"wifiSSID":"...","wifiPassword":"..."}
+        // We need to convert it to app manager format: {"app":"fun","config":{...}}
+        String appConfigJson;
+        if (transformStoredConfig(storedConfigJson.c_str(), appConfigJson)) {
+            Serial.print("[Main] Transformed config: ");
+            Serial.println(appConfigJson);
+            
+            // Try to configure with the stored config
+            // If the app doesn't exist, silently fall back to default (this is loading from NVS, not receiving via BLE)
+            if (appManager.configureFromJson(appConfigJson.c_str())) {
+                Serial.println("[Main] Stored configuration loaded successfully");
+                // Migrate configs provisioned before compiled blobs existed
+                size_t blobLen = appManager.compileConfigBlob(s_configBlob, sizeof(s_configBlob));
+                if (blobLen > 0) {
+                    ColdStartBle::putStoredConfigBlob(s_configBlob, blobLen);
+                }
+            } else {
+                // Requested app not in firmware - silently fall back to default
+                Serial.print("[Main] Requested app not in firmware, using default app: ");
+                Serial.println(DEFAULT_APP_NAME);
+                appManager.setActiveApp(DEFAULT_APP_NAME);
+            }
+        } else {
+            Serial.println("[Main] Failed to parse stored config, using default");
+            appManager.setActiveApp(DEFAULT_APP_NAME);
+        }
+    } else {
+        Serial.println("[Main] No stored configuration found, using test config");
+        // Configure from JSON (for testing)
+        if (appManager.configureFromJson(TEST_CONFIG_JSON)) {
+            Serial.println("[Main] Test configuration loaded successfully");
+        } else {
+            Serial.println("[Main] Configuration failed, using default");
+            appManager.setActiveApp(DEFAULT_APP_NAME);
+        }
+    }
+}
+
 void setup() {
     Serial.begin(115200);
     
@@ -106,6 +160,8 @@ void setup() {
     }
     Serial.print("[Main] Reset reason: ");
     Serial.println((int)reset_reason);
+    // Before anything registers RTC state slots (apps, playlist)
+    rtcStateBegin();
     Serial.print("[Main] Free heap: ");
     Serial.println(ESP.getFreeHeap());
     Serial.print("[Main] Display rail pin (");
@@ -151,7 +207,8 @@ void setup() {
     }
 
     // Decide whether we will run BLE on this boot, and consume skipBLE flag once.
-    bool skipBle = ColdStartBle::shouldSkipBle();
+    // Timer wakes never run BLE, so they do not need to look at NVS for it.
+    bool skipBle = (reset_reason != ESP_RST_DEEPSLEEP) && ColdStartBle::shouldSkipBle();
     bool willRunBle = (!skipBle && reset_reason != ESP_RST_DEEPSLEEP);
     Serial.print("[Main] willRunBle: ");
     Serial.println(willRunBle ? "TRUE" : "FALSE");
@@ -180,6 +237,28 @@ void setup() {
     appManager.setDisplayManager(&displayManager);
     appManager.setPowerManager(&powerManager);
     appManager.setOTAManager(&otaManager);
+
+    // OTA is configured once here; the WakeScheduler runs the check in app WiFi sessions
+    otaManager.setVersionCheckUrl(OTA_VERSION_CHECK_URL);
+    otaManager.setRootCA(ROOT_CA_CERT);
+    otaManager.setPassword(OTA_PASSWORD);
+    otaManager.setCurrentVersion(FIRMWARE_VERSION);
+    otaManager.setCheckInterval(OTA_CHECK_INTERVAL_SECONDS);
+    otaManager.begin();
+
+#ifdef OTA_BENCH_URL
+    // Developer hook (-DOTA_BENCH_URL=\"http://host:8000/firmware.bin\"): measure download
+    // throughput against scripts/ota_bench_server.py, network-only then with flash writes.
+    {
+        String benchSsid = ColdStartBle::getStoredWiFiSSID();
+        String benchPassword = ColdStartBle::getStoredWiFiPassword();
+        if (benchSsid.length() > 0 && wifiManager.begin(benchSsid.c_str(), benchPassword.c_str())) {
+            otaManager.benchmarkDownload(OTA_BENCH_URL, false);
+            otaManager.benchmarkDownload(OTA_BENCH_URL, true);
+            wifiManager.disconnect();
+        }
+    }
+#endif
     
     // Register only the apps included in this build
 #if defined(APP_FUN)
@@ -201,196 +280,26 @@ void setup() {
     appManager.registerApp(&messagesApp, "messages");
 #endif
 
-    // Try to load configuration from Preferences (stored via BLE)
-    String storedConfigJson = ColdStartBle::getStoredConfigJson();
-    if (storedConfigJson.length() > 0) {
-        Serial.println("[Main] Found stored configuration from BLE");
-        Serial.print("[Main] Config JSON: ");
-        Serial.println(storedConfigJson);
-        
-        // Parse and apply the stored config
-        // The stored config format is: {"mode":"fun","timestamp":...,"refreshInterval":60,"apis":{...},"wifiSSID":"...","wifiPassword":"..."}
-        // We need to convert it to app manager format: {"app":"fun","config":{...}}
-        // For now, let's use ArduinoJson to transform it
-        DynamicJsonDocument storedDoc(2048);
-        DeserializationError error = deserializeJson(storedDoc, storedConfigJson);
-        
-        if (!error && storedDoc.containsKey("mode")) {
-            // Create app manager format
-            DynamicJsonDocument appDoc(2048);
-            appDoc["app"] = storedDoc["mode"];
-            
-            // Copy config fields (refreshInterval, apis, sensor app fields, etc.) to config object
-            JsonObject config = appDoc.createNestedObject("config");
-            if (storedDoc.containsKey("refreshInterval")) {
-                config["refreshInterval"] = storedDoc["refreshInterval"];
-            }
-            if (storedDoc.containsKey("apis")) {
-                config["apis"] = storedDoc["apis"];
-            }
-            // Sensor app: temperature units (C/F), nemo token/url/sensor ID, location
-            if (storedDoc.containsKey("units")) {
-                config["units"] = storedDoc["units"];
-            } else if (storedDoc.containsKey("temperatureUnit")) {
-                config["units"] = storedDoc["temperatureUnit"];
-            }
-            if (storedDoc.containsKey("nemoToken")) {
-                config["nemoToken"] = storedDoc["nemoToken"];
-            } else if (storedDoc.containsKey("nemo_token")) {
-                config["nemoToken"] = storedDoc["nemo_token"];
-            }
-            if (storedDoc.containsKey("nemoUrl")) {
-                config["nemoUrl"] = storedDoc["nemoUrl"];
-            } else if (storedDoc.containsKey("nemo_url")) {
-                config["nemoUrl"] = storedDoc["nemo_url"];
-            } else if (storedDoc.containsKey("nemoApiEndpoint")) {
-                config["nemoUrl"] = storedDoc["nemoApiEndpoint"];
-            }
-            // Handle temperature and humidity sensor IDs separately
-            if (storedDoc.containsKey("temperatureSensorId")) {
-                config["temperatureSensorId"] = storedDoc["temperatureSensorId"];
-            } else if (storedDoc.containsKey("temperature_sensor_id")) {
-                config["temperatureSensorId"] = storedDoc["temperature_sensor_id"];
-            }
-            if (storedDoc.containsKey("humiditySensorId")) {
-                config["humiditySensorId"] = storedDoc["humiditySensorId"];
-            } else if (storedDoc.containsKey("humidity_sensor_id")) {
-                config["humiditySensorId"] = storedDoc["humidity_sensor_id"];
-            }
-            if (storedDoc.containsKey("batterySensorId")) {
-                config["batterySensorId"] = storedDoc["batterySensorId"];
-            } else if (storedDoc.containsKey("battery_sensor_id")) {
-                config["batterySensorId"] = storedDoc["battery_sensor_id"];
-            }
-            // Legacy support for single sensorId (for backwards compatibility)
-            if (storedDoc.containsKey("sensorId") && !config.containsKey("temperatureSensorId")) {
-                config["temperatureSensorId"] = storedDoc["sensorId"];
-            } else if (storedDoc.containsKey("sensor_id") && !config.containsKey("temperatureSensorId")) {
-                config["temperatureSensorId"] = storedDoc["sensor_id"];
-            } else if (storedDoc.containsKey("nemoSensorId") && !config.containsKey("temperatureSensorId")) {
-                config["temperatureSensorId"] = storedDoc["nemoSensorId"];
-            }
-            if (storedDoc.containsKey("sensorLocation")) {
-                config["sensorLocation"] = storedDoc["sensorLocation"];
-            } else if (storedDoc.containsKey("sensor_location")) {
-                config["sensorLocation"] = storedDoc["sensor_location"];
-            }
-            if (storedDoc.containsKey("timeServer")) {
-                config["timeServer"] = storedDoc["timeServer"];
-            } else if (storedDoc.containsKey("time_server")) {
-                config["timeServer"] = storedDoc["time_server"];
-            }
-            // Timezone selection for DST-aware local time (preferred)
-            if (storedDoc.containsKey("timeZone")) {
-                config["timeZone"] = storedDoc["timeZone"];
-            } else if (storedDoc.containsKey("timezone")) {
-                config["timeZone"] = storedDoc["timezone"];
-            } else if (storedDoc.containsKey("time_zone")) {
-                config["timeZone"] = storedDoc["time_zone"];
-            }
-            if (storedDoc.containsKey("gmtOffsetSec")) {
-                config["gmtOffsetSec"] = storedDoc["gmtOffsetSec"];
-            }
-            if (storedDoc.containsKey("daylightOffsetSec")) {
-                config["daylightOffsetSec"] = storedDoc["daylightOffsetSec"];
-            }
-            // Shelf app: bin ID, server host, server port
-            if (storedDoc.containsKey("binId")) {
-                config["binId"] = storedDoc["binId"];
-            } else if (storedDoc.containsKey("bin_id")) {
-                config["binId"] = storedDoc["bin_id"];
-            }
-            if (storedDoc.containsKey("serverHost")) {
-                config["serverHost"] = storedDoc["serverHost"];
-            } else if (storedDoc.containsKey("server_host")) {
-                config["serverHost"] = storedDoc["server_host"];
-            }
-            if (storedDoc.containsKey("serverPort")) {
-                config["serverPort"] = storedDoc["serverPort"];
-            } else if (storedDoc.containsKey("server_port")) {
-                config["serverPort"] = storedDoc["server_port"];
-            }
-            // Device identity (friendly name + optional phone-mint UUID) for fun aggregator / messaging
-            if (storedDoc.containsKey("displayName")) {
-                config["displayName"] = storedDoc["displayName"];
-            } else if (storedDoc.containsKey("deviceFriendlyName")) {
-                config["displayName"] = storedDoc["deviceFriendlyName"];
-            } else if (storedDoc.containsKey("friendly_name")) {
-                config["displayName"] = storedDoc["friendly_name"];
-            }
-            if (storedDoc.containsKey("deviceId")) {
-                config["deviceId"] = storedDoc["deviceId"];
-            } else if (storedDoc.containsKey("device_id")) {
-                config["deviceId"] = storedDoc["device_id"];
-            }
-            // Messages app: array of up to 10 messages
-            if (storedDoc.containsKey("messages") && storedDoc["messages"].is<JsonArray>()) {
-                config["messages"] = storedDoc["messages"];
-            } else {
-                bool hasMessage = false;
-                JsonArray msgArr;
-                for (int i = 1; i <= 10; i++) {
-                    String key = "message" + String(i);
-                    if (storedDoc.containsKey(key.c_str())) {
-                        if (!hasMessage) {
-                            msgArr = config.createNestedArray("messages");
-                            hasMessage = true;
-                        }
-                        msgArr.add(storedDoc[key.c_str()]);
-                    }
-                }
-            }
-            // Legacy support: if serverUrl is provided, try to parse it
-            if (storedDoc.containsKey("serverUrl") || storedDoc.containsKey("server_url")) {
-                String serverUrl = storedDoc.containsKey("serverUrl") 
-                    ? storedDoc["serverUrl"].as<const char*>()
-                    : storedDoc["server_url"].as<const char*>();
-                // Try to parse URL format: http://host:port or host:port
-                int protocolEnd = serverUrl.indexOf("://");
-                String hostPort = (protocolEnd >= 0) ? serverUrl.substring(protocolEnd + 3) : serverUrl;
-                int colonPos = hostPort.indexOf(':');
-                if (colonPos > 0) {
-                    config["serverHost"] = hostPort.substring(0, colonPos);
-                    config["serverPort"] = hostPort.substring(colonPos + 1).toInt();
-                } else {
-                    config["serverHost"] = hostPort;
-                }
-            }
-            
-            String appConfigJson;
-            serializeJson(appDoc, appConfigJson);
-            
-            Serial.print("[Main] Transformed config: ");
-            Serial.println(appConfigJson);
-            
-            // Try to configure with the stored config
-            // If the app doesn't exist, silently fall back to default (this is loading from NVS, not receiving via BLE)
-            if (appManager.configureFromJson(appConfigJson.c_str())) {
-                Serial.println("[Main] Stored configuration loaded successfully");
-            } else {
-                // Requested app not in firmware - silently fall back to default
-                Serial.print("[Main] Requested app not in firmware, using default app: ");
-                Serial.println(DEFAULT_APP_NAME);
-                appManager.setActiveApp(DEFAULT_APP_NAME);
-            }
-        } else {
-            Serial.println("[Main] Failed to parse stored config, using default");
-            appManager.setActiveApp(DEFAULT_APP_NAME);
-        }
+    // Timer wakes: config only changes through provisioning, which refreshes the
+    // snapshot, so restore it and skip NVS entirely.
+    if (reset_reason == ESP_RST_DEEPSLEEP && appManager.restoreRtcSnapshot()) {
+        Serial.println("[Main] Configuration restored from RTC snapshot");
     } else {
-        Serial.println("[Main] No stored configuration found, using test config");
-        // Configure from JSON (for testing)
-        if (appManager.configureFromJson(TEST_CONFIG_JSON)) {
-            Serial.println("[Main] Test configuration loaded successfully");
+        // Fast path: compiled config blob written at provisioning time (no JSON work)
+        size_t configBlobLen = 0;
+        const uint8_t* configBlob = ConfigStore::instance().configBlob(&configBlobLen);
+        if (configBlob != nullptr && appManager.applyConfigBlob(configBlob, configBlobLen)) {
+            Serial.println("[Main] Compiled configuration loaded");
         } else {
-            Serial.println("[Main] Configuration failed, using default");
-            appManager.setActiveApp(DEFAULT_APP_NAME);
+            loadConfigFromJson();
         }
+        appManager.saveRtcSnapshot();
     }
     
     // Begin the active app
     appManager.begin();
 
+    ConfigStore::instance().logStats("Setup");
     Serial.print("[Main] setup() complete in ms=");
     Serial.println((uint32_t)(millis() - bootStartMs));
     Serial.println("==========================");
@@ -400,6 +309,14 @@ void loop() {
     // Cold-start BLE: disable after window timeout or first connection
     coldStartBle.loop();
 
+    // While BLE config mode is active, keep showing the config screen (don't run app loop)
+    // and sleep between BLE events instead of spinning. Battery was checked in setup().
+    // After BLE times out or config is received, run the app and it will update the display.
+    if (coldStartBle.isActive()) {
+        coldStartBle.idle();
+        return;
+    }
+
     // Check battery level before running app
     int batteryPercent = powerManager.getBatteryPercentage();
     if (batteryPercent <= BATTERY_LOW_THRESHOLD_PERCENT) {
@@ -412,12 +329,7 @@ void loop() {
         return;
     }
 
-    // While BLE config mode is active, keep showing the config screen (don't run app loop).
-    // After BLE times out or config is received, run the app and it will update the display.
-    if (!coldStartBle.isActive()) {
-        appManager.loop();
-    }
-
-    // Note: Individual apps handle their own sleep/wake cycles
-    // The app manager just coordinates which app is running
+    // One app cycle (acquire/fetch/render/publish), then deep sleep via the scheduler.
+    // The battery reading is reused so the cycle doesn't sample the ADC again.
+    appManager.loop(batteryPercent);
 }
@@ -0,0 +1,260 @@
+// Host shim for scripts/simulate_energy.py: pio run -e sim
+//
+// The simulator's app models call into the firmware's own decision code through this
+// program instead of keeping Python copies of it: the SHT31 engine (against a mock of
+// the bus on a virtual clock), the sensor repaint policy and history, the message frame
+// signature and DisplayManager's shown-panel record (one per device, as on the panel).
+//
+// One command per line on stdin, one reply line on stdout:
+//   seed <n>
+//   sht31 <minSamples> <maxSamples> <budgetMs> <busMs> <tempC> <humidity>
+//       -> <ok> <taken> <elapsedMs> <tempC> <humidity>   (begin() + acquire(), as on a wake)
+//   sensor <id> <tempDeadbandC> <humidityDeadband> <minSec> <maxSec> <T|D|O> <showHistory>
+//       -> ok
+//   sensor_wake <id> <now> <readOk> <wifi> <battery> <tempC> <humidity>
+//       -> <sensorRepaintName()>                          (SensorApp::acquire + render; <id> is the panel owner)
+//   shown <owner> <hash> <battery> <deadbandPct>
+//       -> kept | changed                                 (ShownPanel::unchanged())
+//   draw                                                  (any DisplayManager draw clears the record)
+//       -> ok
+//   record <owner> <hash> <battery>                       (the app recorded what it drew)
+//       -> ok
+//   signature <hex of the UTF-8 text>
+//       -> <messageFrameSignature()>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <map>
+#include <random>
+#include <string>
+#include "../core/sensor/sht31_engine.h"
+#include "../core/display/shown_panel.h"
+#include "../apps/sensor/repaint_policy.h"
+#include "../apps/sensor/history.h"
+#include "../apps/messages/frame_codec.h"
+
+// Single-shot protocol on a virtual clock, readings around the room's true value
+class SimSht31 : public Sht31Transport {
+public:
+    uint32_t clock = 0;
+    uint32_t busMs = 1;            // one I2C transaction
+    uint32_t conversionMs = 13;    // datasheet typical for high repeatability
+    float tempC = 21.0f;
+    float humidity = 45.0f;
+    std::mt19937 rng{1};
+
+    bool write(uint8_t addr, const uint8_t* data, size_t len) override {
+        clock += busMs;
+        if (addr != SHT31_DEFAULT_ADDR || len != 2) {
+            return false;
+        }
+        if (data[0] == 0x24 && data[1] == 0x00) {
+            _measuring = true;
+            _startedAt = clock;
+        }
+        return true;
+    }
+
+    bool read(uint8_t addr, uint8_t* data, size_t len) override {
+        clock += busMs;
+        if (addr != SHT31_DEFAULT_ADDR || len != 6 || !_measuring || clock - _startedAt < conversionMs) {
+            return false;
+        }
+        _measuring = false;
+        std::normal_distribution<float> tempNoise(0.0f, 0.02f), humidityNoise(0.0f, 0.1f);
+        float t = tempC + tempNoise(rng);
+        float h = humidity + humidityNoise(rng);
+        uint16_t rawT = static_cast<uint16_t>(lroundf((t + 45.0f) / 175.0f * 65535.0f));
+        uint16_t rawH = static_cast<uint16_t>(lroundf(fminf(fmaxf(h, 0.0f), 100.0f) / 100.0f * 65535.0f));
+        data[0] = rawT >> 8;
+        data[1] = rawT & 0xFF;
+        data[2] = Sht31Engine::crc8(data, 2);
+        data[3] = rawH >> 8;
+        data[4] = rawH & 0xFF;
+        data[5] = Sht31Engine::crc8(data + 3, 2);
+        return true;
+    }
+
+    void sleepMs(uint32_t ms) override { clock += ms; }
+    uint32_t nowMs() override { return clock; }
+
+private:
+    bool _measuring = false;
+    uint32_t _startedAt = 0;
+};
+
+// What SensorApp keeps across wakes (SensorRtcState::shown, RTC_SLOT_SENSOR_HISTORY)
+struct SimSensor {
+    SensorRepaintPolicy policy;
+    char updatedTime = 'T';
+    bool showHistory = true;
+    SensorShownFrame shown;
+    SensorHistoryRtcState history;
+};
+
+static SimSht31 s_bus;
+static std::map<int, SimSensor> s_sensors;
+static ShownPanel s_shown;
+
+static void sht31Command(const char* args) {
+    unsigned minSamples, maxSamples, budgetMs, busMs;
+    float tempC, humidity;
+    if (sscanf(args, "%u %u %u %u %f %f", &minSamples, &maxSamples, &budgetMs, &busMs, &tempC, &humidity) != 6) {
+        printf("error\n");
+        return;
+    }
+    // Every wake is a fresh boot: sht31Device() soft-resets once, then the app acquires
+    s_bus.busMs = busMs;
+    s_bus.tempC = tempC;
+    s_bus.humidity = humidity;
+    uint32_t start = s_bus.clock;
+    Sht31Engine engine(s_bus);
+    Sht31AcquireConfig config;
+    config.minSamples = static_cast<uint8_t>(minSamples);
+    config.maxSamples = static_cast<uint8_t>(maxSamples);
+    config.budgetMs = budgetMs;
+    Sht31Result result;
+    bool ok = engine.begin() && engine.acquire(config, result);
+    printf("%d %u %lu %.3f %.3f\n", ok ? 1 : 0, result.taken, (unsigned long)(s_bus.clock - start), result.tempC,
+           result.humidity);
+}
+
+static void sensorCommand(const char* args) {
+    int id, showHistory;
+    float tempDeadband, humidityDeadband;
+    unsigned long minSec, maxSec;
+    char updated;
+    if (sscanf(args, "%d %f %f %lu %lu %c %d", &id, &tempDeadband, &humidityDeadband, &minSec, &maxSec, &updated,
+               &showHistory) != 7) {
+        printf("error\n");
+        return;
+    }
+    SimSensor& sensor = s_sensors[id];
+    sensor.policy.tempDeadbandC = tempDeadband < 0.0f ? 0.0f : tempDeadband;
+    sensor.policy.humidityDeadband = humidityDeadband < 0.0f ? 0.0f : humidityDeadband;
+    sensor.policy.minIntervalSec = minSec;
+    sensor.policy.maxIntervalSec = maxSec;
+    sensor.updatedTime = updated;
+    sensor.showHistory = showHistory != 0;
+    printf("ok\n");
+}
+
+// SensorApp::acquire() (history) and the repaint half of SensorApp::render(); units and
+// location are fixed for a run, so only the parts of the layout hash that move are hashed
+static void sensorWakeCommand(const char* args) {
+    int id, readOk, wifi, battery;
+    unsigned long now;
+    float tempC, humidity;
+    if (sscanf(args, "%d %lu %d %d %d %f %f", &id, &now, &readOk, &wifi, &battery, &tempC, &humidity) != 7 ||
+        s_sensors.count(id) == 0) {
+        printf("error\n");
+        return;
+    }
+    SimSensor& sensor = s_sensors[id];
+    if (readOk) {
+        sensorHistoryAdd(sensor.history, static_cast<uint32_t>(now), tempC, humidity);
+    }
+    SensorHistorySummary temp;
+    bool trend = sensor.showHistory && readOk && sensorHistorySummary(sensor.history.temp, temp) && temp.buckets >= 2;
+
+    // SensorApp::fetch() sets the "Updated:" text only on a WiFi wake
+    char updatedText[8] = "";
+    if (wifi && sensor.updatedTime == 'D') {
+        time_t at = static_cast<time_t>(now);
+        strftime(updatedText, sizeof(updatedText), "%m/%d", gmtime(&at));
+    }
+
+    SensorFrame frame;
+    frame.readOk = readOk != 0;
+    frame.wifiShown = wifi != 0;
+    frame.batteryPercent = battery;
+    frame.tempC = tempC;
+    frame.humidity = humidity;
+    frame.now = static_cast<uint32_t>(now);
+    char policy[3] = {sensor.updatedTime, trend ? 'H' : '-', '\0'};
+    frame.layoutHash = sensorLayoutHash(policy);
+    if (sensor.updatedTime == 'D') {
+        frame.layoutHash = sensorLayoutHash(updatedText, frame.layoutHash);
+    }
+
+    // The sensor's id doubles as its panel owner; any other draw since its last one invalidates the frame
+    if (!s_shown.ownedBy(static_cast<uint16_t>(id))) {
+        sensor.shown.valid = false;
+    }
+    SensorRepaint reason = sensorRepaintDecision(sensor.policy, sensor.shown, frame);
+    if (reason != SensorRepaint::Skip) {
+        sensorRepaintRecord(sensor.shown, frame);
+    }
+    printf("%s\n", sensorRepaintName(reason));
+}
+
+static void shownCommand(const char* args) {
+    unsigned owner;
+    int battery, deadband;
+    unsigned long hash;
+    if (sscanf(args, "%u %lu %d %d", &owner, &hash, &battery, &deadband) != 4) {
+        printf("error\n");
+        return;
+    }
+    bool kept = s_shown.unchanged(static_cast<uint16_t>(owner), static_cast<uint32_t>(hash), battery, deadband);
+    printf("%s\n", kept ? "kept" : "changed");
+}
+
+static void recordCommand(const char* args) {
+    unsigned owner;
+    int battery;
+    unsigned long hash;
+    if (sscanf(args, "%u %lu %d", &owner, &hash, &battery) != 3) {
+        printf("error\n");
+        return;
+    }
+    s_shown.record(static_cast<uint16_t>(owner), static_cast<uint32_t>(hash), battery);
+    printf("ok\n");
+}
+
+static void signatureCommand(const char* args) {
+    std::string text;
+    while (args[0] != '\0' && args[1] != '\0' && args[0] != '\n') {
+        char byte[3] = {args[0], args[1], '\0'};
+        text += static_cast<char>(strtoul(byte, nullptr, 16));
+        args += 2;
+    }
+    printf("%lu\n", (unsigned long)messageFrameSignature(text.c_str(), text.length()));
+}
+
+int main() {
+    char line[4096];
+    while (fgets(line, sizeof(line), stdin) != nullptr) {
+        char command[16] = "";
+        int consumed = 0;
+        if (sscanf(line, "%15s %n", command, &consumed) != 1) {
+            continue;
+        }
+        const char* args = line + consumed;
+        if (strcmp(command, "seed") == 0) {
+            s_bus.rng.seed(static_cast<uint32_t>(strtoul(args, nullptr, 10)));
+            printf("ok\n");
+        } else if (strcmp(command, "sht31") == 0) {
+            sht31Command(args);
+        } else if (strcmp(command, "sensor") == 0) {
+            sensorCommand(args);
+        } else if (strcmp(command, "sensor_wake") == 0) {
+            sensorWakeCommand(args);
+        } else if (strcmp(command, "shown") == 0) {
+            shownCommand(args);
+        } else if (strcmp(command, "draw") == 0) {
+            s_shown.clear();
+            printf("ok\n");
+        } else if (strcmp(command, "record") == 0) {
+            recordCommand(args);
+        } else if (strcmp(command, "signature") == 0) {
+            signatureCommand(args);
+        } else {
+            printf("error\n");
+        }
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+Load test for bin_lookup_server.py with simulated shelf labels.
+
+Fills the server's index with synthetic NEMO users and bins (no NEMO access or
+API key needed), serves it on a local port and lets --labels simulated shelf
+labels wake against it from --clients threads. Like the firmware, each label
+opens a new connection per wake; after its first fetch it sends the ETag it
+holds as If-None-Match, so most wakes are 304s. --bulk makes every request a
+/bins?ids= lookup of --bulk-size labels instead. --stalled opens that many
+connections that never send a request, like labels that lost WiFi mid-wake; a
+single-threaded server waits out the handler timeout (10 s) on each of them.
+
+It also times the index work of an incremental refresh (1% of bins changed)
+against a full rebuild.
+
+Usage:
+    python3 scripts/bin_lookup_bench.py [--bins 5000] [--users 2000] [--labels 3000]
+        [--requests 20000] [--clients 32] [--stalled 0] [--single-thread] [--bulk --bulk-size 50]
+
+--single-thread serves with the plain HTTPServer for comparison.
+"""
+
+import argparse
+import http.client
+import random
+import socket
+import statistics
+import threading
+import time
+from collections import Counter
+
+import bin_lookup_server as bls
+
+
+def synthetic_records(users: int, bins: int, seed: int = 1):
+    rng = random.Random(seed)
+    user_records = [{
+        'id': i,
+        'username': f'user{i}',
+        'first_name': f'First{i}',
+        'last_name': f'Last{i}',
+        'email': f'user{i}@example.edu',
+    } for i in range(1, users + 1)]
+    bin_records = [{
+        'id': 1000 + i,
+        'name': f'Bin {chr(65 + i % 26)}{i:04d}',
+        'quantity': 1,
+        'customer': rng.randint(1, users),
+        'consumable': 64,
+        'project': rng.randint(1, 900),
+    } for i in range(bins)]
+    return user_records, bin_records
+
+
+def time_refreshes(user_records, bin_records) -> None:
+    index = bls.BinIndex()
+    start = time.perf_counter()
+    index.load(user_records, bin_records)
+    full_ms = (time.perf_counter() - start) * 1000
+
+    changed = [dict(b, customer=(b['customer'] % len(user_records)) + 1)
+               for b in random.Random(2).sample(bin_records, max(1, len(bin_records) // 100))]
+    start = time.perf_counter()
+    rebuilt = index.load([], changed, full=False)
+    incremental_ms = (time.perf_counter() - start) * 1000
+    print(f"index: full build {full_ms:.1f} ms ({len(bin_records)} bins), "
+          f"incremental {incremental_ms:.1f} ms ({rebuilt} bins rebuilt)")
+
+
+def run_clients(port: int, args, bin_ids) -> None:
+    labels = [bin_ids[i % len(bin_ids)] for i in range(args.labels)]
+    etags = {}
+    etag_lock = threading.Lock()
+    statuses = Counter()
+    latencies = []
+    stats_lock = threading.Lock()
+    per_client = args.requests // args.clients
+
+    def client(seed: int) -> None:
+        rng = random.Random(seed)
+        local_status = Counter()
+        local_lat = []
+        for _ in range(per_client):
+            if args.bulk:
+                group = rng.sample(labels, min(args.bulk_size, len(labels)))
+                path = '/bins?ids=' + ','.join(group)
+                key = path
+            else:
+                key = rng.choice(labels)
+                path = f'/bin/{key}'
+            headers = {}
+            with etag_lock:
+                if key in etags:
+                    headers['If-None-Match'] = etags[key]
+            start = time.perf_counter()
+            conn = http.client.HTTPConnection('127.0.0.1', port, timeout=30)
+            try:
+                conn.request('GET', path, headers=headers)
+                resp = conn.getresponse()
+                resp.read()
+                local_status[resp.status] += 1
+                etag = resp.getheader('ETag')
+                if etag:
+                    with etag_lock:
+                        etags[key] = etag
+            except OSError:
+                local_status['error'] += 1
+            finally:
+                conn.close()
+            local_lat.append((time.perf_counter() - start) * 1000)
+        with stats_lock:
+            statuses.update(local_status)
+            latencies.extend(local_lat)
+
+    threads = [threading.Thread(target=client, args=(i,)) for i in range(args.clients)]
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - start
+
+    total = sum(statuses.values())
+    latencies.sort()
+    pct = lambda p: latencies[min(len(latencies) - 1, int(len(latencies) * p))]
+    print(f"{total} requests in {elapsed:.2f} s: {total / elapsed:.0f} req/s "
+          f"({'single-threaded' if args.single_thread else 'threaded'} server, {args.clients} clients, "
+          f"{'bulk x' + str(args.bulk_size) if args.bulk else 'per-bin'}, {args.stalled} stalled)")
+    print(f"latency ms: p50 {pct(0.50):.2f}  p95 {pct(0.95):.2f}  p99 {pct(0.99):.2f}  "
+          f"mean {statistics.mean(latencies):.2f}")
+    print("status: " + ", ".join(f"{k}={v}" for k, v in sorted(statuses.items(), key=str)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Load test for bin_lookup_server.py")
+    parser.add_argument("--users", type=int, default=2000)
+    parser.add_argument("--bins", type=int, default=5000)
+    parser.add_argument("--labels", type=int, default=3000, help="simulated shelf labels")
+    parser.add_argument("--requests", type=int, default=20000)
+    parser.add_argument("--clients", type=int, default=32, help="concurrent client threads")
+    parser.add_argument("--stalled", type=int, default=0, help="connections that never send a request")
+    parser.add_argument("--single-thread", action="store_true", help="serve with the plain HTTPServer")
+    parser.add_argument("--bulk", action="store_true", help="use /bins?ids= instead of /bin/<id>")
+    parser.add_argument("--bulk-size", type=int, default=50)
+    args = parser.parse_args()
+
+    user_records, bin_records = synthetic_records(args.users, args.bins)
+    time_refreshes(user_records, bin_records)
+
+    bls.index.load(user_records, bin_records)
+    server = bls.make_server('127.0.0.1', 0, threaded=not args.single_thread, quiet=True)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    stalled = [socket.create_connection(('127.0.0.1', server.server_port)) for _ in range(args.stalled)]
+    try:
+        run_clients(server.server_port, args, [str(b['id']) for b in bin_records])
+    finally:
+        for sock in stalled:
+            sock.close()
+        server.shutdown()
+        server.server_close()
+
+
+if __name__ == "__main__":
+    main()
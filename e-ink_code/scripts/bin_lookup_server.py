@@ -12,7 +12,14 @@ The server will:
 1. Fetch all users from NEMO_USER_URL
 2. Fetch all bins from NEMO_BIN_URL (recurring_consumable_charges endpoint)
 3. Build a lookup table mapping bin IDs to user info (using customer field)
-4. Serve GET /bin/<bin_id> endpoint that returns JSON with owner info
+4. Serve GET /bin/<bin_id> (and GET /bins?ids=a,b,c) with owner info
+
+Responses are built once per bin and kept with their ETag, so a request is a
+dict lookup. A background thread refreshes the data: incremental refreshes
+rebuild only the bins whose record (or owner) changed; a full refresh every
+FULL_REFRESH_INTERVAL also drops deleted records. When NEMO_*_UPDATED_FIELD
+names a modification-time field, incremental refreshes ask upstream only for
+records changed since the newest value seen (the cursor).
 
 The recurring_consumable_charges API returns bins with this structure:
     {
@@ -29,17 +36,26 @@ Environment variables (from .env):
     NEMO_API_KEY: API token for NEMO authentication
     NEMO_USER_URL: URL to fetch users from
     NEMO_BIN_URL: URL to fetch bins from (recurring_consumable_charges)
+
+See scripts/bin_lookup_bench.py for a load test with simulated shelf labels.
 """
 
 import os
 import sys
 import json
 import time
-from typing import Dict, Optional, Any
-from http.server import HTTPServer, BaseHTTPRequestHandler
-from urllib.parse import urlparse, parse_qs
-import requests
-from dotenv import load_dotenv
+import hashlib
+import threading
+from datetime import datetime
+from typing import Dict, Iterable, List, Optional, Any, Set, Tuple
+from http.server import HTTPServer, ThreadingHTTPServer, BaseHTTPRequestHandler
+from urllib.parse import urlparse, parse_qs, unquote
+
+try:
+    from dotenv import load_dotenv
+except ImportError:  # the index and the benchmark run without it
+    def load_dotenv():
+        return False
 
 # Load environment variables from .env file
 load_dotenv()
@@ -48,178 +64,103 @@ load_dotenv()
 NEMO_API_KEY = os.getenv('NEMO_API_KEY')
 NEMO_USER_URL = os.getenv('NEMO_USER_URL', 'https://nemo.stanford.edu/api/users/')
 NEMO_BIN_URL = os.getenv('NEMO_BIN_URL', 'https://nemo.stanford.edu/api/recurring_consumable_charges/')
+# Modification-time fields for incremental fetches (filtered as <field>__gte=<cursor>).
+# Empty = every refresh lists all records, but only changed ones are rebuilt.
+NEMO_USER_UPDATED_FIELD = os.getenv('NEMO_USER_UPDATED_FIELD', '')
+NEMO_BIN_UPDATED_FIELD = os.getenv('NEMO_BIN_UPDATED_FIELD', '')
 SERVER_HOST = os.getenv('SERVER_HOST', '0.0.0.0')
 SERVER_PORT = int(os.getenv('SERVER_PORT', '8080'))
 CACHE_REFRESH_INTERVAL = int(os.getenv('CACHE_REFRESH_INTERVAL', '3600'))  # 1 hour default
+FULL_REFRESH_INTERVAL = int(os.getenv('FULL_REFRESH_INTERVAL', '86400'))  # deletions show up here
 # API timeout in seconds (None = no timeout, useful for slow APIs)
 API_TIMEOUT = int(os.getenv('API_TIMEOUT', '300')) if os.getenv('API_TIMEOUT') else None  # Default: 5 minutes or no timeout
+BULK_MAX_IDS = 256  # ids per /bins request
 
-# Global cache
-user_lookup: Dict[int, Dict[str, Any]] = {}
-bin_lookup: Dict[str, Dict[str, Any]] = {}
-last_refresh_time = 0
 
+def fetch_records(url: str, kind: str, params: Optional[Dict[str, str]] = None) -> Optional[List[Dict[str, Any]]]:
+    """GET every page of a NEMO list endpoint. None when a request fails (partial lists are not applied)."""
+    import requests  # only the upstream fetch needs it
 
-def fetch_all_users() -> Dict[int, Dict[str, Any]]:
-    """Fetch all users from NEMO API and build lookup table."""
-    print(f"Fetching users from {NEMO_USER_URL}...")
-    
+    print(f"Fetching {kind} from {url} {params or ''}...")
     headers = {
         'Authorization': f'Token {NEMO_API_KEY}',
         'Content-Type': 'application/json'
     }
-    
-    users = {}
-    url = NEMO_USER_URL
-    
-    # Handle pagination if API supports it
-    while url:
-        try:
-            response = requests.get(url, headers=headers, timeout=API_TIMEOUT)
-            response.raise_for_status()
-            
-            data = response.json()
-            
-            # Handle both array and paginated responses
-            if isinstance(data, list):
-                user_list = data
-                url = None  # No pagination
-            elif isinstance(data, dict) and 'results' in data:
-                user_list = data['results']
-                url = data.get('next')  # Pagination URL
-            else:
-                print(f"Unexpected response format: {type(data)}")
-                break
-            
-            for user in user_list:
-                user_id = user.get('id')
-                if user_id:
-                    users[user_id] = {
-                        'id': user_id,
-                        'username': user.get('username', ''),
-                        'first_name': user.get('first_name', ''),
-                        'last_name': user.get('last_name', ''),
-                        'email': user.get('email', ''),
-                    }
-            
-            print(f"Loaded {len(users)} users so far...")
-            
-        except requests.exceptions.RequestException as e:
-            print(f"Error fetching users: {e}")
-            break
-    
-    print(f"Total users loaded: {len(users)}")
-    return users
-
-
-def fetch_all_bins() -> Dict[str, Dict[str, Any]]:
-    """Fetch all bins from NEMO API and build lookup table."""
-    print(f"Fetching bins from {NEMO_BIN_URL}...")
-    
-    headers = {
-        'Authorization': f'Token {NEMO_API_KEY}',
-        'Content-Type': 'application/json'
-    }
-    
-    bins = {}
-    url = NEMO_BIN_URL
-    
-    # Handle pagination if API supports it
+
+    records: List[Dict[str, Any]] = []
     while url:
         try:
-            response = requests.get(url, headers=headers, timeout=API_TIMEOUT)
+            response = requests.get(url, headers=headers, params=params, timeout=API_TIMEOUT)
             response.raise_for_status()
-            
             data = response.json()
-            
-            # Handle both array and paginated responses
-            if isinstance(data, list):
-                bin_list = data
-                url = None  # No pagination
-            elif isinstance(data, dict) and 'results' in data:
-                bin_list = data['results']
-                url = data.get('next')  # Pagination URL
-            else:
-                print(f"Unexpected response format: {type(data)}")
-                break
-            
-            for bin_data in bin_list:
-                # Store bin by both ID and name for flexible lookup
-                if 'id' in bin_data:
-                    bin_id_str = str(bin_data['id'])
-                    bins[bin_id_str] = bin_data
-                
-                # Also store by name if it exists and is different from ID
-                if 'name' in bin_data:
-                    bin_name = bin_data['name']
-                    if bin_name and bin_name != str(bin_data.get('id', '')):
-                        bins[bin_name] = bin_data
-            
-            print(f"Loaded {len(bins)} bins so far...")
-            
-        except requests.exceptions.RequestException as e:
-            print(f"Error fetching bins: {e}")
-            break
-    
-    print(f"Total bins loaded: {len(bins)}")
-    return bins
-
-
-def refresh_cache():
-    """Refresh the user and bin lookup caches."""
-    global user_lookup, bin_lookup, last_refresh_time
-    
-    print("Refreshing cache...")
-    start_time = time.time()
-    
-    user_lookup = fetch_all_users()
-    bin_lookup = fetch_all_bins()
-    
-    last_refresh_time = time.time()
-    elapsed = last_refresh_time - start_time
-    
-    print(f"Cache refresh complete in {elapsed:.2f} seconds")
-    print(f"Users: {len(user_lookup)}, Bins: {len(bin_lookup)}")
+        except (requests.exceptions.RequestException, ValueError) as e:
+            print(f"Error fetching {kind}: {e}")
+            return None
 
+        # Handle both array and paginated responses
+        if isinstance(data, list):
+            records.extend(data)
+            url = None  # No pagination
+        elif isinstance(data, dict) and 'results' in data:
+            records.extend(data['results'])
+            url = data.get('next')  # Pagination URL (already carries the filter)
+            params = None
+        else:
+            print(f"Unexpected response format: {type(data)}")
+            return None
+        print(f"Loaded {len(records)} {kind} so far...")
 
-def get_bin_info(bin_id: str) -> Optional[Dict[str, Any]]:
-    """Get bin information including owner details."""
-    # Check if cache needs refresh
-    global last_refresh_time
-    if time.time() - last_refresh_time > CACHE_REFRESH_INTERVAL:
-        refresh_cache()
-    
-    # Look up bin
-    bin_data = bin_lookup.get(bin_id)
-    if not bin_data:
-        return None
-    
-    # Extract customer ID (customer field contains the user ID)
-    # Handle different formats: int, string, or nested object
-    customer_id = None
+    print(f"Total {kind} loaded: {len(records)}")
+    return records
+
+
+def fetch_all_users(since: Optional[str] = None) -> Optional[List[Dict[str, Any]]]:
+    """Users from NEMO; only those changed since the cursor when an updated-field is configured."""
+    params = {f'{NEMO_USER_UPDATED_FIELD}__gte': since} if since and NEMO_USER_UPDATED_FIELD else None
+    return fetch_records(NEMO_USER_URL, 'users', params)
+
+
+def fetch_all_bins(since: Optional[str] = None) -> Optional[List[Dict[str, Any]]]:
+    """Bins from NEMO; only those changed since the cursor when an updated-field is configured."""
+    params = {f'{NEMO_BIN_UPDATED_FIELD}__gte': since} if since and NEMO_BIN_UPDATED_FIELD else None
+    return fetch_records(NEMO_BIN_URL, 'bins', params)
+
+
+def customer_id_of(bin_data: Dict[str, Any]) -> Optional[int]:
+    """User id from a bin's customer field (int, string, or nested object)."""
     customer_field = bin_data.get('customer')
-    
+    if isinstance(customer_field, bool):
+        return None
     if isinstance(customer_field, int):
-        customer_id = customer_field
-    elif isinstance(customer_field, str):
+        return customer_field
+    if isinstance(customer_field, str):
         try:
-            customer_id = int(customer_field)
+            return int(customer_field)
         except ValueError:
-            pass
-    elif isinstance(customer_field, dict):
-        customer_id = customer_field.get('id')
-    
-    # Look up user info using customer ID
-    user_info = None
-    if customer_id:
-        user_info = user_lookup.get(customer_id)
-    
-    # Build response - only include what ESP32 needs for display
+            return None
+    if isinstance(customer_field, dict):
+        return customer_field.get('id')
+    return None
+
+
+def user_summary(user: Dict[str, Any]) -> Dict[str, Any]:
+    """The user fields kept in the index."""
+    return {
+        'id': user.get('id'),
+        'username': user.get('username', ''),
+        'first_name': user.get('first_name', ''),
+        'last_name': user.get('last_name', ''),
+        'email': user.get('email', ''),
+    }
+
+
+def build_bin_info(bin_id: str, bin_data: Dict[str, Any], user_info: Optional[Dict[str, Any]]) -> Dict[str, Any]:
+    """Response for one lookup key - only what the ESP32 needs for display."""
     result = {
         'bin_id': bin_id,
         'bin_name': bin_data.get('name', ''),
     }
-    
+
     if user_info:
         # Build full name
         name_parts = []
@@ -227,7 +168,7 @@ def get_bin_info(bin_id: str) -> Optional[Dict[str, Any]]:
             name_parts.append(user_info['first_name'])
         if user_info.get('last_name'):
             name_parts.append(user_info['last_name'])
-        
+
         result['owner'] = {
             'name': ' '.join(name_parts) if name_parts else user_info.get('username', 'Unknown'),
             'username': user_info.get('username', ''),
@@ -235,119 +176,382 @@ def get_bin_info(bin_id: str) -> Optional[Dict[str, Any]]:
         }
     else:
         result['owner'] = None
-    
+
     return result
 
 
+def bin_etag(body: bytes) -> str:
+    """Strong ETag for a /bin response body (shelf labels revalidate with If-None-Match)."""
+    return '"' + hashlib.sha1(body).hexdigest()[:16] + '"'
+
+
+def etag_matches(if_none_match: Optional[str], etag: str) -> bool:
+    """True when an If-None-Match header value names etag (or is *)."""
+    if not if_none_match:
+        return False
+    tags = [t.strip() for t in if_none_match.split(',')]
+    return '*' in tags or etag in tags or f'W/{etag}' in tags
+
+
+def _newer(cursor: Optional[str], value: Any) -> Optional[str]:
+    """Later of two ISO timestamps (compared as datetimes; offsets may differ)."""
+    if not isinstance(value, str) or not value:
+        return cursor
+    try:
+        parsed = datetime.fromisoformat(value)
+    except ValueError:
+        return cursor
+    if cursor is None:
+        return value
+    try:
+        return value if parsed > datetime.fromisoformat(cursor) else cursor
+    except (ValueError, TypeError):
+        return value
+
+
+class BinIndex:
+    """Bins and users with the /bin response (body + ETag) prebuilt per lookup key.
+
+    Refreshes hold _lock while they apply changes; request threads only do single
+    dict lookups (atomic under the GIL) and never wait for a refresh.
+    """
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self.users: Dict[int, Dict[str, Any]] = {}
+        self.bins: Dict[str, Dict[str, Any]] = {}          # bin key (id, or name without id) -> record
+        self._keys: Dict[str, List[str]] = {}              # bin key -> lookup keys (id and name)
+        self._key_owner: Dict[str, str] = {}               # lookup key -> bin key
+        self._by_customer: Dict[int, Set[str]] = {}        # user id -> bin keys
+        self._customer: Dict[str, Optional[int]] = {}      # bin key -> user id
+        self._responses: Dict[str, Tuple[bytes, str]] = {}  # lookup key -> (body, ETag)
+        self.cursors: Dict[str, Optional[str]] = {'users': None, 'bins': None}
+        self.last_refresh = 0.0
+        self.last_full_refresh = 0.0
+        self.rebuilt = 0  # responses rebuilt by the last apply
+
+    def response(self, key: str) -> Optional[Tuple[bytes, str]]:
+        return self._responses.get(key)
+
+    def info(self, key: str) -> Optional[Dict[str, Any]]:
+        entry = self._responses.get(key)
+        return json.loads(entry[0]) if entry else None
+
+    def apply_users(self, records: Iterable[Dict[str, Any]], full: bool) -> Set[str]:
+        """Merge user records (full = the complete list, so missing users are dropped).
+        Returns the bin keys whose owner changed."""
+        affected: Set[str] = set()
+        with self._lock:
+            seen: Set[int] = set()
+            for user in records:
+                user_id = user.get('id')
+                if not user_id:
+                    continue
+                seen.add(user_id)
+                summary = user_summary(user)
+                if self.users.get(user_id) != summary:
+                    self.users[user_id] = summary
+                    affected |= self._by_customer.get(user_id, set())
+                if NEMO_USER_UPDATED_FIELD:
+                    self.cursors['users'] = _newer(self.cursors['users'], user.get(NEMO_USER_UPDATED_FIELD))
+            if full:
+                for user_id in [u for u in self.users if u not in seen]:
+                    del self.users[user_id]
+                    affected |= self._by_customer.get(user_id, set())
+        return affected
+
+    def apply_bins(self, records: Iterable[Dict[str, Any]], full: bool) -> Set[str]:
+        """Merge bin records (full = the complete list, so missing bins are dropped).
+        Returns the bin keys whose record changed."""
+        affected: Set[str] = set()
+        with self._lock:
+            seen: Set[str] = set()
+            for bin_data in records:
+                if 'id' in bin_data:
+                    key = str(bin_data['id'])
+                elif bin_data.get('name'):
+                    key = bin_data['name']
+                else:
+                    continue
+                seen.add(key)
+                if self.bins.get(key) != bin_data:
+                    self.bins[key] = bin_data
+                    affected.add(key)
+                if NEMO_BIN_UPDATED_FIELD:
+                    self.cursors['bins'] = _newer(self.cursors['bins'], bin_data.get(NEMO_BIN_UPDATED_FIELD))
+            if full:
+                for key in [k for k in self.bins if k not in seen]:
+                    del self.bins[key]
+                    affected.add(key)
+        return affected
+
+    def rebuild(self, bin_keys: Iterable[str]) -> int:
+        """Rebuild the responses (and ETags) of the given bins; unchanged bins keep theirs."""
+        count = 0
+        with self._lock:
+            for key in bin_keys:
+                self._drop_keys(key)
+                bin_data = self.bins.get(key)
+                if bin_data is None:
+                    continue
+                customer = customer_id_of(bin_data)
+                self._customer[key] = customer
+                if customer is not None:
+                    self._by_customer.setdefault(customer, set()).add(key)
+                user_info = self.users.get(customer) if customer else None
+
+                # Store bin by both ID and name for flexible lookup
+                lookup_keys = [key]
+                name = bin_data.get('name')
+                if name and name != key:
+                    lookup_keys.append(name)
+                self._keys[key] = lookup_keys
+                for lookup_key in lookup_keys:
+                    body = json.dumps(build_bin_info(lookup_key, bin_data, user_info)).encode()
+                    self._responses[lookup_key] = (body, bin_etag(body))
+                    self._key_owner[lookup_key] = key
+                count += 1
+            self.rebuilt = count
+        return count
+
+    def _drop_keys(self, key: str) -> None:
+        for lookup_key in self._keys.pop(key, []):
+            if self._key_owner.get(lookup_key) == key:
+                del self._key_owner[lookup_key]
+                self._responses.pop(lookup_key, None)
+        customer = self._customer.pop(key, None)
+        if customer is not None:
+            owned = self._by_customer.get(customer)
+            if owned is not None:
+                owned.discard(key)
+                if not owned:
+                    del self._by_customer[customer]
+
+    def load(self, users: Iterable[Dict[str, Any]], bins: Iterable[Dict[str, Any]], full: bool = True) -> int:
+        """Apply users then bins and rebuild everything they touched."""
+        affected = self.apply_users(users, full)
+        affected |= self.apply_bins(bins, full)
+        rebuilt = self.rebuild(affected)
+        self.last_refresh = time.time()
+        if full:
+            self.last_full_refresh = self.last_refresh
+        return rebuilt
+
+
+index = BinIndex()
+_refresh_lock = threading.Lock()
+
+
+def refresh_cache(full: bool = True) -> bool:
+    """Refresh the index from NEMO. Incremental (full=False) fetches only changed records when
+    an updated-field is configured, and rebuilds only the bins that changed either way."""
+    with _refresh_lock:
+        print(f"Refreshing cache ({'full' if full else 'incremental'})...")
+        start_time = time.time()
+
+        users = fetch_all_users(None if full else index.cursors['users'])
+        bins = fetch_all_bins(None if full else index.cursors['bins'])
+        if users is None or bins is None:
+            print("Cache refresh failed; keeping the previous data")
+            return False
+
+        # Without a cursor field the "incremental" fetch is the complete list, so deletions apply too
+        users_complete = full or not NEMO_USER_UPDATED_FIELD
+        bins_complete = full or not NEMO_BIN_UPDATED_FIELD
+        affected = index.apply_users(users, users_complete)
+        affected |= index.apply_bins(bins, bins_complete)
+        rebuilt = index.rebuild(affected)
+
+        index.last_refresh = time.time()
+        if users_complete and bins_complete:
+            index.last_full_refresh = index.last_refresh
+        elapsed = index.last_refresh - start_time
+        print(f"Cache refresh complete in {elapsed:.2f} seconds ({rebuilt} bins rebuilt)")
+        print(f"Users: {len(index.users)}, Bins: {len(index.bins)}")
+        return True
+
+
+def refresh_loop():
+    """Background refresh: incremental every CACHE_REFRESH_INTERVAL, full every FULL_REFRESH_INTERVAL."""
+    while True:
+        time.sleep(CACHE_REFRESH_INTERVAL)
+        full = time.time() - index.last_full_refresh >= FULL_REFRESH_INTERVAL
+        try:
+            refresh_cache(full=full)
+        except Exception as e:  # keep serving the old data whatever happened
+            print(f"Cache refresh error: {e}")
+
+
+def get_bin_info(bin_id: str) -> Optional[Dict[str, Any]]:
+    """Get bin information including owner details."""
+    return index.info(bin_id)
+
+
+def bulk_response(ids: List[str]) -> Tuple[bytes, str]:
+    """{"bins": {id: info or null}} assembled from the prebuilt bodies, with a combined ETag."""
+    parts = []
+    tags = []
+    for bin_id in ids:
+        entry = index.response(bin_id)
+        parts.append(json.dumps(bin_id) + ': ' + (entry[0].decode() if entry else 'null'))
+        tags.append(entry[1] if entry else '-')
+    body = ('{"bins": {' + ', '.join(parts) + '}}').encode()
+    etag = '"' + hashlib.sha1('\n'.join(ids + tags).encode()).hexdigest()[:16] + '"'
+    return body, etag
+
+
 class BinLookupHandler(BaseHTTPRequestHandler):
     """HTTP request handler for bin lookup API."""
-    
+
+    timeout = 10  # a label that drops off WiFi mid-request must not hold its thread forever
+
+    def send_json(self, status: int, payload: Any) -> None:
+        body = json.dumps(payload).encode()
+        self.send_response(status)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(body)))
+        self.send_header('Access-Control-Allow-Origin', '*')
+        self.end_headers()
+        self.wfile.write(body)
+
+    def send_cached(self, body: bytes, etag: str) -> None:
+        """200 with the body, or an empty 304 when the client already has this ETag."""
+        # Unchanged bin: the label answers with a header-only 304 and keeps its panel
+        if etag_matches(self.headers.get('If-None-Match'), etag):
+            self.send_response(304)
+            self.send_header('ETag', etag)
+            self.send_header('Cache-Control', 'no-cache')
+            self.end_headers()
+            return
+
+        self.send_response(200)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(body)))
+        self.send_header('ETag', etag)
+        self.send_header('Cache-Control', 'no-cache')
+        self.send_header('Access-Control-Allow-Origin', '*')
+        self.end_headers()
+        self.wfile.write(body)
+
     def do_GET(self):
         """Handle GET requests."""
         parsed_path = urlparse(self.path)
-        
+
         # Handle CORS preflight
-        if self.path == '/bin' or parsed_path.path == '/bin':
-            self.send_response(200)
-            self.send_header('Content-Type', 'application/json')
-            self.send_header('Access-Control-Allow-Origin', '*')
-            self.end_headers()
-            self.wfile.write(json.dumps({
-                'error': 'Please specify a bin ID: /bin/<bin_id>'
-            }).encode())
+        if parsed_path.path == '/bin':
+            self.send_json(200, {'error': 'Please specify a bin ID: /bin/<bin_id>'})
             return
-        
+
         # Handle /bin/<bin_id>
         if parsed_path.path.startswith('/bin/'):
-            bin_id = parsed_path.path[5:]  # Remove '/bin/'
-            
+            bin_id = unquote(parsed_path.path[5:])  # Remove '/bin/'
+
             if not bin_id:
                 self.send_error(400, "Bin ID required")
                 return
-            
-            bin_info = get_bin_info(bin_id)
-            
-            if bin_info is None:
-                self.send_response(404)
-                self.send_header('Content-Type', 'application/json')
-                self.send_header('Access-Control-Allow-Origin', '*')
-                self.end_headers()
-                self.wfile.write(json.dumps({
-                    'error': f'Bin not found: {bin_id}'
-                }).encode())
+
+            entry = index.response(bin_id)
+            if entry is None:
+                self.send_json(404, {'error': f'Bin not found: {bin_id}'})
                 return
-            
-            self.send_response(200)
-            self.send_header('Content-Type', 'application/json')
-            self.send_header('Access-Control-Allow-Origin', '*')
-            self.end_headers()
-            self.wfile.write(json.dumps(bin_info).encode())
+            self.send_cached(*entry)
             return
-        
-        # Handle /refresh endpoint to manually refresh cache
+
+        # Handle /bins?ids=a,b,c (ids may also repeat: ?ids=a&ids=b)
+        if parsed_path.path == '/bins':
+            ids: List[str] = []
+            for value in parse_qs(parsed_path.query).get('ids', []):
+                ids.extend(i for i in value.split(',') if i)
+            if not ids:
+                self.send_json(400, {'error': 'Please specify bin IDs: /bins?ids=a,b,c'})
+                return
+            if len(ids) > BULK_MAX_IDS:
+                self.send_json(400, {'error': f'At most {BULK_MAX_IDS} ids per request'})
+                return
+            self.send_cached(*bulk_response(ids))
+            return
+
+        # Handle /refresh endpoint to manually refresh cache (?incremental=1 for an incremental one)
         if parsed_path.path == '/refresh':
-            refresh_cache()
-            self.send_response(200)
-            self.send_header('Content-Type', 'application/json')
-            self.send_header('Access-Control-Allow-Origin', '*')
-            self.end_headers()
-            self.wfile.write(json.dumps({
-                'status': 'Cache refreshed',
-                'users': len(user_lookup),
-                'bins': len(bin_lookup)
-            }).encode())
+            full = parse_qs(parsed_path.query).get('incremental', ['0'])[0] in ('0', '')
+            ok = refresh_cache(full=full)
+            self.send_json(200 if ok else 502, {
+                'status': 'Cache refreshed' if ok else 'Refresh failed',
+                'users': len(index.users),
+                'bins': len(index.bins),
+                'rebuilt': index.rebuilt,
+            })
             return
-        
+
         # Handle /health endpoint
         if parsed_path.path == '/health':
-            self.send_response(200)
-            self.send_header('Content-Type', 'application/json')
-            self.send_header('Access-Control-Allow-Origin', '*')
-            self.end_headers()
-            self.wfile.write(json.dumps({
+            self.send_json(200, {
                 'status': 'ok',
-                'users': len(user_lookup),
-                'bins': len(bin_lookup),
-                'last_refresh': last_refresh_time
-            }).encode())
+                'users': len(index.users),
+                'bins': len(index.bins),
+                'last_refresh': index.last_refresh,
+                'last_full_refresh': index.last_full_refresh,
+                'cursors': index.cursors,
+            })
             return
-        
+
         # 404 for unknown paths
         self.send_error(404, "Not found")
-    
+
     def log_message(self, format, *args):
         """Override to use print instead of stderr."""
+        if self.server.quiet:
+            return
         print(f"[{self.address_string()}] {format % args}")
 
 
+def make_server(host: str, port: int, threaded: bool = True, quiet: bool = False) -> HTTPServer:
+    """HTTP server for the index; one thread per connection unless threaded=False."""
+    server_class = ThreadingHTTPServer if threaded else HTTPServer
+    server = server_class((host, port), BinLookupHandler, bind_and_activate=False)
+    server.request_queue_size = 128  # labels waking together; the default backlog of 5 drops SYNs
+    server.daemon_threads = True
+    server.quiet = quiet
+    try:
+        server.server_bind()
+        server.server_activate()
+    except OSError:
+        server.server_close()
+        raise
+    return server
+
+
 def main():
     """Main server function."""
     if not NEMO_API_KEY:
         print("Error: NEMO_API_KEY not set in environment variables")
         sys.exit(1)
-    
+
     print("=" * 60)
     print("Bin Lookup Server for ESP32 Shelf Labels")
     print("=" * 60)
     print(f"Server: {SERVER_HOST}:{SERVER_PORT}")
     print(f"NEMO User URL: {NEMO_USER_URL}")
     print(f"NEMO Bin URL: {NEMO_BIN_URL}")
-    print(f"Cache refresh interval: {CACHE_REFRESH_INTERVAL} seconds")
+    print(f"Cache refresh interval: {CACHE_REFRESH_INTERVAL} seconds (full every {FULL_REFRESH_INTERVAL})")
+    print(f"Incremental fields: users={NEMO_USER_UPDATED_FIELD or '-'}, bins={NEMO_BIN_UPDATED_FIELD or '-'}")
     print(f"API timeout: {API_TIMEOUT if API_TIMEOUT else 'None (no timeout)'}")
     print("=" * 60)
-    
+
     # Initial cache load
-    refresh_cache()
-    
+    refresh_cache(full=True)
+    threading.Thread(target=refresh_loop, daemon=True).start()
+
     # Start HTTP server
-    server = HTTPServer((SERVER_HOST, SERVER_PORT), BinLookupHandler)
+    server = make_server(SERVER_HOST, SERVER_PORT)
     print(f"\nServer started on http://{SERVER_HOST}:{SERVER_PORT}")
     print("Endpoints:")
-    print("  GET /bin/<bin_id>  - Get bin owner information")
-    print("  GET /refresh        - Manually refresh cache")
-    print("  GET /health         - Health check")
+    print("  GET /bin/<bin_id>    - Get bin owner information (ETag / If-None-Match)")
+    print("  GET /bins?ids=a,b,c  - Several bins in one response")
+    print("  GET /refresh         - Manually refresh cache (?incremental=1)")
+    print("  GET /health          - Health check")
     print("\nPress Ctrl+C to stop the server\n")
-    
+
     try:
         server.serve_forever()
     except KeyboardInterrupt:
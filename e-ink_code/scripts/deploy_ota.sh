@@ -43,13 +43,16 @@ echo "=== deploy_ota.sh (version: $VERSION, app: $APP_NAME) ==="
 echo "=== Building firmware for $APP_NAME (env: $ENV_NAME) ==="
 pio run -e "$ENV_NAME"
 
-echo "=== Copying firmware to ota/ ==="
+echo "=== Copying firmware to ota/ (raw + zlib) ==="
 python3 scripts/post_build.py "$ENV_NAME"
 
-echo "=== Creating manifest (version + sha256) ==="
+echo "=== Creating manifest (version + sha256 + delta patches) ==="
 python3 scripts/make_manifest.py "$APP_NAME"
 
 echo "=== Uploading to $OTA_HOST:$OTA_PATH ==="
-scp ota/firmware.bin ota/manifest.json "$OTA_HOST:$OTA_PATH/"
+scp ota/firmware.bin ota/firmware.bin.zz ota/manifest.json "$OTA_HOST:$OTA_PATH/"
+if [ -d ota/patches ]; then
+    scp -r ota/patches "$OTA_HOST:$OTA_PATH/"
+fi
 
 echo "Done."
@@ -1,11 +1,18 @@
 import hashlib
 import json
+import shutil
 import sys
 from pathlib import Path
 
+from ota_delta import apply_patch, image_sha256, make_patch
+
 ROOT = Path(__file__).resolve().parent.parent
 VERSION = (ROOT / "version.txt").read_text().strip()
 FIRMWARE_BIN = ROOT / "ota" / "firmware.bin"
+FIRMWARE_ZZ = ROOT / "ota" / "firmware.bin.zz"
+PATCH_DIR = ROOT / "ota" / "patches"
+# Older releases we publish a delta from; devices further behind take the full image
+MAX_PATCHES = 3
 
 # Get app name from argument or default to fun
 APP_NAME = sys.argv[1] if len(sys.argv) > 1 else "fun"
@@ -35,6 +42,51 @@ manifest = {
     "url": f"https://ota.denton.works/{OTA_URL_PATH}/firmware.bin"
 }
 
+# Compressed artefact from post_build.py; older firmware ignores this key and keeps using "url"
+if FIRMWARE_ZZ.exists():
+    compressed = FIRMWARE_ZZ.read_bytes()
+    manifest["compressed"] = {
+        "encoding": "zlib",
+        "size": len(compressed),
+        "sha256": hashlib.sha256(compressed).hexdigest(),
+        "url": f"https://ota.denton.works/{OTA_URL_PATH}/firmware.bin.zz"
+    }
+
+# Delta patches from recently deployed versions. Each release is archived under
+# ota/releases/<app>/<version>.bin so the next deploy can diff against it.
+release_dir = ROOT / "ota" / "releases" / APP_NAME
+release_dir.mkdir(parents=True, exist_ok=True)
+new_image = FIRMWARE_BIN.read_bytes()
+shutil.copy2(FIRMWARE_BIN, release_dir / f"{VERSION}.bin")
+# A patch is only worth publishing if it beats what the device would otherwise download
+fallback_size = FIRMWARE_ZZ.stat().st_size if FIRMWARE_ZZ.exists() else len(new_image)
+
+def version_key(path):
+    return tuple(int(p) if p.isdigit() else 0 for p in path.stem.split("."))
+
+previous = sorted((p for p in release_dir.glob("*.bin") if p.stem != VERSION), key=version_key)
+shutil.rmtree(PATCH_DIR, ignore_errors=True)
+patches = {}
+for old_path in previous[-MAX_PATCHES:]:
+    old_image = old_path.read_bytes()
+    patch = make_patch(old_image, new_image)
+    if apply_patch(old_image, patch) != new_image:
+        print(f"make_manifest.py: delta from {old_path.stem} failed verification, skipped")
+        continue
+    if len(patch) >= fallback_size:
+        continue
+    PATCH_DIR.mkdir(exist_ok=True)
+    patch_name = f"{old_path.stem}.patch.zz"
+    (PATCH_DIR / patch_name).write_bytes(patch)
+    patches[old_path.stem] = {
+        "from_sha256": image_sha256(old_image),
+        "size": len(patch),
+        "url": f"https://ota.denton.works/{OTA_URL_PATH}/patches/{patch_name}"
+    }
+    print(f"make_manifest.py: delta {old_path.stem} → {VERSION}: {len(patch)} bytes")
+if patches:
+    manifest["patches"] = patches
+
 (ROOT / "ota" / "manifest.json").write_text(json.dumps(manifest, indent=2))
 
 print(f"make_manifest.py (version: {VERSION}, app: {APP_NAME}): manifest.json generated")
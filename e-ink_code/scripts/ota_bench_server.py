@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+Local HTTP stand-in for OTA download benchmarks.
+
+Serves one file (default ota/firmware.bin) at any path, with the body framing
+and pacing the device has to cope with in the field:
+
+    length   Content-Length body (what nginx normally sends)
+    chunked  Transfer-Encoding: chunked, random chunk sizes
+    close    no length at all; the body ends when the connection closes
+
+--stall-every/--stall-ms insert pauses mid-body so the socket is briefly empty
+(the old download loop treated that as end-of-file). --rate caps throughput.
+
+Usage:
+    python3 scripts/ota_bench_server.py [--file ota/firmware.bin] [--port 8000]
+        [--mode length|chunked|close] [--rate KBPS] [--stall-every BYTES --stall-ms MS]
+
+Then build firmware with -DOTA_BENCH_URL=\\"http://<this-host>:8000/firmware.bin\\";
+on boot it downloads the file twice (network only, then network + flash) and logs
+"[OTA] Download complete: N bytes in T ms (X KB/s, S ms in sink)". This server
+prints its own send time per request for comparison.
+
+--selftest downloads once from the running server with urllib and checks the body.
+"""
+
+import argparse
+import random
+import threading
+import time
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+SEND_SIZE = 1460  # roughly one TCP segment
+
+
+class BenchHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    body = b""
+    mode = "length"
+    rate_kbps = 0
+    stall_every = 0
+    stall_ms = 0
+
+    def _paced_write(self, data: bytes, state: dict) -> None:
+        for i in range(0, len(data), SEND_SIZE):
+            piece = data[i:i + SEND_SIZE]
+            self.wfile.write(piece)
+            state["sent"] += len(piece)
+            if self.stall_every and state["sent"] >= state["next_stall"]:
+                self.wfile.flush()
+                time.sleep(self.stall_ms / 1000.0)
+                state["next_stall"] += self.stall_every
+            if self.rate_kbps:
+                target = state["start"] + state["sent"] / (self.rate_kbps * 1024.0)
+                delay = target - time.monotonic()
+                if delay > 0:
+                    time.sleep(delay)
+
+    def do_GET(self):
+        self.send_response(200)
+        self.send_header("Content-Type", "application/octet-stream")
+        if self.mode == "length":
+            self.send_header("Content-Length", str(len(self.body)))
+        elif self.mode == "chunked":
+            self.send_header("Transfer-Encoding", "chunked")
+        else:
+            self.send_header("Connection", "close")
+            self.close_connection = True
+        self.end_headers()
+
+        state = {"sent": 0, "next_stall": self.stall_every, "start": time.monotonic()}
+        try:
+            if self.mode == "chunked":
+                pos = 0
+                while pos < len(self.body):
+                    size = min(random.randint(256, 16384), len(self.body) - pos)
+                    self.wfile.write(f"{size:x}\r\n".encode())
+                    self._paced_write(self.body[pos:pos + size], state)
+                    self.wfile.write(b"\r\n")
+                    pos += size
+                self.wfile.write(b"0\r\n\r\n")
+            else:
+                self._paced_write(self.body, state)
+            self.wfile.flush()
+        except (BrokenPipeError, ConnectionResetError):
+            print(f"{self.client_address[0]}: client went away after {state['sent']} bytes")
+            return
+
+        elapsed = time.monotonic() - state["start"]
+        kbps = state["sent"] / 1024.0 / elapsed if elapsed > 0 else 0.0
+        print(f"{self.client_address[0]}: sent {state['sent']} bytes ({self.mode}) "
+              f"in {elapsed * 1000:.0f} ms ({kbps:.1f} KB/s)")
+
+    def log_message(self, format, *args):
+        pass
+
+
+def selftest(url: str, expected: bytes) -> None:
+    start = time.monotonic()
+    with urllib.request.urlopen(url) as resp:
+        data = resp.read()
+    elapsed = time.monotonic() - start
+    status = "OK" if data == expected else "MISMATCH"
+    print(f"selftest: {status}, {len(data)} bytes in {elapsed * 1000:.0f} ms")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Local HTTP stand-in for OTA download benchmarks")
+    parser.add_argument("--file", default=str(ROOT / "ota" / "firmware.bin"))
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--mode", choices=["length", "chunked", "close"], default="length")
+    parser.add_argument("--rate", type=int, default=0, help="cap in KB/s (0 = unlimited)")
+    parser.add_argument("--stall-every", type=int, default=0, help="pause after every N bytes")
+    parser.add_argument("--stall-ms", type=int, default=200)
+    parser.add_argument("--selftest", action="store_true", help="fetch once locally and exit")
+    args = parser.parse_args()
+
+    BenchHandler.body = Path(args.file).read_bytes()
+    BenchHandler.mode = args.mode
+    BenchHandler.rate_kbps = args.rate
+    BenchHandler.stall_every = args.stall_every
+    BenchHandler.stall_ms = args.stall_ms
+
+    server = ThreadingHTTPServer((args.host, args.port), BenchHandler)
+    print(f"Serving {args.file} ({len(BenchHandler.body)} bytes, {args.mode}) on port {server.server_port}")
+
+    if args.selftest:
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        selftest(f"http://127.0.0.1:{server.server_port}/firmware.bin", BenchHandler.body)
+        server.shutdown()
+        return
+
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print("\nShutting down...")
+        server.server_close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,167 @@
+"""
+Binary delta patches for OTA (format "EDP1", applied by firmware/core/ota/ota_delta.cpp).
+
+The patch is a zlib stream (same decoder as firmware.bin.zz) of:
+
+    "EDP1" | u32 target_size | u32 source_size | ops... | 0x00
+
+Ops (all integers little-endian):
+    0x01 COPY     u32 src_offset, u32 length             -> copy bytes from the running image
+    0x02 LITERAL  u32 length, <length bytes>             -> new bytes
+    0x03 ADD      u32 src_offset, u32 length, <length>   -> (source + diff) & 0xFF, bsdiff-style
+
+ADD covers code that only moved: relocated addresses differ in a few bytes per word,
+so the diff bytes are mostly zero and compress to almost nothing.
+
+Usage:
+    python3 scripts/ota_delta.py old.bin new.bin out.patch.zz
+"""
+
+import hashlib
+import struct
+import sys
+import zlib
+
+MAGIC = b"EDP1"
+OP_END = 0x00
+OP_COPY = 0x01
+OP_LITERAL = 0x02
+OP_ADD = 0x03
+
+BLOCK = 16          # anchor size used to find matches
+MIN_EXACT = 24      # shorter exact runs are cheaper as literals
+FUZZ_SLACK = 32     # stop approximate extension once the score falls this far behind
+
+
+def image_sha256(image: bytes) -> str:
+    """Hash the device reports for a running app partition (esp_partition_get_sha256).
+
+    esptool appends a SHA-256 of the image to app binaries when the header's
+    hash_appended byte (offset 23) is set; the bootloader returns that digest.
+    """
+    if len(image) > 56 and image[23] == 1:
+        return image[-32:].hex()
+    return hashlib.sha256(image).hexdigest()
+
+
+def _extend_fuzzy(old: bytes, new: bytes, o: int, n: int) -> int:
+    """Length of the best approximate run starting at (o, n): maximises 2*matches - length."""
+    best_len = 0
+    best_score = 0
+    score = 0
+    i = 0
+    limit = min(len(old) - o, len(new) - n)
+    while i < limit:
+        score += 1 if old[o + i] == new[n + i] else -1
+        i += 1
+        if score > best_score:
+            best_score = score
+            best_len = i
+        elif score < best_score - FUZZ_SLACK:
+            break
+    return best_len
+
+
+def make_patch(old: bytes, new: bytes) -> bytes:
+    index = {}
+    for pos in range(0, len(old) - BLOCK + 1, BLOCK):
+        index.setdefault(old[pos:pos + BLOCK], pos)
+
+    ops = bytearray()
+    literal_start = 0
+    n = 0
+
+    def flush_literal(end: int) -> None:
+        if end > literal_start:
+            ops.extend(struct.pack("<BI", OP_LITERAL, end - literal_start))
+            ops.extend(new[literal_start:end])
+
+    while n + BLOCK <= len(new):
+        o = index.get(new[n:n + BLOCK])
+        if o is None:
+            n += 1
+            continue
+
+        # Grow the anchor backwards into the pending literal, then forwards exactly.
+        while n > literal_start and o > 0 and old[o - 1] == new[n - 1]:
+            n -= 1
+            o -= 1
+        exact = BLOCK
+        while o + exact < len(old) and n + exact < len(new) and old[o + exact] == new[n + exact]:
+            exact += 1
+        fuzzy = _extend_fuzzy(old, new, o + exact, n + exact)
+
+        if exact < MIN_EXACT and fuzzy == 0:
+            n += 1
+            continue
+
+        flush_literal(n)
+        if fuzzy == 0:
+            ops.extend(struct.pack("<BII", OP_COPY, o, exact))
+        else:
+            length = exact + fuzzy
+            ops.extend(struct.pack("<BII", OP_ADD, o, length))
+            ops.extend(bytes((new[n + i] - old[o + i]) & 0xFF for i in range(length)))
+            exact = length
+        n += exact
+        literal_start = n
+
+    flush_literal(len(new))
+    ops.append(OP_END)
+
+    raw = MAGIC + struct.pack("<II", len(new), len(old)) + bytes(ops)
+    return zlib.compress(raw, 9)
+
+
+def apply_patch(old: bytes, patch: bytes) -> bytes:
+    """Reference implementation of the device-side applier (used to verify patches)."""
+    raw = zlib.decompress(patch)
+    if raw[:4] != MAGIC:
+        raise ValueError("not an EDP1 patch")
+    target_size, source_size = struct.unpack_from("<II", raw, 4)
+    if source_size > len(old):
+        raise ValueError("source image shorter than patch expects")
+    out = bytearray()
+    pos = 12
+    while True:
+        op = raw[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        if op == OP_COPY:
+            src, length = struct.unpack_from("<II", raw, pos)
+            pos += 8
+            out.extend(old[src:src + length])
+        elif op == OP_LITERAL:
+            (length,) = struct.unpack_from("<I", raw, pos)
+            pos += 4
+            out.extend(raw[pos:pos + length])
+            pos += length
+        elif op == OP_ADD:
+            src, length = struct.unpack_from("<II", raw, pos)
+            pos += 8
+            out.extend((old[src + i] + raw[pos + i]) & 0xFF for i in range(length))
+            pos += length
+        else:
+            raise ValueError(f"unknown op {op:#x} at {pos - 1}")
+    if len(out) != target_size:
+        raise ValueError(f"patched size {len(out)} != {target_size}")
+    return bytes(out)
+
+
+def main() -> None:
+    if len(sys.argv) != 4:
+        print(__doc__)
+        sys.exit(1)
+    old = open(sys.argv[1], "rb").read()
+    new = open(sys.argv[2], "rb").read()
+    patch = make_patch(old, new)
+    if apply_patch(old, patch) != new:
+        print("ota_delta.py: patch verification failed")
+        sys.exit(1)
+    open(sys.argv[3], "wb").write(patch)
+    print(f"ota_delta.py: {len(new)} byte image → {len(patch)} byte patch")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,6 +1,7 @@
 from pathlib import Path
 import shutil
 import sys
+import zlib
 
 ROOT = Path(__file__).resolve().parent.parent
 try:
@@ -19,7 +20,14 @@ ota_dir = ROOT / "ota"
 ota_dir.mkdir(exist_ok=True)
 
 dest = ota_dir / "firmware.bin"
+# zlib stream the device inflates straight into the OTA partition (see ota_inflate.cpp)
+dest_compressed = ota_dir / "firmware.bin.zz"
 
 version = (ROOT / "version.txt").read_text().strip()
 print(f"post_build.py (version: {version}): Copying {firmware} → {dest}")
 shutil.copy2(firmware, dest)
+
+raw = dest.read_bytes()
+dest_compressed.write_bytes(zlib.compress(raw, 9))
+ratio = dest_compressed.stat().st_size / len(raw) if raw else 0
+print(f"post_build.py: Compressed {len(raw)} → {dest_compressed.stat().st_size} bytes ({ratio:.0%}) → {dest_compressed}")
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""
+Send a provisioning JSON to the display over BLE using the framed transfer.
+
+The display must be in its cold-start BLE window (power-cycle it). The config is
+split into START / DATA frames sized to the negotiated MTU and written to the
+TX characteristic (ff01). Progress and errors come back as notifications on RX
+(ff02); see firmware/core/bluetooth/ble_config_frames.h for the wire format.
+
+Usage:
+    python3 scripts/send_ble_config.py config.json [--address AA:BB:...] [--legacy]
+
+--legacy writes the JSON in one go like older clients (only works when it fits
+in a single write).
+"""
+
+import argparse
+import asyncio
+import struct
+import sys
+import zlib
+
+from bleak import BleakClient, BleakScanner
+
+DEVICE_NAME = "E-Ink Display"
+TX_CHAR_UUID = "0000ff01-0000-1000-8000-00805f9b34fb"
+RX_CHAR_UUID = "0000ff02-0000-1000-8000-00805f9b34fb"
+
+FRAME_START = 0x01
+FRAME_DATA = 0x02
+FRAME_ABORT = 0x03
+
+STATUS_PROGRESS = 0x01
+STATUS_COMPLETE = 0x02
+STATUS_BAD_SEQUENCE = 0x81
+STATUS_NAMES = {
+    0x00: "idle", 0x01: "progress", 0x02: "complete", 0x81: "bad sequence",
+    0x82: "bad crc", 0x83: "too large", 0x84: "bad frame", 0x85: "aborted",
+}
+
+ATT_OVERHEAD = 3
+DATA_HEADER = 3
+MAX_RETRIES = 3
+
+
+def start_frame(payload: bytes) -> bytes:
+    return struct.pack("<BII", FRAME_START, len(payload), zlib.crc32(payload))
+
+
+def data_frames(payload: bytes, chunk: int, first_seq: int = 0, offset: int = 0):
+    seq = first_seq
+    while offset < len(payload):
+        yield seq, offset, struct.pack("<BH", FRAME_DATA, seq) + payload[offset:offset + chunk]
+        offset += chunk
+        seq += 1
+
+
+def parse_ack(data: bytes) -> dict:
+    status, next_seq, received, mtu, capacity = struct.unpack("<BHIHH", bytes(data[:11]))
+    return {"status": status, "next_seq": next_seq, "received": received, "mtu": mtu, "capacity": capacity}
+
+
+async def find_device(address):
+    if address:
+        return address
+    print(f"Scanning for '{DEVICE_NAME}'...")
+    device = await BleakScanner.find_device_by_name(DEVICE_NAME, timeout=15.0)
+    if device is None:
+        sys.exit("Display not found; power-cycle it to open the BLE window")
+    return device.address
+
+
+async def send(address: str, payload: bytes, legacy: bool) -> bool:
+    async with BleakClient(address) as client:
+        acks = asyncio.Queue()
+        await client.start_notify(RX_CHAR_UUID, lambda _, data: acks.put_nowait(parse_ack(data)))
+
+        hello = parse_ack(await client.read_gatt_char(RX_CHAR_UUID))
+        if len(payload) > hello["capacity"]:
+            print(f"Config is {len(payload)} bytes, display accepts {hello['capacity']}")
+            return False
+
+        if legacy:
+            await client.write_gatt_char(TX_CHAR_UUID, payload, response=True)
+            print("Sent as a single write")
+            return True
+
+        mtu = client.mtu_size or hello["mtu"]
+        chunk = max(1, mtu - ATT_OVERHEAD - DATA_HEADER)
+        print(f"Sending {len(payload)} bytes in {(len(payload) + chunk - 1) // chunk} frames (MTU {mtu})")
+
+        await client.write_gatt_char(TX_CHAR_UUID, start_frame(payload), response=True)
+        seq, offset = 0, 0
+        for attempt in range(MAX_RETRIES + 1):
+            for seq, offset, frame in data_frames(payload, chunk, seq, offset):
+                await client.write_gatt_char(TX_CHAR_UUID, frame, response=True)
+
+            # Drain notifications until the display reports a final state
+            while True:
+                try:
+                    ack = await asyncio.wait_for(acks.get(), timeout=5.0)
+                except asyncio.TimeoutError:
+                    print("No final acknowledgement from the display")
+                    return False
+                name = STATUS_NAMES.get(ack["status"], hex(ack["status"]))
+                print(f"  {name}: {ack['received']}/{len(payload)} bytes")
+                if ack["status"] == STATUS_COMPLETE:
+                    return True
+                if ack["status"] == STATUS_BAD_SEQUENCE:
+                    seq, offset = ack["next_seq"], ack["received"]
+                    break
+                if ack["status"] != STATUS_PROGRESS:
+                    return False
+            print(f"Resuming from frame {seq} (retry {attempt + 1})")
+
+        await client.write_gatt_char(TX_CHAR_UUID, bytes([FRAME_ABORT]), response=True)
+        return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Send a provisioning JSON to the display over BLE")
+    parser.add_argument("config", help="path to the provisioning JSON")
+    parser.add_argument("--address", help="BLE address (default: scan for the display)")
+    parser.add_argument("--legacy", action="store_true", help="single unframed write like older clients")
+    args = parser.parse_args()
+
+    with open(args.config, "rb") as f:
+        payload = f.read().strip()
+
+    address = asyncio.run(find_device(args.address))
+    ok = asyncio.run(send(address, payload, args.legacy))
+    print("Config delivered" if ok else "Config transfer failed")
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
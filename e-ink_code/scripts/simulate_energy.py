@@ -0,0 +1,593 @@
+#!/usr/bin/env python3
+"""
+Energy simulator for the wake cycle: projected battery life per app and config.
+
+Runs the firmware's wake/sleep schedule on a virtual clock for --days of
+simulated time (thousands of wakes in well under a second) and charges each
+peripheral's current, plus the CPU's, for the time it keeps the device awake: boot, CPU, WiFi association, HTTP
+requests, NTP, the SHT31, LittleFS reads and the e-paper refresh, then deep
+sleep until the next wake. The per-app models follow the decisions the
+firmware makes on each wake, so config changes show up as energy:
+
+  sensor    WiFi every wake; Nemo POSTs only with nemoToken set, one per
+            configured sensor id (battery once a day); the panel repaints per
+            the repaint policy and history against a synthetic diurnal
+            temperature and humidity
+  fun       SHT31 read every wake; display mode rotates per wake; room data
+            needs WiFi only for a stale RSSI (24 h, refreshed on every WiFi
+            wake), fact modes run from offline packs (--no-packs: the RTC
+            queue, refilled every FUN_QUEUE_BATCH shows or 24 h), earthquake
+            and ISS are live; daily pack check
+  shelf     WiFi and one lookup every wake (mostly 304s); the panel repaints
+            when the label changes (--label-changes per day) or the battery
+            moves 10 points
+  messages  no WiFi; pre-rendered frames; repaints only when the message
+            changes, so a single message refreshes the panel once
+  playlist  the most overdue entry whose hour window is open runs each wake,
+            with a 60 s minimum sleep, as in app_manager/playlist.*
+
+OTA checks and NTP resyncs (every 6 h) ride along with WiFi wakes.
+
+The decisions the firmware has host-buildable code for are not modelled here:
+the models ask firmware/sim/energy_shim.cpp, which runs the real SHT31 engine
+(against a mock bus on a virtual clock, so samples and awake time come from
+acquire()), the sensor repaint policy and history, the message frame signature
+and DisplayManager's shown-panel record. The script builds the shim from the [env:sim]
+sources in platformio.ini with the host compiler ($CXX, default c++) into
+.pio/build/sim/program, or uses `pio run -e sim`'s build when it is newer.
+
+Configs are the provisioning JSON the device takes over BLE ({"app": ...,
+"config": {...}} or {"playlist": [...]}); with none given, each app runs with
+its defaults. The current profile is an estimate for the XIAO ESP32-C3 board;
+replace it with measurements via --profile profile.json (any subset of
+DEFAULT_PROFILE's keys) before trusting absolute numbers. Relative numbers
+between configs hold up much better.
+
+Usage:
+    python3 scripts/simulate_energy.py [config.json ...] [--days 14]
+        [--capacity-mah 1000] [--profile profile.json] [--no-packs]
+        [--label-changes 0.2] [--temp-swing 2.0] [--seed 1] [--cxx c++]
+"""
+
+import argparse
+import configparser
+import json
+import math
+import os
+import random
+import re
+import subprocess
+from collections import defaultdict
+from pathlib import Path
+
+# Currents in mA, durations in ms. Peripheral currents add to the CPU's, which
+# is on for all awake time; the ledger books both to the activity that kept
+# the device awake.
+DEFAULT_PROFILE = {
+    "sleep_ua": 45.0,            # deep sleep, panel and sensor switched off (V_SWITCH)
+    "cpu_ma": 22.0,              # CPU awake
+    "boot_ms": 280,              # ROM boot to setup() done (NVS read, RTC restore)
+    "battery_adc_ms": 15,
+    "wifi_ma": 65.0,             # radio on, over the CPU
+    "wifi_connect_ms": 1400,     # association + DHCP from the stored credentials
+    "http_ms": 350,              # plain HTTP request on an open association
+    "https_ms": 900,             # TLS handshake + request
+    "ntp_ms": 250,
+    "sht31_ma": 0.8,             # single-shot measurement
+    "sht31_bus_ms": 1,           # one I2C transaction; conversion waits are the engine's own
+    "fs_mount_ms": 25,           # LittleFS mount
+    "fs_read_ms": 20,            # one small file read
+    "inflate_ms": 15,            # one fact pack block
+    "layout_ms": 120,            # text layout with the GFX fonts
+    "panel_ma": 6.0,             # 3-colour refresh, panel side
+    "panel_refresh_ms": 15000,   # full 3-colour refresh (BUSY)
+    "panel_init_ms": 150,        # init + image transfer over SPI
+}
+
+# Firmware constants the models follow (see the named headers)
+SENSOR_SHT31_MIN_SAMPLES = 3            # apps/sensor/config.h
+SENSOR_SHT31_MAX_SAMPLES = 8
+SENSOR_SHT31_BUDGET_MS = 150
+SENSOR_DEFAULT_TEMP_DEADBAND_C = 0.3
+SENSOR_DEFAULT_HUMIDITY_DEADBAND = 2.0
+SENSOR_DEFAULT_MIN_REPAINT_MINUTES = 0
+SENSOR_DEFAULT_MAX_REPAINT_MINUTES = 60
+SENSOR_DEFAULT_NEMO_URL = "https://nemo.stanford.edu/api/sensors/sensor_data/"
+FUN_ROOM_MAX_SAMPLES = 3                # apps/fun/config.h
+FUN_ROOM_BUDGET_MS = 60
+FUN_QUEUE_BATCH = 6
+FUN_QUEUE_REFILL_AT = 1
+FUN_QUEUE_MAX_AGE_HOURS = 24
+FUN_ROOM_RSSI_MAX_AGE_HOURS = 24
+FUN_PACK_SYNC_INTERVAL_HOURS = 24       # apps/fun/fact_packs.h
+SHELF_BATTERY_DEADBAND_PCT = 10         # apps/shelf/config.h
+MESSAGES_BATTERY_DEADBAND_PCT = 10      # apps/messages/config.h
+OTA_CHECK_INTERVAL_SECONDS = 6 * 3600   # core/hardware_config.h
+TIME_SYNC_INTERVAL_SECONDS = 6 * 3600   # app_manager/wake_scheduler.h
+PLAYLIST_MIN_SLEEP_SECONDS = 60
+BATTERY_LOW_THRESHOLD_PERCENT = 5       # device stops refreshing below this
+
+# The virtual clock starts here (2024-01-01 00:00 UTC) so time() looks valid to the firmware code
+SIM_EPOCH = 1704067200
+
+ROOT = Path(__file__).resolve().parent.parent
+
+
+def shim_sources() -> list:
+    """The [env:sim] build_src_filter of platformio.ini, as files."""
+    ini = configparser.ConfigParser(interpolation=None)
+    ini.read(ROOT / "platformio.ini")
+    src_dir = ROOT / ini.get("platformio", "src_dir", fallback="src")
+    sources = []
+    for path in re.findall(r"\+<([^>]+)>", ini.get("env:sim", "build_src_filter")):
+        target = src_dir / path
+        sources += sorted(target.glob("*.cpp")) if target.is_dir() else [target]
+    return sources
+
+
+class Shim:
+    """firmware/sim/energy_shim.cpp: the firmware's own decision code, one line per call."""
+
+    def __init__(self, cxx: str, seed: int):
+        program = ROOT / ".pio" / "build" / "sim" / "program"
+        sources = shim_sources()
+        newest = max(p.stat().st_mtime for p in sources + list((ROOT / "firmware").rglob("*.h")))
+        if not program.exists() or program.stat().st_mtime < newest:
+            program.parent.mkdir(parents=True, exist_ok=True)
+            cmd = [cxx, "-std=c++17", "-O2", f"-I{ROOT / 'firmware' / 'core'}", *map(str, sources),
+                   "-o", str(program)]
+            if subprocess.run(cmd).returncode != 0:
+                raise SystemExit("could not build the simulator shim: " + " ".join(cmd))
+        self.proc = subprocess.Popen([str(program)], stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+        self.next_id = 0
+        self.call("seed", seed)
+
+    def call(self, *args) -> str:
+        self.proc.stdin.write(" ".join(str(a) for a in args) + "\n")
+        self.proc.stdin.flush()
+        reply = self.proc.stdout.readline().strip()
+        if not reply or reply == "error":
+            raise SystemExit(f"simulator shim rejected: {' '.join(str(a) for a in args)}")
+        return reply
+
+    def new_id(self) -> int:
+        self.next_id += 1
+        return self.next_id
+
+    def close(self) -> None:
+        self.proc.stdin.close()
+        self.proc.wait()
+
+
+class Device:
+    """Virtual clock, battery and per-peripheral charge ledger."""
+
+    def __init__(self, profile: dict, capacity_mah: float, shim: Shim):
+        self.p = profile
+        self.shim = shim
+        self.capacity_mah = capacity_mah
+        self.now = 0.0                      # seconds since the start
+        self.charge = defaultdict(float)    # mA*ms per activity
+        self.counts = defaultdict(int)
+        self.awake_ms = 0.0
+        self.radio_up = False
+        self.fs_mounted = False
+        self.last_ota = -OTA_CHECK_INTERVAL_SECONDS
+        self.last_ntp = -TIME_SYNC_INTERVAL_SECONDS
+
+    def spend(self, name: str, ms: float, ma: float = 0.0) -> None:
+        """Awake for ms with a peripheral drawing ma over the CPU."""
+        self.charge[name] += (self.p["cpu_ma"] + ma) * ms
+        self.awake_ms += ms
+        self.now += ms / 1000.0
+
+    def used_mah(self) -> float:
+        return sum(self.charge.values()) / 3.6e6
+
+    def battery_percent(self) -> int:
+        return max(0, int(round(100 * (1 - self.used_mah() / self.capacity_mah))))
+
+    # Peripherals
+
+    def boot(self) -> None:
+        self.counts["wakes"] += 1
+        self.radio_up = False
+        self.fs_mounted = False
+        self.spend("boot", self.p["boot_ms"])
+        self.spend("battery_adc", self.p["battery_adc_ms"])
+
+    def wifi(self) -> None:
+        if not self.radio_up:
+            self.counts["wifi_wakes"] += 1
+            self.spend("wifi", self.p["wifi_connect_ms"], self.p["wifi_ma"])
+            self.radio_up = True
+
+    def http(self, tls: bool = True) -> None:
+        self.counts["requests"] += 1
+        self.spend("wifi", self.p["https_ms" if tls else "http_ms"], self.p["wifi_ma"])
+
+    def radio_tasks(self) -> None:
+        # WakeScheduler: OTA check and NTP resync when due, only while WiFi is up anyway
+        if not self.radio_up:
+            return
+        if self.now - self.last_ota >= OTA_CHECK_INTERVAL_SECONDS:
+            self.http(tls=True)
+            self.last_ota = self.now
+        if self.now - self.last_ntp >= TIME_SYNC_INTERVAL_SECONDS:
+            self.spend("wifi", self.p["ntp_ms"], self.p["wifi_ma"])
+            self.last_ntp = self.now
+
+    def epoch(self) -> int:
+        return SIM_EPOCH + int(self.now)
+
+    def sht31(self, min_samples: int, max_samples: int, budget_ms: int, reading: tuple) -> tuple:
+        """Sht31Engine begin() + acquire() on the room's reading; returns (ok, temp, humidity) as measured."""
+        ok, _, elapsed_ms, temp, humidity = self.shim.call(
+            "sht31", min_samples, max_samples, budget_ms, self.p["sht31_bus_ms"], *reading).split()
+        self.spend("sht31", float(elapsed_ms), self.p["sht31_ma"])
+        return ok == "1", float(temp), float(humidity)
+
+    def fs_read(self, inflate: bool = False) -> None:
+        if not self.fs_mounted:
+            self.fs_mounted = True
+            self.spend("flash", self.p["fs_mount_ms"])
+        self.spend("flash", self.p["fs_read_ms"] + (self.p["inflate_ms"] if inflate else 0))
+
+    def layout(self) -> None:
+        self.spend("layout", self.p["layout_ms"])
+
+    def panel(self) -> None:
+        self.shim.call("draw")   # every DisplayManager draw clears the shown-panel record
+        self.counts["refreshes"] += 1
+        self.spend("panel", self.p["panel_init_ms"] + self.p["panel_refresh_ms"], self.p["panel_ma"])
+
+    def sleep(self, seconds: float) -> None:
+        self.charge["sleep"] += self.p["sleep_ua"] / 1000.0 * seconds * 1000.0
+        self.now += seconds
+
+
+def get(config: dict, camel: str, snake: str, default):
+    if camel in config:
+        return config[camel]
+    return config.get(snake, default)
+
+
+class Environment:
+    """Synthetic room: diurnal temperature and humidity with a little noise."""
+
+    def __init__(self, rng: random.Random, temp_swing: float):
+        self.rng = rng
+        self.temp_swing = temp_swing
+
+    def reading(self, now: float):
+        phase = 2 * math.pi * (now % 86400) / 86400
+        temp = 21.0 + self.temp_swing / 2 * math.sin(phase - math.pi / 2) + self.rng.gauss(0, 0.05)
+        humidity = 45.0 - 4.0 * math.sin(phase - math.pi / 2) + self.rng.gauss(0, 0.3)
+        return temp, humidity
+
+
+class SensorModel:
+    name = "sensor"
+
+    def __init__(self, config: dict, args, env: Environment, shim: Shim):
+        self.interval_min = max(1, int(config.get("refreshInterval", 1)))
+        updated = str(get(config, "updatedTime", "updated_time", "time")).lower()
+        self.shim = shim
+        self.id = shim.new_id()
+        shim.call("sensor", self.id,
+                  float(get(config, "tempDeadbandC", "temp_deadband_c", SENSOR_DEFAULT_TEMP_DEADBAND_C)),
+                  float(get(config, "humidityDeadband", "humidity_deadband", SENSOR_DEFAULT_HUMIDITY_DEADBAND)),
+                  int(get(config, "minRepaintMinutes", "min_repaint_minutes", SENSOR_DEFAULT_MIN_REPAINT_MINUTES)) * 60,
+                  int(get(config, "maxRepaintMinutes", "max_repaint_minutes", SENSOR_DEFAULT_MAX_REPAINT_MINUTES)) * 60,
+                  {"date": "D", "off": "O", "none": "O"}.get(updated, "T"),
+                  int(bool(get(config, "showHistory", "show_history", True))))
+        # SensorApp::publish() returns early without a token (the default); each POST needs its sensor id
+        nemo = bool(get(config, "nemoToken", "nemo_token", "")) and bool(
+            get(config, "nemoUrl", "nemo_url", SENSOR_DEFAULT_NEMO_URL))
+        self.posts = sum(1 for camel, snake in (("temperatureSensorId", "temperature_sensor_id"),
+                                                ("humiditySensorId", "humidity_sensor_id"))
+                         if nemo and get(config, camel, snake, ""))
+        self.battery_post = nemo and bool(get(config, "batterySensorId", "battery_sensor_id", ""))
+        self.env = env
+        self.last_battery_post_day = -1
+
+    def wake(self, dev: Device) -> None:
+        ok, temp, humidity = dev.sht31(SENSOR_SHT31_MIN_SAMPLES, SENSOR_SHT31_MAX_SAMPLES, SENSOR_SHT31_BUDGET_MS,
+                                       self.env.reading(dev.now))
+        dev.wifi()
+        dev.radio_tasks()
+        if ok:
+            for _ in range(self.posts):
+                dev.http(tls=True)
+            day = int(dev.now // 86400)
+            if self.battery_post and day != self.last_battery_post_day:
+                dev.http(tls=True)
+                self.last_battery_post_day = day
+
+        reason = self.shim.call("sensor_wake", self.id, dev.epoch(), int(ok), 1, dev.battery_percent(),
+                                f"{temp:.3f}", f"{humidity:.3f}")
+        if reason != "skip":
+            dev.layout()
+            dev.panel()
+            self.shim.call("record", self.id, 0, dev.battery_percent())   # SensorApp only checks the owner
+
+    def sleep_seconds(self) -> float:
+        return self.interval_min * 60
+
+
+class FunModel:
+    name = "fun"
+
+    def __init__(self, config: dict, args, env: Environment, shim: Shim):
+        self.interval_min = max(1, int(config.get("refreshInterval", 2)))
+        self.env = env
+        apis = config.get("apis", {})
+        all_new = bool(apis.get("all_new_facts", False))
+        self.enabled = {
+            0: bool(apis.get("room_data", True)),
+            1: bool(apis.get("earthquake", True)),
+            2: all_new or bool(apis.get("cat_facts", True)),
+            3: bool(apis.get("iss", True)),
+            4: not all_new and bool(apis.get("useless_facts", True)),
+        }
+        self.special = bool(apis.get("special_messages", True))
+        self.packs = not args.no_packs and (self.enabled[2] or self.enabled[4])
+        self.mode = 0
+        self.rssi_at = None
+        self.pack_sync_at = None
+        self.queue = {2: 0, 4: 0}
+        self.queue_at = None
+
+    def wake(self, dev: Device) -> None:
+        for _ in range(5):
+            if self.enabled[self.mode]:
+                break
+            self.mode = (self.mode + 1) % 5
+        mode = self.mode
+        if not any(self.enabled.values()):
+            mode = -1
+
+        pack_sync_due = self.packs and (self.pack_sync_at is None or
+                                        dev.now - self.pack_sync_at >= FUN_PACK_SYNC_INTERVAL_HOURS * 3600)
+        queue_stale = self.queue_at is None or dev.now - self.queue_at >= FUN_QUEUE_MAX_AGE_HOURS * 3600
+        if mode == 0:
+            needs_wifi = self.rssi_at is None or dev.now - self.rssi_at >= FUN_ROOM_RSSI_MAX_AGE_HOURS * 3600
+        elif mode in (2, 4):
+            needs_wifi = not self.packs and (queue_stale or self.queue[mode] <= FUN_QUEUE_REFILL_AT)
+        else:
+            needs_wifi = mode in (1, 3)
+        needs_wifi = needs_wifi or pack_sync_due
+
+        # FunApp::acquire(): room data is the fallback for every mode, so it is read on every wake
+        dev.sht31(1, FUN_ROOM_MAX_SAMPLES, FUN_ROOM_BUDGET_MS, self.env.reading(dev.now))
+        if needs_wifi:
+            dev.wifi()
+            self.rssi_at = dev.now   # FunApp::fetch() caches the RSSI on every WiFi wake
+            if pack_sync_due:
+                dev.http(tls=True)   # manifest; packs rarely change
+                self.pack_sync_at = dev.now
+            if self.special and mode != 0:
+                dev.http(tls=True)
+            if mode in (1, 3):
+                dev.http(tls=True)
+            elif mode in (2, 4) and not self.packs:
+                dev.http(tls=True)   # one batch for every enabled fact mode
+                for m in self.queue:
+                    self.queue[m] = FUN_QUEUE_BATCH if self.enabled[m] else 0
+                self.queue_at = dev.now
+            dev.radio_tasks()
+
+        if mode in (2, 4):
+            if self.packs:
+                dev.fs_read(inflate=True)
+            elif self.queue[mode] > 0:
+                self.queue[mode] -= 1
+        dev.layout()
+        dev.panel()
+        self.mode = (self.mode + 1) % 5
+
+    def sleep_seconds(self) -> float:
+        return self.interval_min * 60
+
+
+class ShelfModel:
+    name = "shelf"
+
+    def __init__(self, config: dict, args, env: Environment, shim: Shim):
+        self.interval_min = max(1, int(config.get("refreshInterval", 5)))
+        self.change_per_wake = args.label_changes * self.interval_min / 1440.0
+        self.rng = env.rng
+        self.shim = shim
+        self.id = shim.new_id()
+        self.label = 0   # stands in for labelHash() of the label text
+
+    def wake(self, dev: Device) -> None:
+        dev.wifi()
+        dev.http(tls=False)   # lookup with If-None-Match; a 304 when unchanged
+        dev.radio_tasks()
+        if self.rng.random() < self.change_per_wake:
+            self.label += 1
+        battery = dev.battery_percent()
+        if self.shim.call("shown", self.id, self.label, battery, SHELF_BATTERY_DEADBAND_PCT) != "kept":
+            dev.layout()
+            dev.panel()
+            self.shim.call("record", self.id, self.label, battery)
+
+    def sleep_seconds(self) -> float:
+        return self.interval_min * 60
+
+
+class MessagesModel:
+    name = "messages"
+
+    def __init__(self, config: dict, args, env: Environment, shim: Shim):
+        self.interval_min = max(1, int(config.get("refreshInterval", 5)))
+        messages = config.get("messages")
+        if not isinstance(messages, list):
+            messages = [config[k] for k in (f"message{i}" for i in range(1, 11)) if k in config]
+        texts = [str(m) for m in messages if m] or ["No messages configured.\nAdd messages via BLE config."]
+        self.signatures = [int(shim.call("signature", t.encode().hex())) for t in texts]
+        self.shim = shim
+        self.id = shim.new_id()
+        self.index = 0
+
+    def wake(self, dev: Device) -> None:
+        signature = self.signatures[self.index]
+        battery = dev.battery_percent()
+        if self.shim.call("shown", self.id, signature, battery, MESSAGES_BATTERY_DEADBAND_PCT) != "kept":
+            dev.fs_read()   # stored frame, no layout
+            dev.panel()
+            self.shim.call("record", self.id, signature, battery)
+        self.index = (self.index + 1) % len(self.signatures)
+
+    def sleep_seconds(self) -> float:
+        return self.interval_min * 60
+
+
+APP_MODELS = {m.name: m for m in (SensorModel, FunModel, ShelfModel, MessagesModel)}
+
+
+def window_open(hour: int, from_hour, to_hour) -> bool:
+    if from_hour is None or to_hour is None or from_hour == to_hour:
+        return True
+    if from_hour < to_hour:
+        return from_hour <= hour < to_hour
+    return hour >= from_hour or hour < to_hour
+
+
+class PlaylistModel:
+    name = "playlist"
+
+    def __init__(self, entries: list, args, env: Environment, shim: Shim):
+        self.entries = []
+        for entry in entries:
+            model = APP_MODELS[entry["app"]](entry.get("config", {}), args, env, shim)
+            self.entries.append({
+                "model": model,
+                "interval": max(1, int(entry.get("interval", model.interval_min))) * 60,
+                "from": entry.get("fromHour"),
+                "to": entry.get("toHour"),
+                "last": None,
+            })
+        self.tz_offset = args.tz_offset * 3600
+
+    def _open(self, entry, t: float) -> bool:
+        return window_open(int(((t + self.tz_offset) % 86400) // 3600), entry["from"], entry["to"])
+
+    def _due_at(self, entry, t: float) -> float:
+        due = t if entry["last"] is None else max(t, entry["last"] + entry["interval"])
+        # Move to the start of the window, hour by hour (at most a day)
+        for _ in range(25):
+            if self._open(entry, due):
+                return due
+            due = (due // 3600 + 1) * 3600
+        return math.inf
+
+    def wake(self, dev: Device) -> None:
+        ready = [e for e in self.entries if self._due_at(e, dev.now) <= dev.now]
+        if not ready:
+            return
+        entry = min(ready, key=lambda e: -math.inf if e["last"] is None else e["last"] + e["interval"])
+        entry["last"] = dev.now
+        entry["model"].wake(dev)
+
+    def sleep_seconds(self, now: float) -> float:
+        next_due = min(self._due_at(e, now) for e in self.entries)
+        return max(PLAYLIST_MIN_SLEEP_SECONDS, next_due - now)
+
+
+def build_model(config: dict, args, env: Environment, shim: Shim):
+    if "playlist" in config:
+        return PlaylistModel(config["playlist"], args, env, shim)
+    app = config.get("app")
+    if app not in APP_MODELS:
+        raise SystemExit(f"unknown app {app!r}; expected one of {', '.join(APP_MODELS)} or a playlist")
+    return APP_MODELS[app](config.get("config", {}), args, env, shim)
+
+
+def simulate(label: str, config: dict, profile: dict, args) -> dict:
+    rng = random.Random(args.seed)
+    env = Environment(rng, args.temp_swing)
+    shim = Shim(args.cxx, args.seed)
+    model = build_model(config, args, env, shim)
+    dev = Device(profile, args.capacity_mah, shim)
+    end = args.days * 86400
+    while dev.now < end:
+        dev.boot()
+        model.wake(dev)
+        if isinstance(model, PlaylistModel):
+            dev.sleep(model.sleep_seconds(dev.now))
+        else:
+            dev.sleep(model.sleep_seconds())
+    shim.close()
+
+    days = dev.now / 86400
+    used = dev.used_mah()
+    usable = args.capacity_mah * (100 - BATTERY_LOW_THRESHOLD_PERCENT) / 100
+    return {
+        "label": label,
+        "days": days,
+        "per_day": {name: mas / 3.6e6 / days for name, mas in dev.charge.items()},
+        "avg_ua": used / (dev.now / 3600) * 1000,
+        "life_days": usable / (used / days),
+        "wakes": dev.counts["wakes"] / days,
+        "wifi_wakes": dev.counts["wifi_wakes"] / days,
+        "refreshes": dev.counts["refreshes"] / days,
+        "requests": dev.counts["requests"] / days,
+        "awake_s": dev.awake_ms / 1000 / days,
+    }
+
+
+def report(results: list) -> None:
+    for r in results:
+        print(f"\n{r['label']}")
+        print(f"  per day: {r['wakes']:.0f} wakes, {r['wifi_wakes']:.1f} with WiFi, "
+              f"{r['requests']:.0f} requests, {r['refreshes']:.1f} panel refreshes, {r['awake_s']:.0f} s awake")
+        total = sum(r["per_day"].values())
+        for name, mah in sorted(r["per_day"].items(), key=lambda kv: -kv[1]):
+            print(f"  {name:<12} {mah:8.2f} mAh/day  {100 * mah / total:5.1f}%")
+        print(f"  average {r['avg_ua']:.0f} uA -> {r['life_days']:.0f} days on the battery")
+
+    if len(results) > 1:
+        print(f"\n{'config':<36} {'uA':>7} {'days':>7} {'wifi/d':>7} {'refr/d':>7}")
+        for r in results:
+            print(f"{r['label'][:36]:<36} {r['avg_ua']:7.0f} {r['life_days']:7.0f} "
+                  f"{r['wifi_wakes']:7.1f} {r['refreshes']:7.1f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Projected battery life per app and config")
+    parser.add_argument("configs", nargs="*", help="provisioning JSON files (default: each app with defaults)")
+    parser.add_argument("--days", type=float, default=14, help="simulated time per config")
+    parser.add_argument("--capacity-mah", type=float, default=1000)
+    parser.add_argument("--profile", help="JSON file overriding DEFAULT_PROFILE entries")
+    parser.add_argument("--no-packs", action="store_true", help="fun app without the LittleFS fact packs")
+    parser.add_argument("--label-changes", type=float, default=0.2, help="shelf label changes per day")
+    parser.add_argument("--temp-swing", type=float, default=2.0, help="daily room temperature swing, C")
+    parser.add_argument("--tz-offset", type=int, default=0, help="hours from UTC for playlist windows")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"), help="host compiler for the shim")
+    args = parser.parse_args()
+
+    profile = dict(DEFAULT_PROFILE)
+    if args.profile:
+        with open(args.profile) as f:
+            overrides = json.load(f)
+        unknown = set(overrides) - set(profile)
+        if unknown:
+            raise SystemExit(f"unknown profile keys: {', '.join(sorted(unknown))}")
+        profile.update(overrides)
+
+    runs = []
+    if args.configs:
+        for path in args.configs:
+            with open(path) as f:
+                runs.append((path, json.load(f)))
+    else:
+        runs = [(f"{name} (defaults)", {"app": name}) for name in APP_MODELS]
+
+    report([simulate(label, config, profile, args) for label, config in runs])
+
+
+if __name__ == "__main__":
+    main()
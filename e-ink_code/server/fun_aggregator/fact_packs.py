@@ -0,0 +1,145 @@
+"""Compressed fact packs for offline fun devices.
+
+A pack holds one ``data/*_facts.json`` pool. Devices download packs into their
+LittleFS partition (at most daily, only packs whose version changed) and then
+pick random facts without the network. Layout, all integers little-endian:
+
+    header   40 bytes  magic "EFP1", version u32, fact_count u16, block_count u16,
+                       facts_per_block u16, 2 pad bytes, title 24 bytes (UTF-8, NUL padded)
+    index    8 bytes per block: offset u32 (from file start), compressed_len u16, raw_len u16
+    blocks   zlib streams; each inflates to up to facts_per_block facts separated by NUL
+
+Fact ``i`` lives in block ``i // facts_per_block``, so a device reads one index
+entry and inflates one small block (see firmware ``apps/fun/fact_packs.cpp``).
+The version is a CRC of the title and facts: unchanged pools keep their version.
+"""
+
+from __future__ import annotations
+
+import os
+import re
+import struct
+import zlib
+from typing import Any
+
+from pools import get_pool, nonempty_fact_pool_ids, slide_title_for_pool
+
+MAGIC = b"EFP1"
+HEADER = struct.Struct("<4sIHHH2x24s")
+INDEX_ENTRY = struct.Struct("<IHH")
+TITLE_BYTES = 24
+MAX_FACTS = 0xFFFF
+MAX_BLOCK_RAW = 0xFFFF
+
+# Pool ids double as device file names (/packs/<id>.pk)
+POOL_ID_RE = re.compile(r"^[a-z0-9_]{1,24}$")
+
+
+def facts_per_block_from_env() -> int:
+    return max(1, min(64, int(os.getenv("FUN_PACK_FACTS_PER_BLOCK", "16"))))
+
+
+def _encode_title(title: str) -> bytes:
+    raw = title.encode("utf-8")[: TITLE_BYTES - 1]
+    # Never cut a multi-byte character in half
+    return raw.decode("utf-8", errors="ignore").encode("utf-8")
+
+
+def pack_version(title: str, facts: list[str]) -> int:
+    crc = zlib.crc32(title.encode("utf-8"))
+    for fact in facts:
+        crc = zlib.crc32(b"\0" + fact.encode("utf-8"), crc)
+    return crc or 1  # 0 means "no pack" on the device
+
+
+def build_pack(title: str, facts: list[str], facts_per_block: int | None = None) -> bytes:
+    """Serialize facts into the pack layout above."""
+    per_block = facts_per_block or facts_per_block_from_env()
+    facts = [f.strip() for f in facts if f and f.strip()][:MAX_FACTS]
+    blocks: list[tuple[bytes, int]] = []
+    for start in range(0, len(facts), per_block):
+        raw = b"\0".join(f.replace("\0", "").encode("utf-8") for f in facts[start : start + per_block])
+        if len(raw) > MAX_BLOCK_RAW:
+            raise ValueError("fact block too large; lower FUN_PACK_FACTS_PER_BLOCK")
+        blocks.append((zlib.compress(raw, 9), len(raw)))
+
+    header = HEADER.pack(
+        MAGIC,
+        pack_version(title, facts),
+        len(facts),
+        len(blocks),
+        per_block,
+        _encode_title(title).ljust(TITLE_BYTES, b"\0"),
+    )
+    offset = HEADER.size + INDEX_ENTRY.size * len(blocks)
+    index = bytearray()
+    for compressed, raw_len in blocks:
+        index += INDEX_ENTRY.pack(offset, len(compressed), raw_len)
+        offset += len(compressed)
+    return header + bytes(index) + b"".join(c for c, _ in blocks)
+
+
+def pack_info(data: bytes) -> dict[str, Any]:
+    magic, version, count, block_count, per_block, title = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("not a fact pack")
+    return {
+        "version": version,
+        "facts": count,
+        "blocks": block_count,
+        "facts_per_block": per_block,
+        "title": title.rstrip(b"\0").decode("utf-8"),
+    }
+
+
+def read_pack_fact(data: bytes, index: int) -> str:
+    """Reference reader, same steps as the firmware: one index entry, one block."""
+    info = pack_info(data)
+    if not 0 <= index < info["facts"]:
+        raise IndexError(index)
+    block, within = divmod(index, info["facts_per_block"])
+    offset, comp_len, raw_len = INDEX_ENTRY.unpack_from(data, HEADER.size + block * INDEX_ENTRY.size)
+    raw = zlib.decompress(data[offset : offset + comp_len])
+    if len(raw) != raw_len:
+        raise ValueError("block length mismatch")
+    return raw.split(b"\0")[within].decode("utf-8")
+
+
+_cache: dict[str, tuple[int, bytes]] = {}
+
+
+def get_pack(pool_id: str) -> tuple[int, bytes] | None:
+    """(version, bytes) for a non-empty pool, rebuilt only when the pool changed."""
+    if not POOL_ID_RE.match(pool_id):
+        return None
+    facts = get_pool(pool_id)
+    if not facts:
+        return None
+    title = slide_title_for_pool(pool_id)
+    version = pack_version(title, facts)
+    cached = _cache.get(pool_id)
+    if cached is None or cached[0] != version:
+        cached = (version, build_pack(title, facts))
+        _cache[pool_id] = cached
+    return cached
+
+
+def manifest() -> dict[str, Any]:
+    """What GET /v1/fun/packs returns: one entry per downloadable pack."""
+    packs = []
+    for pool_id in nonempty_fact_pool_ids():
+        if not POOL_ID_RE.match(pool_id):
+            continue
+        built = get_pack(pool_id)
+        if built is None:
+            continue
+        version, data = built
+        packs.append(
+            {
+                "id": pool_id,
+                "version": version,
+                "facts": pack_info(data)["facts"],
+                "bytes": len(data),
+            }
+        )
+    return {"packs": packs}
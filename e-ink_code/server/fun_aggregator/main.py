@@ -39,6 +39,7 @@ from slowapi.util import get_remote_address
 from starlette.responses import Response
 
 import device_roster
+import fact_packs
 import special_messages
 from models import FunSlide
 from fact_harvest import fact_interval_from_env, fact_state_snapshot, start_fact_harvest_task
@@ -332,3 +333,29 @@ async def fun_facts_mixed(
     if not slides:
         raise HTTPException(status_code=503, detail="No fact pools available")
     return JSONResponse(content={"facts": slides})
+
+
+@app.get("/v1/fun/packs")
+@limiter.limit(_rate_batch())
+async def fun_packs_manifest(request: Request):
+    """Offline fact packs: id + version per pool, so devices fetch only changed packs."""
+    _check_fun_key(_extract_x_fun_key(request))
+    did, dname = _device_headers(request)
+    device_roster.note_seen(did, dname)
+    _log_client_identity(request)
+    return JSONResponse(content=fact_packs.manifest())
+
+
+@app.get("/v1/fun/packs/{pool_id}")
+@limiter.limit(_rate_batch())
+async def fun_pack(request: Request, pool_id: str):
+    """One compressed fact pack (layout in fact_packs.py); ETag is the pack version."""
+    _check_fun_key(_extract_x_fun_key(request))
+    built = fact_packs.get_pack(pool_id)
+    if built is None:
+        raise HTTPException(status_code=404, detail="Unknown or empty fact pool")
+    version, data = built
+    etag = f'"{version}"'
+    if request.headers.get("if-none-match") == etag:
+        return Response(status_code=304, headers={"ETag": etag})
+    return Response(content=data, media_type="application/octet-stream", headers={"ETag": etag})
@@ -54,15 +54,19 @@ def nonempty_fact_pool_ids() -> list[str]:
     return out
 
 
-def format_slide_for_pool(pool_id: str, body: str) -> str:
-    """Heading + body; matches legacy cat/useless strings for built-in pools."""
+def slide_title_for_pool(pool_id: str) -> str:
+    """Red heading line for slides from this pool."""
     if pool_id == "cat_facts":
-        return format_cat_slide(body)
+        return "Cat Facts"
     if pool_id == "useless_facts":
-        return format_useless_slide(body)
+        return "Fun Fact!"
     base = pool_id[: -len("_facts")] if pool_id.endswith("_facts") else pool_id
-    title = base.replace("_", " ").strip().title() + " Facts"
-    return title + "\n" + body.strip()
+    return base.replace("_", " ").strip().title() + " Facts"
+
+
+def format_slide_for_pool(pool_id: str, body: str) -> str:
+    """Heading + body; matches legacy cat/useless strings for built-in pools."""
+    return slide_title_for_pool(pool_id) + "\n" + body.strip()
 
 
 def sample_mixed_slides(count: int, cap: int) -> list[dict[str, Any]]:
@@ -0,0 +1,80 @@
+"""Tests for fact_packs: pack layout, random access, versions and the manifest."""
+
+from __future__ import annotations
+
+import json
+from pathlib import Path
+
+import pytest
+
+import fact_packs
+import pools
+
+
+def _facts(n: int) -> list[str]:
+    return [f"Fact number {i} — with a non-ASCII dash and some padding text." for i in range(n)]
+
+
+def test_every_fact_reads_back_from_its_block() -> None:
+    facts = _facts(37)
+    data = fact_packs.build_pack("Cat Facts", facts, facts_per_block=8)
+    info = fact_packs.pack_info(data)
+    assert info["facts"] == 37
+    assert info["blocks"] == 5
+    assert info["title"] == "Cat Facts"
+    for i, fact in enumerate(facts):
+        assert fact_packs.read_pack_fact(data, i) == fact
+    with pytest.raises(IndexError):
+        fact_packs.read_pack_fact(data, 37)
+
+
+def test_index_offsets_are_contiguous() -> None:
+    data = fact_packs.build_pack("Fun Fact!", _facts(20), facts_per_block=4)
+    info = fact_packs.pack_info(data)
+    expected = fact_packs.HEADER.size + fact_packs.INDEX_ENTRY.size * info["blocks"]
+    for block in range(info["blocks"]):
+        offset, comp_len, _ = fact_packs.INDEX_ENTRY.unpack_from(
+            data, fact_packs.HEADER.size + block * fact_packs.INDEX_ENTRY.size
+        )
+        assert offset == expected
+        expected += comp_len
+    assert expected == len(data)
+
+
+def test_version_tracks_content_only() -> None:
+    facts = _facts(5)
+    a = fact_packs.build_pack("Cat Facts", facts, facts_per_block=2)
+    b = fact_packs.build_pack("Cat Facts", list(facts), facts_per_block=4)
+    c = fact_packs.build_pack("Cat Facts", facts + ["One more"], facts_per_block=2)
+    assert fact_packs.pack_info(a)["version"] == fact_packs.pack_info(b)["version"]
+    assert fact_packs.pack_info(a)["version"] != fact_packs.pack_info(c)["version"]
+    assert fact_packs.pack_info(a)["version"] != 0
+
+
+def test_long_title_is_truncated_on_a_character_boundary() -> None:
+    data = fact_packs.build_pack("Ü" * 30, ["x"])
+    title = fact_packs.pack_info(data)["title"]
+    assert title == "Ü" * 11
+    assert len(title.encode("utf-8")) < fact_packs.TITLE_BYTES
+
+
+def test_manifest_and_get_pack(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> None:
+    (tmp_path / "cat_facts.json").write_text(json.dumps(["Cats purr.", "Cats nap."]), encoding="utf-8")
+    (tmp_path / "empty_facts.json").write_text("[]", encoding="utf-8")
+    (tmp_path / "Bad-Name_facts.json").write_text(json.dumps(["x"]), encoding="utf-8")
+    monkeypatch.setattr(pools, "_DATA", tmp_path)
+    fact_packs._cache.clear()
+
+    packs = fact_packs.manifest()["packs"]
+    assert [p["id"] for p in packs] == ["cat_facts"]
+    version, data = fact_packs.get_pack("cat_facts")
+    assert packs[0]["version"] == version
+    assert packs[0]["bytes"] == len(data)
+    assert fact_packs.read_pack_fact(data, 1) == "Cats nap."
+    assert fact_packs.get_pack("empty_facts") is None
+    assert fact_packs.get_pack("../cat_facts") is None
+
+    # Cached until the pool changes
+    assert fact_packs.get_pack("cat_facts")[1] is data
+    (tmp_path / "cat_facts.json").write_text(json.dumps(["Cats purr."]), encoding="utf-8")
+    assert fact_packs.get_pack("cat_facts")[0] != version
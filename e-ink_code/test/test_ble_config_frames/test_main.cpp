@@ -0,0 +1,151 @@
+// Host-side tests for the framed BLE config transfer: pio test -e native
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "bluetooth/ble_config_frames.h"
+
+static uint8_t s_buffer[4000];
+static BleConfigAssembler s_assembler(s_buffer, sizeof(s_buffer));
+
+static std::string makeConfig(size_t length) {
+    std::string json = "{\"mode\":\"messages\",\"messages\":[\"";
+    while (json.size() < length - 3) {
+        json += (char)('a' + json.size() % 26);
+    }
+    json += "\"]}";
+    return json;
+}
+
+static uint8_t sendStart(const std::string& payload, uint32_t crcOverride = 0) {
+    uint8_t frame[BLE_CONFIG_START_FRAME_SIZE];
+    uint32_t total = (uint32_t)payload.size();
+    uint32_t crc = crcOverride ? crcOverride
+                               : BleConfigAssembler::crc32(0, (const uint8_t*)payload.data(), payload.size());
+    frame[0] = BLE_CONFIG_FRAME_START;
+    for (int i = 0; i < 4; i++) {
+        frame[1 + i] = (uint8_t)(total >> (8 * i));
+        frame[5 + i] = (uint8_t)(crc >> (8 * i));
+    }
+    return s_assembler.feed(frame, sizeof(frame));
+}
+
+static uint8_t sendData(uint16_t seq, const std::string& payload, size_t offset, size_t len) {
+    uint8_t frame[BLE_CONFIG_DATA_HEADER_SIZE + 512];
+    frame[0] = BLE_CONFIG_FRAME_DATA;
+    frame[1] = (uint8_t)seq;
+    frame[2] = (uint8_t)(seq >> 8);
+    memcpy(frame + BLE_CONFIG_DATA_HEADER_SIZE, payload.data() + offset, len);
+    return s_assembler.feed(frame, BLE_CONFIG_DATA_HEADER_SIZE + len);
+}
+
+void setUp() {
+    s_assembler.reset();
+}
+
+void tearDown() {}
+
+void test_crc32_matches_zlib() {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, BleConfigAssembler::crc32(0, (const uint8_t*)check, 9));
+    // Incremental == one shot
+    uint32_t crc = BleConfigAssembler::crc32(0, (const uint8_t*)check, 4);
+    crc = BleConfigAssembler::crc32(crc, (const uint8_t*)check + 4, 5);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc);
+}
+
+void test_legacy_single_write() {
+    const char* json = "{\"mode\":\"fun\"}";
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_COMPLETE, s_assembler.feed((const uint8_t*)json, strlen(json)));
+    TEST_ASSERT_EQUAL_STRING(json, s_assembler.text());
+}
+
+void test_fragmented_transfer_random_sizes() {
+    srand(1234);
+    for (int round = 0; round < 50; round++) {
+        s_assembler.reset();
+        std::string payload = makeConfig(200 + rand() % 3500);
+        TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_PROGRESS, sendStart(payload));
+        size_t offset = 0;
+        uint16_t seq = 0;
+        uint8_t status = BLE_CONFIG_STATUS_PROGRESS;
+        while (offset < payload.size()) {
+            // Anything from the default-MTU 17-byte payload up to a 512-byte MTU
+            size_t len = 1 + rand() % 509;
+            if (len > payload.size() - offset) len = payload.size() - offset;
+            status = sendData(seq++, payload, offset, len);
+            offset += len;
+            TEST_ASSERT_EQUAL_UINT32(offset, s_assembler.ack().received);
+        }
+        TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_COMPLETE, status);
+        TEST_ASSERT_EQUAL_size_t(payload.size(), s_assembler.length());
+        TEST_ASSERT_EQUAL_STRING(payload.c_str(), s_assembler.text());
+    }
+}
+
+void test_out_of_order_frame_resumes() {
+    std::string payload = makeConfig(300);
+    sendStart(payload);
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_PROGRESS, sendData(0, payload, 0, 100));
+    // Frame 1 lost; frame 2 arrives
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_BAD_SEQUENCE, sendData(2, payload, 200, 100));
+    TEST_ASSERT_EQUAL_UINT16(1, s_assembler.ack().nextSeq);
+    TEST_ASSERT_EQUAL_UINT32(100, s_assembler.ack().received);
+    // Sender rewinds to nextSeq
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_PROGRESS, sendData(1, payload, 100, 100));
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_COMPLETE, sendData(2, payload, 200, 100));
+    TEST_ASSERT_EQUAL_STRING(payload.c_str(), s_assembler.text());
+}
+
+void test_crc_mismatch_rejected() {
+    std::string payload = makeConfig(100);
+    sendStart(payload, 0xDEADBEEF);
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_BAD_CRC, sendData(0, payload, 0, payload.size()));
+    TEST_ASSERT_FALSE(s_assembler.isComplete());
+    TEST_ASSERT_FALSE(s_assembler.inProgress());
+}
+
+void test_too_large_and_overrun_rejected() {
+    std::string payload = makeConfig(sizeof(s_buffer));
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_TOO_LARGE, sendStart(payload));
+
+    std::string small = makeConfig(50);
+    sendStart(small);
+    std::string longer = makeConfig(80);
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_BAD_FRAME, sendData(0, longer, 0, longer.size()));
+    TEST_ASSERT_FALSE(s_assembler.inProgress());
+}
+
+void test_data_without_start_and_abort() {
+    std::string payload = makeConfig(50);
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_BAD_FRAME, sendData(0, payload, 0, 10));
+
+    sendStart(payload);
+    sendData(0, payload, 0, 10);
+    const uint8_t abortFrame = BLE_CONFIG_FRAME_ABORT;
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_ABORTED, s_assembler.feed(&abortFrame, 1));
+    // A fresh transfer works after an abort
+    sendStart(payload);
+    TEST_ASSERT_EQUAL_UINT8(BLE_CONFIG_STATUS_COMPLETE, sendData(0, payload, 0, payload.size()));
+}
+
+void test_ack_encoding() {
+    BleConfigAck ack = {BLE_CONFIG_STATUS_BAD_SEQUENCE, 0x0102, 0x03040506};
+    uint8_t out[BLE_CONFIG_ACK_SIZE];
+    TEST_ASSERT_EQUAL_size_t(BLE_CONFIG_ACK_SIZE, BleConfigAssembler::encodeAck(ack, 247, 4000, out));
+    const uint8_t expected[BLE_CONFIG_ACK_SIZE] = {0x81, 0x02, 0x01, 0x06, 0x05, 0x04, 0x03, 247, 0, 0xA0, 0x0F};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, out, BLE_CONFIG_ACK_SIZE);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_matches_zlib);
+    RUN_TEST(test_legacy_single_write);
+    RUN_TEST(test_fragmented_transfer_random_sizes);
+    RUN_TEST(test_out_of_order_frame_resumes);
+    RUN_TEST(test_crc_mismatch_rejected);
+    RUN_TEST(test_too_large_and_overrun_rejected);
+    RUN_TEST(test_data_without_start_and_abort);
+    RUN_TEST(test_ack_encoding);
+    return UNITY_END();
+}
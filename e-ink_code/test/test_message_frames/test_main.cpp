@@ -0,0 +1,97 @@
+// Host-side tests for the pre-rendered message frame codec: pio test -e native
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../firmware/apps/messages/frame_codec.h"
+
+static const size_t kPlane = 128 / 8 * 296;  // native 128 x 296 panel
+
+static uint8_t s_plane[kPlane];
+static uint8_t s_packed[kPlane + kPlane / 128 + 8];
+static uint8_t s_unpacked[kPlane];
+
+static size_t roundTrip() {
+    size_t packed = messageFramePack(s_plane, kPlane, s_packed, sizeof(s_packed));
+    TEST_ASSERT_TRUE(packed > 0);
+    TEST_ASSERT_TRUE(packed <= messageFramePackBound(kPlane));
+    memset(s_unpacked, 0x5A, sizeof(s_unpacked));
+    TEST_ASSERT_TRUE(messageFrameUnpack(s_packed, packed, s_unpacked, kPlane));
+    TEST_ASSERT_EQUAL_MEMORY(s_plane, s_unpacked, kPlane);
+    return packed;
+}
+
+void setUp() {
+    memset(s_plane, 0xFF, sizeof(s_plane));
+}
+
+void tearDown() {}
+
+void test_blank_plane_packs_to_runs() {
+    size_t packed = roundTrip();
+    TEST_ASSERT_EQUAL(2 * ((kPlane + 127) / 128), packed);
+}
+
+void test_text_like_plane_round_trips_small() {
+    // A few lines of glyph-like noise in an otherwise white plane
+    srand(3);
+    for (int row = 20; row < 120; row += 25) {
+        for (int y = row; y < row + 12; y++) {
+            for (int x = 1; x < 15; x++) {
+                s_plane[y * 16 + x] = static_cast<uint8_t>(rand());
+            }
+        }
+    }
+    size_t packed = roundTrip();
+    TEST_ASSERT_TRUE(packed < kPlane / 3);
+}
+
+void test_incompressible_plane_stays_within_bound() {
+    srand(11);
+    for (size_t i = 0; i < kPlane; i++) {
+        s_plane[i] = static_cast<uint8_t>(rand());
+    }
+    roundTrip();
+}
+
+void test_runs_and_literals_alternate() {
+    for (size_t i = 0; i < kPlane; i++) {
+        s_plane[i] = (i / 3) % 2 ? static_cast<uint8_t>(i) : 0x00;
+    }
+    roundTrip();
+}
+
+void test_pack_fails_when_output_too_small() {
+    srand(5);
+    for (size_t i = 0; i < kPlane; i++) {
+        s_plane[i] = static_cast<uint8_t>(rand());
+    }
+    TEST_ASSERT_EQUAL(0, messageFramePack(s_plane, kPlane, s_packed, 100));
+}
+
+void test_unpack_rejects_truncated_and_short_input() {
+    size_t packed = messageFramePack(s_plane, kPlane, s_packed, sizeof(s_packed));
+    TEST_ASSERT_FALSE(messageFrameUnpack(s_packed, packed - 1, s_unpacked, kPlane));
+    TEST_ASSERT_FALSE(messageFrameUnpack(s_packed, packed - 2, s_unpacked, kPlane));
+    // More output than the plane holds
+    TEST_ASSERT_FALSE(messageFrameUnpack(s_packed, packed, s_unpacked, kPlane - 1));
+}
+
+void test_signature_follows_text() {
+    const char* a = "Back at 3pm";
+    const char* b = "Back at 4pm";
+    TEST_ASSERT_EQUAL_UINT32(messageFrameSignature(a, strlen(a)), messageFrameSignature(a, strlen(a)));
+    TEST_ASSERT_TRUE(messageFrameSignature(a, strlen(a)) != messageFrameSignature(b, strlen(b)));
+    TEST_ASSERT_TRUE(messageFrameSignature("", 0) != 0);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_blank_plane_packs_to_runs);
+    RUN_TEST(test_text_like_plane_round_trips_small);
+    RUN_TEST(test_incompressible_plane_stays_within_bound);
+    RUN_TEST(test_runs_and_literals_alternate);
+    RUN_TEST(test_pack_fails_when_output_too_small);
+    RUN_TEST(test_unpack_rejects_truncated_and_short_input);
+    RUN_TEST(test_signature_follows_text);
+    return UNITY_END();
+}
@@ -0,0 +1,190 @@
+// Host-side tests for the RTC state slots: pio test -e native
+// "Deep sleep" keeps the arena bytes and re-runs begin() warm on a fresh store
+// object; "power loss" fills the arena with noise and begins cold.
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rtc/rtc_state_store.h"
+
+static const uint32_t kBuild = 0x1234ABCD;
+
+struct CounterState {
+    int32_t displayMode = 0;
+    uint8_t holdCycles = 0;
+};
+
+struct DateState {
+    char lastPost[11] = "";
+};
+
+struct WideState {
+    uint64_t stamp = 7;
+    uint32_t values[16] = {0};
+};
+
+alignas(8) static uint8_t s_arena[RTC_STATE_ARENA_SIZE];
+
+// One wake: a new store object over the same memory, as after a deep-sleep reboot
+static RtcStateStore wake(bool warm, uint32_t build = kBuild, bool* kept = nullptr) {
+    RtcStateStore store(s_arena, sizeof(s_arena));
+    bool k = store.begin(build, warm);
+    if (kept) *kept = k;
+    return store;
+}
+
+void setUp() {
+    memset(s_arena, 0xA5, sizeof(s_arena));
+}
+
+void tearDown() {}
+
+void test_first_boot_formats_and_defaults() {
+    bool kept = true;
+    RtcStateStore store = wake(false, kBuild, &kept);
+    TEST_ASSERT_FALSE(kept);
+    bool restored = true;
+    CounterState* state = store.slot<CounterState>(RTC_SLOT_FUN_APP, 1, &restored);
+    TEST_ASSERT_NOT_NULL(state);
+    TEST_ASSERT_FALSE(restored);
+    TEST_ASSERT_EQUAL_INT32(0, state->displayMode);
+}
+
+void test_state_survives_deep_sleep() {
+    RtcStateStore first = wake(false);
+    CounterState* state = first.slot<CounterState>(RTC_SLOT_FUN_APP, 1);
+    DateState* date = first.slot<DateState>(RTC_SLOT_SENSOR_APP, 1);
+    state->displayMode = 3;
+    strcpy(date->lastPost, "2026-10-18");
+    first.commit();
+
+    bool kept = false;
+    RtcStateStore second = wake(true, kBuild, &kept);
+    TEST_ASSERT_TRUE(kept);
+    bool restored = false;
+    // Registration order does not matter
+    date = second.slot<DateState>(RTC_SLOT_SENSOR_APP, 1, &restored);
+    TEST_ASSERT_TRUE(restored);
+    TEST_ASSERT_EQUAL_STRING("2026-10-18", date->lastPost);
+    state = second.slot<CounterState>(RTC_SLOT_FUN_APP, 1, &restored);
+    TEST_ASSERT_TRUE(restored);
+    TEST_ASSERT_EQUAL_INT32(3, state->displayMode);
+}
+
+void test_repeated_lookup_in_one_wake_keeps_changes() {
+    RtcStateStore store = wake(false);
+    store.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode = 2;
+    bool restored = false;
+    CounterState* again = store.slot<CounterState>(RTC_SLOT_FUN_APP, 1, &restored);
+    TEST_ASSERT_TRUE(restored);
+    TEST_ASSERT_EQUAL_INT32(2, again->displayMode);
+}
+
+void test_power_loss_discards_everything() {
+    RtcStateStore first = wake(false);
+    first.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode = 4;
+    first.commit();
+
+    // Same bytes, but a cold reset: nothing may be trusted
+    bool kept = true;
+    RtcStateStore second = wake(false, kBuild, &kept);
+    TEST_ASSERT_FALSE(kept);
+    bool restored = true;
+    TEST_ASSERT_EQUAL_INT32(0, second.slot<CounterState>(RTC_SLOT_FUN_APP, 1, &restored)->displayMode);
+    TEST_ASSERT_FALSE(restored);
+}
+
+void test_garbage_after_power_loss_is_rejected_even_if_warm() {
+    srand(99);
+    for (int round = 0; round < 200; round++) {
+        for (size_t i = 0; i < sizeof(s_arena); i++) {
+            s_arena[i] = (uint8_t)rand();
+        }
+        bool kept = true;
+        RtcStateStore store = wake(true, kBuild, &kept);
+        TEST_ASSERT_FALSE(kept);
+        TEST_ASSERT_EQUAL_INT32(0, store.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode);
+    }
+}
+
+void test_firmware_change_formats() {
+    RtcStateStore first = wake(false);
+    first.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode = 2;
+    first.commit();
+
+    bool kept = true;
+    RtcStateStore second = wake(true, kBuild + 1, &kept);
+    TEST_ASSERT_FALSE(kept);
+    TEST_ASSERT_EQUAL_INT32(0, second.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode);
+}
+
+void test_uncommitted_change_is_dropped() {
+    RtcStateStore first = wake(false);
+    first.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode = 1;
+    first.commit();
+
+    // Next wake changes the state, then resets (panic / watchdog) before sleeping
+    RtcStateStore second = wake(true);
+    second.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode = 4;
+
+    bool restored = true;
+    RtcStateStore third = wake(true);
+    CounterState* state = third.slot<CounterState>(RTC_SLOT_FUN_APP, 1, &restored);
+    TEST_ASSERT_FALSE(restored);
+    TEST_ASSERT_EQUAL_INT32(0, state->displayMode);
+}
+
+void test_version_change_resets_only_that_slot() {
+    RtcStateStore first = wake(false);
+    first.slot<CounterState>(RTC_SLOT_FUN_APP, 1)->displayMode = 3;
+    strcpy(first.slot<DateState>(RTC_SLOT_SENSOR_APP, 1)->lastPost, "2026-01-01");
+    first.commit();
+
+    RtcStateStore second = wake(true);
+    bool restored = true;
+    TEST_ASSERT_EQUAL_INT32(0, second.slot<CounterState>(RTC_SLOT_FUN_APP, 2, &restored)->displayMode);
+    TEST_ASSERT_FALSE(restored);
+    TEST_ASSERT_EQUAL_STRING("2026-01-01", second.slot<DateState>(RTC_SLOT_SENSOR_APP, 1, &restored)->lastPost);
+    TEST_ASSERT_TRUE(restored);
+}
+
+void test_growth_and_alignment() {
+    RtcStateStore store = wake(false);
+    store.slot<DateState>(RTC_SLOT_SENSOR_APP, 1);
+    WideState* wide = store.slot<WideState>(RTC_SLOT_FUN_APP, 1);
+    TEST_ASSERT_NOT_NULL(wide);
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)wide % 8);
+    TEST_ASSERT_EQUAL_UINT64(7, wide->stamp);
+    wide->values[15] = 42;
+    store.commit();
+
+    // Same id grows (new layout version): old space is retired, data reset
+    RtcStateStore next = wake(true);
+    struct Bigger { uint8_t bytes[200]; };
+    bool restored = true;
+    Bigger* big = next.slot<Bigger>(RTC_SLOT_FUN_APP, 2, &restored);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_FALSE(restored);
+    TEST_ASSERT_EQUAL_UINT8(0, big->bytes[199]);
+}
+
+void test_arena_full_returns_null() {
+    RtcStateStore store = wake(false);
+    struct Huge { uint8_t bytes[RTC_STATE_ARENA_SIZE]; };
+    TEST_ASSERT_NULL(store.slot<Huge>(RTC_SLOT_FUN_APP, 1));
+    TEST_ASSERT_NOT_NULL(store.slot<CounterState>(RTC_SLOT_SENSOR_APP, 1));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_boot_formats_and_defaults);
+    RUN_TEST(test_state_survives_deep_sleep);
+    RUN_TEST(test_repeated_lookup_in_one_wake_keeps_changes);
+    RUN_TEST(test_power_loss_discards_everything);
+    RUN_TEST(test_garbage_after_power_loss_is_rejected_even_if_warm);
+    RUN_TEST(test_firmware_change_formats);
+    RUN_TEST(test_uncommitted_change_is_dropped);
+    RUN_TEST(test_version_change_resets_only_that_slot);
+    RUN_TEST(test_growth_and_alignment);
+    RUN_TEST(test_arena_full_returns_null);
+    return UNITY_END();
+}
@@ -0,0 +1,166 @@
+// Host-side tests for the sensor history ring: pio test -e native
+// Incremental statistics are checked against a brute-force pass over the same buckets.
+#include <unity.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../../firmware/apps/sensor/history.h"
+
+static const uint32_t kT0 = 1760000000;  // bucket-aligned start (2025)
+static const uint32_t kBucket = SENSOR_HISTORY_BUCKET_SEC;
+
+static SensorHistoryRtcState s_history;
+
+static void bruteForce(const SensorHistorySeries& series, SensorHistorySummary& out) {
+    int16_t points[SENSOR_HISTORY_BUCKETS + 1];
+    int count = sensorHistoryPoints(s_history, series, points, SENSOR_HISTORY_BUCKETS + 1);
+    out = SensorHistorySummary();
+    double n = 0, sx = 0, sy = 0, sxy = 0, sxx = 0;
+    int lo = 1 << 20, hi = -(1 << 20);
+    for (int i = 0; i < count; i++) {
+        if (points[i] == SENSOR_HISTORY_MISSING) continue;
+        n++;
+        sx += i;
+        sy += points[i];
+        sxy += (double)i * points[i];
+        sxx += (double)i * i;
+        lo = points[i] < lo ? points[i] : lo;
+        hi = points[i] > hi ? points[i] : hi;
+    }
+    out.buckets = (uint16_t)n;
+    if (n == 0) return;
+    out.min = lo / 100.0f;
+    out.max = hi / 100.0f;
+    out.mean = (float)(sy / n / 100.0);
+    double denom = n * sxx - sx * sx;
+    if (n >= 2 && denom > 0) {
+        out.slopePerHour = (float)((n * sxy - sx * sy) / denom * 3600.0 / kBucket / 100.0);
+        out.hasSlope = true;
+    }
+}
+
+static void assertMatchesBruteForce(const SensorHistorySeries& series) {
+    SensorHistorySummary fast, slow;
+    bool any = sensorHistorySummary(series, fast);
+    bruteForce(series, slow);
+    TEST_ASSERT_EQUAL(slow.buckets > 0, any);
+    TEST_ASSERT_EQUAL_UINT16(slow.buckets, fast.buckets);
+    if (!any) return;
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, slow.min, fast.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, slow.max, fast.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, slow.mean, fast.mean);
+    TEST_ASSERT_EQUAL(slow.hasSlope, fast.hasSlope);
+    TEST_ASSERT_FLOAT_WITHIN(0.0005f, slow.slopePerHour, fast.slopePerHour);
+}
+
+void setUp() {
+    s_history = SensorHistoryRtcState();
+}
+
+void tearDown() {}
+
+void test_empty_history_has_no_summary() {
+    SensorHistorySummary summary;
+    TEST_ASSERT_FALSE(sensorHistorySummary(s_history.temp, summary));
+}
+
+void test_readings_in_one_bucket_are_averaged() {
+    sensorHistoryAdd(s_history, kT0, 20.0f, 40.0f);
+    sensorHistoryAdd(s_history, kT0 + 60, 21.0f, 42.0f);
+    SensorHistorySummary summary;
+    TEST_ASSERT_TRUE(sensorHistorySummary(s_history.temp, summary));
+    TEST_ASSERT_EQUAL_UINT16(1, summary.buckets);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.5f, summary.mean);
+    TEST_ASSERT_FALSE(summary.hasSlope);
+    TEST_ASSERT_TRUE(sensorHistorySummary(s_history.humidity, summary));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 41.0f, summary.mean);
+}
+
+void test_linear_rise_gives_its_slope() {
+    // +0.5 C per bucket = +1 C per hour with 30 min buckets
+    for (int i = 0; i < 10; i++) {
+        sensorHistoryAdd(s_history, kT0 + i * kBucket, 20.0f + 0.5f * i, 50.0f);
+    }
+    SensorHistorySummary summary;
+    TEST_ASSERT_TRUE(sensorHistorySummary(s_history.temp, summary));
+    TEST_ASSERT_TRUE(summary.hasSlope);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.5f * 3600.0f / kBucket, summary.slopePerHour);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.0f, summary.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 24.5f, summary.max);
+}
+
+void test_old_extremes_slide_out_of_the_window() {
+    sensorHistoryAdd(s_history, kT0, 35.0f, 90.0f);
+    for (int i = 1; i <= SENSOR_HISTORY_BUCKETS + 1; i++) {
+        sensorHistoryAdd(s_history, kT0 + i * kBucket, 20.0f, 50.0f);
+    }
+    SensorHistorySummary summary;
+    sensorHistorySummary(s_history.temp, summary);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.0f, summary.max);
+    assertMatchesBruteForce(s_history.temp);
+}
+
+void test_long_sleep_empties_the_window() {
+    sensorHistoryAdd(s_history, kT0, 20.0f, 50.0f);
+    sensorHistoryAdd(s_history, kT0 + 1000 * kBucket, 25.0f, 55.0f);
+    SensorHistorySummary summary;
+    sensorHistorySummary(s_history.temp, summary);
+    TEST_ASSERT_EQUAL_UINT16(1, summary.buckets);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 25.0f, summary.min);
+}
+
+void test_clock_going_back_clears_history() {
+    sensorHistoryAdd(s_history, kT0 + 10 * kBucket, 20.0f, 50.0f);
+    sensorHistoryAdd(s_history, kT0, 30.0f, 60.0f);
+    SensorHistorySummary summary;
+    sensorHistorySummary(s_history.temp, summary);
+    TEST_ASSERT_EQUAL_UINT16(1, summary.buckets);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f, summary.mean);
+}
+
+void test_unset_clock_is_ignored() {
+    sensorHistoryAdd(s_history, 5, 20.0f, 50.0f);
+    SensorHistorySummary summary;
+    TEST_ASSERT_FALSE(sensorHistorySummary(s_history.temp, summary));
+}
+
+void test_random_walk_with_gaps_matches_brute_force() {
+    srand(7);
+    uint32_t t = kT0;
+    float temp = 21.0f;
+    float humidity = 45.0f;
+    for (int step = 0; step < 2000; step++) {
+        // Mostly one reading per few minutes, sometimes a long sleep
+        int r = rand() % 100;
+        t += r < 90 ? 60 + rand() % 600 : (r < 98 ? kBucket * (1 + rand() % 5) : kBucket * (rand() % 60));
+        temp += (rand() % 41 - 20) / 100.0f;
+        humidity += (rand() % 61 - 30) / 100.0f;
+        sensorHistoryAdd(s_history, t, temp, humidity);
+        assertMatchesBruteForce(s_history.temp);
+        assertMatchesBruteForce(s_history.humidity);
+    }
+}
+
+void test_points_are_oldest_first_with_open_bucket_last() {
+    sensorHistoryAdd(s_history, kT0, 20.0f, 50.0f);
+    sensorHistoryAdd(s_history, kT0 + 2 * kBucket, 22.0f, 50.0f);
+    int16_t points[SENSOR_HISTORY_BUCKETS + 1];
+    int count = sensorHistoryPoints(s_history, s_history.temp, points, SENSOR_HISTORY_BUCKETS + 1);
+    TEST_ASSERT_EQUAL(SENSOR_HISTORY_BUCKETS + 1, count);
+    TEST_ASSERT_EQUAL_INT16(2200, points[count - 1]);
+    TEST_ASSERT_EQUAL_INT16(SENSOR_HISTORY_MISSING, points[count - 2]);
+    TEST_ASSERT_EQUAL_INT16(2000, points[count - 3]);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_history_has_no_summary);
+    RUN_TEST(test_readings_in_one_bucket_are_averaged);
+    RUN_TEST(test_linear_rise_gives_its_slope);
+    RUN_TEST(test_old_extremes_slide_out_of_the_window);
+    RUN_TEST(test_long_sleep_empties_the_window);
+    RUN_TEST(test_clock_going_back_clears_history);
+    RUN_TEST(test_unset_clock_is_ignored);
+    RUN_TEST(test_random_walk_with_gaps_matches_brute_force);
+    RUN_TEST(test_points_are_oldest_first_with_open_bucket_last);
+    return UNITY_END();
+}
@@ -0,0 +1,122 @@
+// Host-side tests for the sensor app's repaint policy: pio test -e native
+#include <unity.h>
+#include "../../firmware/apps/sensor/repaint_policy.h"
+
+static SensorRepaintPolicy s_policy;
+static SensorShownFrame s_shown;
+
+static SensorFrame frameAt(uint32_t now, float tempC = 21.0f, float humidity = 45.0f, int battery = 80) {
+    SensorFrame frame;
+    frame.readOk = true;
+    frame.wifiShown = true;
+    frame.batteryPercent = battery;
+    frame.tempC = tempC;
+    frame.humidity = humidity;
+    frame.now = now;
+    frame.layoutHash = sensorLayoutHash("F");
+    return frame;
+}
+
+static void assertDecision(SensorRepaint expected, const SensorFrame& frame) {
+    TEST_ASSERT_EQUAL_STRING(sensorRepaintName(expected),
+                             sensorRepaintName(sensorRepaintDecision(s_policy, s_shown, frame)));
+}
+
+void setUp() {
+    s_policy = SensorRepaintPolicy();
+    s_shown = SensorShownFrame();
+    sensorRepaintRecord(s_shown, frameAt(1000));
+}
+
+void tearDown() {}
+
+void test_unknown_panel_is_painted() {
+    SensorShownFrame unknown;
+    TEST_ASSERT_EQUAL_STRING("first paint",
+                             sensorRepaintName(sensorRepaintDecision(s_policy, unknown, frameAt(1000))));
+}
+
+void test_drift_inside_deadband_is_skipped() {
+    assertDecision(SensorRepaint::Skip, frameAt(1060, 21.2f, 46.5f, 75));
+    assertDecision(SensorRepaint::Skip, frameAt(1060, 20.8f, 43.1f, 85));
+}
+
+void test_value_leaving_deadband_repaints() {
+    assertDecision(SensorRepaint::Changed, frameAt(1060, 21.31f));
+    assertDecision(SensorRepaint::Changed, frameAt(1060, 21.0f, 47.0f));
+    assertDecision(SensorRepaint::Changed, frameAt(1060, 21.0f, 45.0f, 70));
+}
+
+void test_zero_deadband_repaints_every_wake() {
+    s_policy.tempDeadbandC = 0.0f;
+    assertDecision(SensorRepaint::Changed, frameAt(1060));
+}
+
+void test_min_interval_holds_back_value_changes() {
+    s_policy.minIntervalSec = 600;
+    assertDecision(SensorRepaint::Skip, frameAt(1300, 25.0f));
+    assertDecision(SensorRepaint::Changed, frameAt(1600, 25.0f));
+}
+
+void test_max_interval_forces_a_repaint() {
+    assertDecision(SensorRepaint::Skip, frameAt(1000 + 3599));
+    assertDecision(SensorRepaint::MaxAge, frameAt(1000 + 3600));
+    s_policy.maxIntervalSec = 0;
+    assertDecision(SensorRepaint::Skip, frameAt(1000 + 86400));
+}
+
+void test_clock_going_backwards_repaints() {
+    assertDecision(SensorRepaint::MaxAge, frameAt(500));
+}
+
+void test_status_and_layout_changes_bypass_min_interval() {
+    s_policy.minIntervalSec = 3600;
+    SensorFrame frame = frameAt(1060);
+    frame.wifiShown = false;
+    assertDecision(SensorRepaint::Status, frame);
+
+    frame = frameAt(1060);
+    frame.readOk = false;
+    assertDecision(SensorRepaint::Status, frame);
+
+    frame = frameAt(1060);
+    frame.layoutHash = sensorLayoutHash("C");
+    assertDecision(SensorRepaint::Layout, frame);
+}
+
+void test_failed_read_stays_on_error_screen() {
+    SensorFrame failed = frameAt(1060, 0.0f, 0.0f);
+    failed.readOk = false;
+    sensorRepaintRecord(s_shown, failed);
+    failed.now = 1120;
+    assertDecision(SensorRepaint::Skip, failed);
+}
+
+void test_repaint_moves_the_reference() {
+    sensorRepaintRecord(s_shown, frameAt(1060, 21.4f));
+    assertDecision(SensorRepaint::Skip, frameAt(1120, 21.6f));
+    assertDecision(SensorRepaint::Changed, frameAt(1120, 21.0f));
+}
+
+void test_layout_hash_chains_fields() {
+    uint32_t a = sensorLayoutHash("c", sensorLayoutHash("ab"));
+    uint32_t b = sensorLayoutHash("bc", sensorLayoutHash("a"));
+    TEST_ASSERT_TRUE(a != b);
+    TEST_ASSERT_EQUAL_UINT32(sensorLayoutHash("F"), sensorLayoutHash("F"));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unknown_panel_is_painted);
+    RUN_TEST(test_drift_inside_deadband_is_skipped);
+    RUN_TEST(test_value_leaving_deadband_repaints);
+    RUN_TEST(test_zero_deadband_repaints_every_wake);
+    RUN_TEST(test_min_interval_holds_back_value_changes);
+    RUN_TEST(test_max_interval_forces_a_repaint);
+    RUN_TEST(test_clock_going_backwards_repaints);
+    RUN_TEST(test_status_and_layout_changes_bypass_min_interval);
+    RUN_TEST(test_failed_read_stays_on_error_screen);
+    RUN_TEST(test_repaint_moves_the_reference);
+    RUN_TEST(test_layout_hash_chains_fields);
+    return UNITY_END();
+}
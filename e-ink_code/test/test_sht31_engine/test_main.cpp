@@ -0,0 +1,202 @@
+// Host-side tests for the SHT31 acquisition engine: pio test -e native
+// A mock device speaks the single-shot protocol (command, conversion time, 6-byte read with CRCs).
+#include <unity.h>
+#include <math.h>
+#include <vector>
+#include "../../firmware/core/sensor/sht31_engine.h"
+
+class MockSht31 : public Sht31Transport {
+public:
+    struct Reading {
+        float tempC;
+        float humidity;
+        bool corrupt;
+    };
+
+    std::vector<Reading> readings;  // served in order, the last one repeats
+    uint32_t clock = 0;
+    uint32_t conversionMs = 13;     // datasheet typical for high repeatability
+    uint32_t busMs = 1;             // cost of one transaction
+    bool present = true;
+    int writes = 0;
+    int reads = 0;
+    int nacks = 0;
+    uint32_t slept = 0;
+    uint16_t lastCommand = 0;
+
+    bool write(uint8_t addr, const uint8_t* data, size_t len) override {
+        clock += busMs;
+        if (!present || addr != SHT31_DEFAULT_ADDR || len != 2) {
+            return false;
+        }
+        writes++;
+        lastCommand = static_cast<uint16_t>((data[0] << 8) | data[1]);
+        if (lastCommand == 0x2400) {
+            _measuring = true;
+            _startedAt = clock;
+        }
+        return true;
+    }
+
+    bool read(uint8_t addr, uint8_t* data, size_t len) override {
+        clock += busMs;
+        if (!present || addr != SHT31_DEFAULT_ADDR || len != 6 || !_measuring ||
+            clock - _startedAt < conversionMs) {
+            nacks++;
+            return false;
+        }
+        reads++;
+        _measuring = false;
+        const Reading& r = readings[_next < readings.size() ? _next : readings.size() - 1];
+        _next++;
+        uint16_t rawT = static_cast<uint16_t>(lroundf((r.tempC + 45.0f) / 175.0f * 65535.0f));
+        uint16_t rawH = static_cast<uint16_t>(lroundf(r.humidity / 100.0f * 65535.0f));
+        data[0] = rawT >> 8;
+        data[1] = rawT & 0xFF;
+        data[2] = Sht31Engine::crc8(data, 2);
+        data[3] = rawH >> 8;
+        data[4] = rawH & 0xFF;
+        data[5] = Sht31Engine::crc8(data + 3, 2);
+        if (r.corrupt) {
+            data[4] ^= 0x01;
+        }
+        return true;
+    }
+
+    void sleepMs(uint32_t ms) override {
+        clock += ms;
+        slept += ms;
+    }
+
+    uint32_t nowMs() override { return clock; }
+
+private:
+    bool _measuring = false;
+    uint32_t _startedAt = 0;
+    size_t _next = 0;
+};
+
+static Sht31AcquireConfig config(uint8_t minSamples, uint8_t maxSamples, uint32_t budgetMs) {
+    Sht31AcquireConfig c;
+    c.minSamples = minSamples;
+    c.maxSamples = maxSamples;
+    c.budgetMs = budgetMs;
+    return c;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_crc_matches_datasheet_example() {
+    const uint8_t data[2] = {0xBE, 0xEF};
+    TEST_ASSERT_EQUAL_HEX8(0x92, Sht31Engine::crc8(data, 2));
+}
+
+void test_single_shot_reads_both_channels_in_one_transaction() {
+    MockSht31 mock;
+    mock.readings = {{25.0f, 50.0f, false}};
+    Sht31Engine engine(mock);
+    TEST_ASSERT_TRUE(engine.begin());
+    int writesAfterReset = mock.writes;
+
+    Sht31Sample sample;
+    TEST_ASSERT_TRUE(engine.measure(sample));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, sample.tempC);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, sample.humidity);
+    TEST_ASSERT_EQUAL(1, mock.writes - writesAfterReset);
+    TEST_ASSERT_EQUAL(1, mock.reads);
+    TEST_ASSERT_EQUAL_HEX16(0x2400, mock.lastCommand);
+    TEST_ASSERT_EQUAL(0, mock.nacks);  // slept through the conversion instead of polling
+}
+
+void test_slow_conversion_is_retried_after_nack() {
+    MockSht31 mock;
+    mock.readings = {{21.5f, 40.0f, false}};
+    mock.conversionMs = 19;
+    Sht31Engine engine(mock);
+    Sht31Sample sample;
+    TEST_ASSERT_TRUE(engine.begin());
+    TEST_ASSERT_TRUE(engine.measure(sample));
+    TEST_ASSERT_TRUE(mock.nacks > 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 21.5f, sample.tempC);
+}
+
+void test_crc_error_is_dropped_and_counted() {
+    MockSht31 mock;
+    mock.readings = {{22.0f, 45.0f, false}, {22.0f, 45.0f, true}, {22.0f, 45.0f, false}};
+    Sht31Engine engine(mock);
+    Sht31Result result;
+    TEST_ASSERT_TRUE(engine.acquire(config(3, 3, 1000), result));
+    TEST_ASSERT_EQUAL_UINT8(1, result.crcErrors);
+    TEST_ASSERT_EQUAL_UINT8(3, result.taken);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 22.0f, result.tempC);
+}
+
+void test_outlier_is_rejected_from_the_mean() {
+    MockSht31 mock;
+    mock.readings = {{25.0f, 50.0f, false}, {25.1f, 50.2f, false}, {24.9f, 49.8f, false},
+                     {40.0f, 50.0f, false}, {25.0f, 50.0f, false}};
+    Sht31Engine engine(mock);
+    Sht31Result result;
+    TEST_ASSERT_TRUE(engine.acquire(config(5, 5, 1000), result));
+    TEST_ASSERT_EQUAL_UINT8(5, result.taken);
+    TEST_ASSERT_EQUAL_UINT8(1, result.rejected);
+    TEST_ASSERT_EQUAL_UINT8(4, result.used);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 25.0f, result.tempC);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 50.0f, result.humidity);
+}
+
+void test_identical_samples_keep_small_noise() {
+    // MAD is zero here; the spread floor keeps the 0.05 C sample
+    MockSht31 mock;
+    mock.readings = {{20.0f, 50.0f, false}, {20.0f, 50.0f, false}, {20.05f, 50.0f, false},
+                     {20.0f, 50.0f, false}};
+    Sht31Engine engine(mock);
+    Sht31Result result;
+    TEST_ASSERT_TRUE(engine.acquire(config(4, 4, 1000), result));
+    TEST_ASSERT_EQUAL_UINT8(0, result.rejected);
+}
+
+void test_budget_limits_oversampling() {
+    MockSht31 mock;
+    mock.readings = {{23.0f, 55.0f, false}};
+    Sht31Engine engine(mock);
+    Sht31Result result;
+    TEST_ASSERT_TRUE(engine.acquire(config(2, 10, 60), result));
+    TEST_ASSERT_TRUE(result.taken >= 2);
+    TEST_ASSERT_TRUE(result.taken < 10);
+    TEST_ASSERT_TRUE(result.elapsedMs <= 60);
+}
+
+void test_min_samples_are_taken_past_the_budget() {
+    MockSht31 mock;
+    mock.readings = {{23.0f, 55.0f, false}};
+    Sht31Engine engine(mock);
+    Sht31Result result;
+    TEST_ASSERT_TRUE(engine.acquire(config(3, 5, 10), result));
+    TEST_ASSERT_EQUAL_UINT8(3, result.taken);
+}
+
+void test_missing_sensor_fails_fast() {
+    MockSht31 mock;
+    mock.present = false;
+    Sht31Engine engine(mock);
+    Sht31Result result;
+    TEST_ASSERT_FALSE(engine.acquire(config(3, 5, 1000), result));
+    TEST_ASSERT_EQUAL_UINT8(0, result.taken);
+    TEST_ASSERT_TRUE(result.elapsedMs < 5);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_matches_datasheet_example);
+    RUN_TEST(test_single_shot_reads_both_channels_in_one_transaction);
+    RUN_TEST(test_slow_conversion_is_retried_after_nack);
+    RUN_TEST(test_crc_error_is_dropped_and_counted);
+    RUN_TEST(test_outlier_is_rejected_from_the_mean);
+    RUN_TEST(test_identical_samples_keep_small_noise);
+    RUN_TEST(test_budget_limits_oversampling);
+    RUN_TEST(test_min_samples_are_taken_past_the_budget);
+    RUN_TEST(test_missing_sensor_fails_fast);
+    return UNITY_END();
+}